@@ -0,0 +1,145 @@
+#include "alloc_counter.hpp"
+
+#include <cstdlib>
+#include <new>
+
+namespace chimera::bench {
+
+#if defined(CHIMERA_ALLOC_HOOK)
+
+namespace {
+
+// Constant-initialized, so touching it from operator new needs no TLS guard
+constinit thread_local AllocationStats counters;
+
+void* counted_alloc(std::size_t size) {
+    if (size == 0) {
+        size = 1;
+    }
+    void* ptr = std::malloc(size);
+    if (ptr) {
+        ++counters.allocations;
+        counters.bytes += size;
+    }
+    return ptr;
+}
+
+void* counted_alloc_aligned(std::size_t size, std::align_val_t alignment) {
+    const auto align = static_cast<std::size_t>(alignment);
+    size = (size + align - 1) / align * align;   // aligned_alloc needs a multiple of the alignment
+    if (size == 0) {
+        size = align;
+    }
+#if defined(_WIN32)
+    void* ptr = _aligned_malloc(size, align);
+#else
+    void* ptr = std::aligned_alloc(align, size);
+#endif
+    if (ptr) {
+        ++counters.allocations;
+        counters.bytes += size;
+    }
+    return ptr;
+}
+
+void counted_free(void* ptr) {
+    if (ptr) {
+        ++counters.deallocations;
+        std::free(ptr);
+    }
+}
+
+void counted_free_aligned(void* ptr) {
+    if (ptr) {
+        ++counters.deallocations;
+#if defined(_WIN32)
+        _aligned_free(ptr);
+#else
+        std::free(ptr);
+#endif
+    }
+}
+
+} // namespace
+
+bool allocation_counting_available() {
+    return true;
+}
+
+AllocationStats thread_allocations() {
+    return counters;
+}
+
+#else
+
+bool allocation_counting_available() {
+    return false;
+}
+
+AllocationStats thread_allocations() {
+    return {};
+}
+
+#endif
+
+} // namespace chimera::bench
+
+#if defined(CHIMERA_ALLOC_HOOK)
+
+using chimera::bench::counted_alloc;
+using chimera::bench::counted_alloc_aligned;
+using chimera::bench::counted_free;
+using chimera::bench::counted_free_aligned;
+
+void* operator new(std::size_t size) {
+    if (void* ptr = counted_alloc(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return counted_alloc(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return counted_alloc(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    if (void* ptr = counted_alloc_aligned(size, alignment)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return operator new(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return counted_alloc_aligned(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return counted_alloc_aligned(size, alignment);
+}
+
+void operator delete(void* ptr) noexcept { counted_free(ptr); }
+void operator delete[](void* ptr) noexcept { counted_free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { counted_free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { counted_free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { counted_free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { counted_free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { counted_free_aligned(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { counted_free_aligned(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { counted_free_aligned(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { counted_free_aligned(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { counted_free_aligned(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { counted_free_aligned(ptr); }
+
+#endif
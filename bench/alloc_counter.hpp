@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+
+// Allocation accounting for chimera_test and chimera_bench. alloc_counter.cpp
+// replaces the global operator new/delete of the binary it is linked into
+// (CMake: -DCHIMERA_ALLOC_HOOK=ON, the default) and counts per thread, so
+// allocations by the logger, worker pools or other threads do not leak into
+// the operation being measured.
+//
+//   chimera::bench::AllocationScope scope;
+//   DnsPacketBuilder::build_query_into(packet, question);
+//   assert(scope.delta().allocations == 0);
+//
+// Without the hook allocation_counting_available() is false and every delta
+// is zero; callers skip their budgets in that case.
+namespace chimera::bench {
+
+struct AllocationStats {
+    uint64_t allocations = 0;
+    uint64_t deallocations = 0;
+    uint64_t bytes = 0;             // Requested from operator new
+};
+
+bool allocation_counting_available();
+
+// Running totals of the calling thread
+AllocationStats thread_allocations();
+
+class AllocationScope {
+    AllocationStats start_ = thread_allocations();
+
+public:
+    AllocationStats delta() const {
+        const AllocationStats now = thread_allocations();
+        return {now.allocations - start_.allocations, now.deallocations - start_.deallocations,
+                now.bytes - start_.bytes};
+    }
+};
+
+} // namespace chimera::bench
@@ -0,0 +1,410 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "alloc_counter.hpp"
+#include "perf_counters.hpp"
+#include "chimera/logging.hpp"
+
+// Self-contained micro-benchmark harness for chimera_bench.
+// Each benchmark is calibrated so one repetition runs for at least
+// min_time, then warmup repetitions are discarded and the remaining
+// repetitions are summarized as median and MAD (median absolute deviation).
+// With the allocation hook linked in, the measured repetitions also count
+// operator new calls and bytes per operation on the benchmark thread, and
+// where perf_event_open is allowed, hardware counters per operation and IPC.
+namespace chimera::bench {
+
+// Keep the compiler from optimizing away a benchmarked result
+template <typename T>
+inline void do_not_optimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+struct Options {
+    size_t warmup = 2;                                // Discarded repetitions
+    size_t repetitions = 15;                          // Measured repetitions
+    std::chrono::milliseconds min_time{20};           // Minimum duration of one repetition
+    std::string filter;                               // Substring match on benchmark names
+    std::string json_path;                            // Write results as JSON
+    std::string baseline_path;                        // Compare against a saved JSON run
+    double regression_threshold = 0.10;               // Relative slowdown that counts as a regression
+    bool list_only = false;
+    bool hardware_counters = true;                    // perf_event_open counters when available
+};
+
+struct Result {
+    std::string name;
+    size_t bytes_per_op = 0;
+    size_t iterations = 0;                            // Operations per repetition
+    std::vector<double> samples_ns;                   // ns/op per repetition
+    double median_ns = 0;
+    double mad_ns = 0;
+    double ops_per_sec = 0;
+    double bytes_per_sec = 0;
+    double allocs_per_op = -1;                        // -1 = allocation hook not linked in
+    double alloc_bytes_per_op = -1;
+    PerfSample counters;                              // Per op; -1 = event not counted
+    double ipc = -1;                                  // Instructions per cycle
+};
+
+struct Regression {
+    std::string name;
+    double baseline_ns;
+    double current_ns;
+};
+
+inline double median_of(std::vector<double> values) {
+    if (values.empty()) {
+        return 0;
+    }
+    std::sort(values.begin(), values.end());
+    const size_t mid = values.size() / 2;
+    return values.size() % 2 ? values[mid] : (values[mid - 1] + values[mid]) / 2;
+}
+
+inline double mad_of(const std::vector<double>& values, double median) {
+    std::vector<double> deviations;
+    deviations.reserve(values.size());
+    for (double v : values) {
+        deviations.push_back(std::fabs(v - median));
+    }
+    return median_of(std::move(deviations));
+}
+
+inline std::string json_escape(const std::string& text) {
+    std::string out;
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+        }
+        out += c;
+    }
+    return out;
+}
+
+// Discards output printed to std::cout/std::cerr while a benchmark runs and
+// turns the library logger off, so lines logged during the run are neither
+// formatted on the logger thread nor written out after it
+class OutputMute {
+    struct NullBuffer : std::streambuf {
+        int overflow(int c) override { return traits_type::not_eof(c); }
+        std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+    };
+
+    NullBuffer null_;
+    std::streambuf* out_ = nullptr;
+    std::streambuf* err_ = nullptr;
+    chimera::LogLevel log_level_ = chimera::Logger::level();
+
+public:
+    OutputMute() {
+        chimera::Logger::flush();   // Earlier lines still reach the real stderr
+        chimera::Logger::set_level(chimera::LogLevel::Off);
+        out_ = std::cout.rdbuf(&null_);
+        err_ = std::cerr.rdbuf(&null_);
+    }
+    ~OutputMute() {
+        chimera::Logger::set_level(log_level_);
+        std::cout.rdbuf(out_);
+        std::cerr.rdbuf(err_);
+    }
+
+    OutputMute(const OutputMute&) = delete;
+    OutputMute& operator=(const OutputMute&) = delete;
+};
+
+class Harness {
+    struct Benchmark {
+        std::string name;
+        size_t bytes_per_op;
+        std::function<void()> op;
+    };
+
+    Options options_;
+    std::vector<Benchmark> benchmarks_;
+    std::vector<Result> results_;
+    std::unique_ptr<PerfCounters> counters_;          // Null when disabled or nothing could be opened
+
+public:
+    explicit Harness(Options options) : options_(std::move(options)) {
+        if (options_.hardware_counters && !options_.list_only) {
+            counters_ = std::make_unique<PerfCounters>();
+            if (!counters_->available()) {
+                std::cerr << "Hardware counters unavailable: " << counters_->error() << std::endl;
+                counters_.reset();
+            }
+        }
+    }
+
+    bool hardware_counters() const { return counters_ != nullptr; }
+
+    // bytes_per_op = 0 for benchmarks without a meaningful byte throughput
+    void add(const std::string& name, size_t bytes_per_op, std::function<void()> op) {
+        benchmarks_.push_back({name, bytes_per_op, std::move(op)});
+    }
+
+    const std::vector<Result>& results() const { return results_; }
+
+    void run() {
+        if (options_.list_only) {
+            for (const auto& benchmark : benchmarks_) {
+                if (matches(benchmark.name)) {
+                    std::cout << benchmark.name << std::endl;
+                }
+            }
+            return;
+        }
+
+        print_header(hardware_counters());
+        for (const auto& benchmark : benchmarks_) {
+            if (!matches(benchmark.name)) {
+                continue;
+            }
+            {
+                OutputMute mute;
+                results_.push_back(measure(benchmark));
+            }
+            print_result(results_.back(), hardware_counters());
+        }
+    }
+
+    bool write_json(const std::string& path) const {
+        std::ofstream out(path);
+        if (!out) {
+            return false;
+        }
+
+        out << "{\n  \"format\": 1,\n  \"timestamp\": " << std::time(nullptr) << ",\n"
+            << "  \"warmup\": " << options_.warmup << ",\n"
+            << "  \"repetitions\": " << options_.repetitions << ",\n"
+            << "  \"hardware_counters\": " << (hardware_counters() ? "true" : "false") << ",\n"
+            << "  \"results\": [\n";
+        for (size_t i = 0; i < results_.size(); ++i) {
+            const auto& r = results_[i];
+            out << std::fixed << std::setprecision(3)
+                << "    {\"name\": \"" << json_escape(r.name) << "\", "
+                << "\"bytes_per_op\": " << r.bytes_per_op << ", "
+                << "\"iterations\": " << r.iterations << ", "
+                << "\"median_ns\": " << r.median_ns << ", "
+                << "\"mad_ns\": " << r.mad_ns << ", "
+                << "\"ops_per_sec\": " << r.ops_per_sec << ", "
+                << "\"bytes_per_sec\": " << r.bytes_per_sec;
+            if (r.allocs_per_op >= 0) {
+                out << ", \"allocs_per_op\": " << r.allocs_per_op
+                    << ", \"alloc_bytes_per_op\": " << r.alloc_bytes_per_op;
+            }
+            for (size_t e = 0; e < PERF_EVENT_COUNT; ++e) {
+                if (r.counters.values[e] >= 0) {
+                    out << ", \"" << perf_event_name(static_cast<PerfEvent>(e)) << "_per_op\": " << r.counters.values[e];
+                }
+            }
+            if (r.ipc >= 0) {
+                out << ", \"ipc\": " << r.ipc;
+            }
+            out << "}"
+                << (i + 1 < results_.size() ? ",\n" : "\n");
+        }
+        out << "  ]\n}\n";
+        return static_cast<bool>(out);
+    }
+
+    // Results slower than the baseline by more than the threshold (and by more
+    // than twice the measurement noise) are reported as regressions
+    std::vector<Regression> compare_baseline(const std::string& path) const {
+        std::vector<Regression> regressions;
+        const auto baseline = load_baseline(path);
+        if (baseline.empty()) {
+            std::cerr << "Baseline " << path << " has no results" << std::endl;
+            return regressions;
+        }
+
+        std::cout << "\nComparison with " << path << ":" << std::endl;
+        for (const auto& r : results_) {
+            auto it = baseline.find(r.name);
+            if (it == baseline.end() || it->second <= 0) {
+                continue;
+            }
+            const double change = (r.median_ns - it->second) / it->second;
+            const bool regressed = change > options_.regression_threshold &&
+                                   r.median_ns - it->second > 2 * r.mad_ns;
+            std::cout << "  " << std::left << std::setw(44) << r.name << std::right
+                      << std::showpos << std::fixed << std::setprecision(1) << change * 100 << "%"
+                      << std::noshowpos << (regressed ? "  REGRESSION" : "") << std::endl;
+            if (regressed) {
+                regressions.push_back({r.name, it->second, r.median_ns});
+            }
+        }
+        return regressions;
+    }
+
+private:
+    bool matches(const std::string& name) const {
+        return options_.filter.empty() || name.find(options_.filter) != std::string::npos;
+    }
+
+    Result measure(const Benchmark& benchmark) const {
+        using Clock = std::chrono::steady_clock;
+
+        // Calibrate: double the batch until one repetition reaches min_time
+        size_t iterations = 1;
+        while (true) {
+            const auto start = Clock::now();
+            for (size_t i = 0; i < iterations; ++i) {
+                benchmark.op();
+            }
+            if (Clock::now() - start >= options_.min_time || iterations >= (size_t{1} << 30)) {
+                break;
+            }
+            iterations *= 2;
+        }
+
+        Result result;
+        result.name = benchmark.name;
+        result.bytes_per_op = benchmark.bytes_per_op;
+        result.iterations = iterations;
+
+        AllocationStats allocations;
+        if (counters_) {
+            counters_->reset();
+        }
+        for (size_t rep = 0; rep < options_.warmup + options_.repetitions; ++rep) {
+            const bool measured = rep >= options_.warmup;
+            const AllocationScope scope;
+            if (counters_ && measured) {
+                counters_->start();
+            }
+            const auto start = Clock::now();
+            for (size_t i = 0; i < iterations; ++i) {
+                benchmark.op();
+            }
+            const auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+            if (counters_ && measured) {
+                counters_->stop();
+            }
+            if (measured) {
+                result.samples_ns.push_back(elapsed / static_cast<double>(iterations));
+                const AllocationStats delta = scope.delta();
+                allocations.allocations += delta.allocations;
+                allocations.bytes += delta.bytes;
+            }
+        }
+        const double ops = static_cast<double>(iterations * options_.repetitions);
+        if (allocation_counting_available()) {
+            result.allocs_per_op = allocations.allocations / ops;
+            result.alloc_bytes_per_op = allocations.bytes / ops;
+        }
+        if (counters_) {
+            result.counters = counters_->per_op(ops);
+            const double cycles = result.counters[PerfEvent::Cycles];
+            const double instructions = result.counters[PerfEvent::Instructions];
+            if (cycles > 0 && instructions >= 0) {
+                result.ipc = instructions / cycles;
+            }
+        }
+
+        result.median_ns = median_of(result.samples_ns);
+        result.mad_ns = mad_of(result.samples_ns, result.median_ns);
+        result.ops_per_sec = result.median_ns > 0 ? 1e9 / result.median_ns : 0;
+        result.bytes_per_sec = result.ops_per_sec * static_cast<double>(result.bytes_per_op);
+        return result;
+    }
+
+    static void print_header(bool counters) {
+        std::cout << std::left << std::setw(44) << "benchmark" << std::right
+                  << std::setw(14) << "median" << std::setw(12) << "mad"
+                  << std::setw(14) << "ops/s" << std::setw(14) << "MB/s"
+                  << std::setw(12) << "allocs/op" << std::setw(14) << "B alloc/op";
+        if (counters) {
+            std::cout << std::setw(12) << "cycles/op" << std::setw(7) << "IPC" << std::setw(11) << "L1d miss"
+                      << std::setw(11) << "LLC miss" << std::setw(11) << "br miss";
+        }
+        std::cout << std::endl;
+    }
+
+    static void print_result(const Result& r, bool counters) {
+        std::cout << std::left << std::setw(44) << r.name << std::right << std::fixed
+                  << std::setw(11) << std::setprecision(1) << r.median_ns << " ns"
+                  << std::setw(9) << std::setprecision(1) << r.mad_ns << " ns"
+                  << std::setw(14) << std::setprecision(0) << r.ops_per_sec;
+        if (r.bytes_per_op > 0) {
+            std::cout << std::setw(14) << std::setprecision(1) << r.bytes_per_sec / (1024.0 * 1024.0);
+        } else {
+            std::cout << std::setw(14) << "-";
+        }
+        if (r.allocs_per_op >= 0) {
+            std::cout << std::setw(12) << std::setprecision(1) << r.allocs_per_op
+                      << std::setw(14) << std::setprecision(0) << r.alloc_bytes_per_op;
+        } else {
+            std::cout << std::setw(12) << "-" << std::setw(14) << "-";
+        }
+        if (counters) {
+            const auto column = [&r](PerfEvent event, int width) {
+                if (r.counters[event] >= 0) {
+                    std::cout << std::setw(width) << std::setprecision(event == PerfEvent::Cycles ? 0 : 2)
+                              << r.counters[event];
+                } else {
+                    std::cout << std::setw(width) << "-";
+                }
+            };
+            column(PerfEvent::Cycles, 12);
+            if (r.ipc >= 0) {
+                std::cout << std::setw(7) << std::setprecision(2) << r.ipc;
+            } else {
+                std::cout << std::setw(7) << "-";
+            }
+            column(PerfEvent::L1dMisses, 11);
+            column(PerfEvent::LlcMisses, 11);
+            column(PerfEvent::BranchMisses, 11);
+        }
+        std::cout << std::endl;
+    }
+
+    // Reads name -> median_ns from a file produced by write_json
+    static std::map<std::string, double> load_baseline(const std::string& path) {
+        std::map<std::string, double> baseline;
+        std::ifstream in(path);
+        if (!in) {
+            return baseline;
+        }
+        std::stringstream buffer;
+        buffer << in.rdbuf();
+        const std::string text = buffer.str();
+
+        const std::string name_key = "\"name\": \"";
+        const std::string median_key = "\"median_ns\": ";
+        size_t pos = 0;
+        while ((pos = text.find(name_key, pos)) != std::string::npos) {
+            pos += name_key.size();
+            const size_t name_end = text.find('"', pos);
+            const size_t object_end = text.find('}', pos);
+            const size_t median_pos = text.find(median_key, pos);
+            if (name_end == std::string::npos || median_pos == std::string::npos || median_pos > object_end) {
+                continue;
+            }
+            baseline[text.substr(pos, name_end - pos)] = std::strtod(text.c_str() + median_pos + median_key.size(), nullptr);
+        }
+        return baseline;
+    }
+};
+
+} // namespace chimera::bench
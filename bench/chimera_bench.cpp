@@ -0,0 +1,358 @@
+#include "bench_harness.hpp"
+#include "chimera/AsyncIO.hpp"
+#include "chimera/base64.hpp"
+#include "chimera/client.hpp"
+#include "chimera/crypto.hpp"
+#include "chimera/dns_packet.hpp"
+#include "chimera/steganography.hpp"
+#include "chimera/transport_loopback.hpp"
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace chimera;
+using namespace chimera::bench;
+
+namespace {
+
+const size_t PAYLOAD_SIZES[] = {64, 1024, 16384};
+
+std::vector<uint8_t> random_bytes(size_t size, uint32_t seed = 42) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> dist(0, 255);
+    std::vector<uint8_t> data(size);
+    for (auto& byte : data) {
+        byte = static_cast<uint8_t>(dist(gen));
+    }
+    return data;
+}
+
+// Compressible text-like payload, closer to real tunnel traffic than random bytes
+std::vector<uint8_t> text_bytes(size_t size) {
+    static const std::string words = "chimera dns tunnel payload fragment record query response ";
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; ++i) {
+        data[i] = static_cast<uint8_t>(words[(i * 7 + i / words.size()) % words.size()]);
+    }
+    return data;
+}
+
+std::string sized_name(const std::string& prefix, size_t size) {
+    return prefix + "/" + std::to_string(size);
+}
+
+// Single-answer TXT response to `query`, as a resolver would return it
+std::vector<uint8_t> make_txt_response(const std::vector<uint8_t>& query, const std::string& text) {
+    DnsHeader header{};
+    const DnsQuestion question = DnsPacketBuilder::parse_query(query, header);
+    const DnsResourceRecord answer{question.name, DnsType::TXT, DnsClass::IN, 300,
+                                   DnsPacketBuilder::build_txt_rdata(text)};
+    return DnsPacketBuilder::build_response(header, question, {answer});
+}
+
+void add_codec_benchmarks(Harness& harness) {
+    for (size_t size : PAYLOAD_SIZES) {
+        const auto data = random_bytes(size);
+        const std::string raw(data.begin(), data.end());
+        const std::string encoded = Base64::encode(raw);
+
+        harness.add(sized_name("base64/encode", size), size, [raw]() {
+            do_not_optimize(Base64::encode(raw));
+        });
+        harness.add(sized_name("base64/decode", size), size, [encoded]() {
+            do_not_optimize(Base64::decode(encoded));
+        });
+    }
+
+    SteganographicEncoder encoder;
+    for (size_t size : PAYLOAD_SIZES) {
+        const auto data = random_bytes(size);
+        harness.add(sized_name("crc32", size), size, [encoder, data]() {
+            do_not_optimize(encoder.calculate_checksum(data));
+        });
+    }
+
+    for (size_t size : PAYLOAD_SIZES) {
+        const auto data = text_bytes(size);
+        const auto compressed = encoder.compress_payload(data);
+        harness.add(sized_name("zlib/compress", size), size, [encoder, data]() {
+            do_not_optimize(encoder.compress_payload(data));
+        });
+        harness.add(sized_name("zlib/decompress", size), size, [encoder, compressed]() {
+            do_not_optimize(encoder.decompress_payload(compressed));
+        });
+    }
+}
+
+void add_steganography_benchmarks(Harness& harness) {
+    const std::pair<EncodingStrategy, const char*> strategies[] = {
+        {EncodingStrategy::TXT_ONLY, "txt_only"},
+        {EncodingStrategy::MULTI_RECORD, "multi_record"},
+        {EncodingStrategy::DISTRIBUTED, "distributed"},
+    };
+
+    // Deterministic fragment layout so runs are comparable
+    EncodingConfig config;
+    config.randomize_order = false;
+    config.noise_ratio = 0.0;
+    config.max_fragments = 64;
+
+    for (const auto& [strategy, label] : strategies) {
+        config.strategy = strategy;
+        const SteganographicEncoder encoder(config);
+
+        for (size_t size : {size_t{64}, size_t{1024}}) {
+            const auto data = text_bytes(size);
+            auto fragments = encoder.encode_payload(data, "bench.example.com");
+            if (!fragments) {
+                std::cerr << "Skipping " << label << "/" << size << ": payload does not fit" << std::endl;
+                continue;
+            }
+
+            const std::string prefix = std::string("stego/") + label;
+            harness.add(sized_name(prefix + "/encode", size), size, [encoder, data]() {
+                do_not_optimize(encoder.encode_payload(data, "bench.example.com"));
+            });
+            harness.add(sized_name(prefix + "/decode", size), size, [encoder, fragments = fragments.value()]() {
+                do_not_optimize(encoder.decode_fragments(fragments));
+            });
+        }
+    }
+
+    config.strategy = EncodingStrategy::HTTP2_BODY;
+    const SteganographicEncoder http2_encoder(config);
+    for (size_t size : PAYLOAD_SIZES) {
+        const auto data = text_bytes(size);
+        harness.add(sized_name("stego/http2_body/encode", size), size, [http2_encoder, data]() {
+            do_not_optimize(http2_encoder.encode_http2_body(data));
+        });
+    }
+}
+
+void add_dns_benchmarks(Harness& harness) {
+    const DnsQuestion question{.name = "a1b2c3.bench.example.com", .type = DnsType::TXT};
+    harness.add("dns/build_query", 0, [question]() {
+        do_not_optimize(DnsPacketBuilder::build_query(question));
+    });
+    harness.add("dns/build_query_into", 0, [question, packet = std::vector<uint8_t>()]() mutable {
+        DnsPacketBuilder::build_query_into(packet, question);
+        do_not_optimize(packet);
+    });
+
+    const auto query = DnsPacketBuilder::build_query(question);
+    for (size_t size : {size_t{64}, size_t{255}, size_t{1024}}) {
+        const auto response = make_txt_response(query, std::string(size, 'x'));
+        std::vector<DnsResourceRecord> check;
+        DnsPacketBuilder::parse_response(response, check);
+        if (check.size() != 1) {
+            std::cerr << "Skipping dns/parse_response/" << size << ": response did not parse" << std::endl;
+            continue;
+        }
+        harness.add(sized_name("dns/parse_response", size), response.size(), [response]() {
+            std::vector<DnsResourceRecord> answers;
+            do_not_optimize(DnsPacketBuilder::parse_response(response, answers));
+            do_not_optimize(answers);
+        });
+    }
+}
+
+// Client paths over the in-process loopback: encoder, fragment loop and async
+// engine cost without kernel networking
+void add_pipeline_benchmarks(Harness& harness) {
+    const DnsQuestion question{.name = "a1b2c3.bench.example.com", .type = DnsType::TXT};
+    const auto query = DnsPacketBuilder::build_query(question);
+    const std::pair<LoopbackMode, const char*> modes[] = {
+        {LoopbackMode::Ring, "ring"},
+        {LoopbackMode::SocketPair, "socketpair"},
+    };
+    for (const auto& [mode, label] : modes) {
+        std::shared_ptr<ITransport> transport = LoopbackServer::create({}, mode)->connect();
+        harness.add(std::string("loopback/") + label + "/roundtrip", query.size(), [transport, query]() {
+            transport->send(query);
+            do_not_optimize(transport->receive());
+        });
+    }
+
+    ClientConfig config;
+    config.transport_factory = LoopbackServer::create()->factory();
+    config.fragment_delay = std::chrono::milliseconds(0);
+    config.randomize_fragments = false;
+    config.noise_ratio = 0.0;
+    config.max_fragments = 64;
+
+    const std::pair<EncodingStrategy, const char*> strategies[] = {
+        {EncodingStrategy::TXT_ONLY, "txt_only"},
+        {EncodingStrategy::MULTI_RECORD, "multi_record"},
+        {EncodingStrategy::DISTRIBUTED, "distributed"},
+    };
+    for (const auto& [strategy, label] : strategies) {
+        config.encoding_strategy = strategy;
+        const ChimeraClient client(config);
+        const auto data = text_bytes(1024);
+        const bool fits = [&]() {
+            OutputMute mute;
+            return client.send_data(data).has_value();
+        }();
+        if (!fits) {
+            std::cerr << "Skipping client/send_data/" << label << ": payload does not fit" << std::endl;
+            continue;
+        }
+        harness.add(sized_name(std::string("client/send_data/") + label, data.size()), data.size(), [client, data]() {
+            do_not_optimize(client.send_data(data));
+        });
+    }
+
+    config.use_random_subdomains = false;
+    auto async_client = std::make_shared<AsyncChimeraClient>(config);
+    async_client->start();
+    const std::string message(64, 'x');
+    harness.add("async/send_text_future/64", message.size(), [async_client, message]() {
+        do_not_optimize(async_client->send_text_future(message).get());
+    });
+}
+
+void add_crypto_benchmarks(Harness& harness) {
+    auto key = AEAD::generate_key();
+    if (!key) {
+        std::cerr << "Skipping crypto benchmarks: key generation failed" << std::endl;
+        return;
+    }
+
+    for (CipherSuite suite : CipherSuites::supported()) {
+        const std::string prefix = std::string("aead/") + CipherSuites::name(suite);
+        for (size_t size : PAYLOAD_SIZES) {
+            const auto message = random_bytes(size);
+            const auto packet = AEAD::encrypt(message, key.value(), {}, suite);
+            if (!packet) {
+                continue;
+            }
+            harness.add(sized_name(prefix + "/encrypt", size), size, [message, k = key.value(), suite]() {
+                do_not_optimize(AEAD::encrypt(message, k, {}, suite));
+            });
+            harness.add(sized_name(prefix + "/decrypt", size), size, [p = packet.value(), k = key.value(), suite]() {
+                do_not_optimize(AEAD::decrypt(p, k, {}, suite));
+            });
+
+            // Session path: no nonce generation, no allocation
+            auto session = std::make_shared<AEADSession>(key.value(), SessionRole::Initiator, suite);
+            auto buffer = std::make_shared<std::vector<uint8_t>>(size + AEADSession::TAG_BYTES);
+            harness.add(sized_name(prefix + "/seal_in_place", size), size, [session, buffer, size]() {
+                do_not_optimize(session->seal_in_place(buffer->data(), size, buffer->size(), 1));
+            });
+        }
+    }
+
+    for (const auto& params : HybridKeyExchange::available_kems()) {
+        const KemAlgorithm kem = params.algorithm;
+        auto keypair = HybridKeyExchange::generate_keypair(kem);
+        if (!keypair) {
+            continue;
+        }
+        auto exchange = HybridKeyExchange::initiate_exchange(keypair->x25519_public, keypair->mlkem_public, kem);
+        if (!exchange) {
+            continue;
+        }
+
+        const std::string prefix = "kem/" + params.name;
+        harness.add(prefix + "/keygen", 0, [kem]() {
+            do_not_optimize(HybridKeyExchange::generate_keypair(kem));
+        });
+        harness.add(prefix + "/encaps", 0, [x = keypair->x25519_public, m = keypair->mlkem_public, kem]() {
+            do_not_optimize(HybridKeyExchange::initiate_exchange(x, m, kem));
+        });
+        auto server = std::make_shared<HybridKeyPair>(std::move(keypair.value()));
+        harness.add(prefix + "/decaps", 0, [server, e = std::move(exchange.value())]() {
+            do_not_optimize(HybridKeyExchange::respond_to_exchange(*server, e.client_x25519_public, e.mlkem_ciphertext));
+        });
+    }
+}
+
+void print_usage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "Options:\n"
+              << "  --filter <text>        Run benchmarks whose name contains <text>\n"
+              << "  --list                 List benchmark names and exit\n"
+              << "  --json <file>          Write results as JSON\n"
+              << "  --baseline <file>      Compare against a saved JSON run (exit 2 on regression)\n"
+              << "  --threshold <ratio>    Relative slowdown counted as a regression (default 0.10)\n"
+              << "  --repetitions <n>      Measured repetitions per benchmark (default 15)\n"
+              << "  --warmup <n>           Discarded repetitions per benchmark (default 2)\n"
+              << "  --min-time-ms <ms>     Minimum duration of one repetition (default 20)\n"
+              << "  --quick                Short run for smoke testing\n"
+              << "  --no-counters          Skip hardware performance counters (perf_event_open)\n"
+              << "  --help, -h             Show this help\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+
+        if (arg == "--help" || arg == "-h") {
+            print_usage(argv[0]);
+            return 0;
+        } else if (arg == "--list") {
+            options.list_only = true;
+        } else if (arg == "--quick") {
+            options.warmup = 1;
+            options.repetitions = 5;
+            options.min_time = std::chrono::milliseconds(5);
+        } else if (arg == "--no-counters") {
+            options.hardware_counters = false;
+        } else if (arg == "--filter" && has_value) {
+            options.filter = argv[++i];
+        } else if (arg == "--json" && has_value) {
+            options.json_path = argv[++i];
+        } else if (arg == "--baseline" && has_value) {
+            options.baseline_path = argv[++i];
+        } else if (arg == "--threshold" && has_value) {
+            options.regression_threshold = std::strtod(argv[++i], nullptr);
+        } else if (arg == "--repetitions" && has_value) {
+            options.repetitions = std::max<size_t>(1, std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--warmup" && has_value) {
+            options.warmup = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--min-time-ms" && has_value) {
+            options.min_time = std::chrono::milliseconds(std::strtoul(argv[++i], nullptr, 10));
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    Harness harness(options);
+    add_codec_benchmarks(harness);
+    add_steganography_benchmarks(harness);
+    add_dns_benchmarks(harness);
+    add_pipeline_benchmarks(harness);
+    add_crypto_benchmarks(harness);
+    harness.run();
+
+    if (options.list_only) {
+        return 0;
+    }
+
+    if (!options.json_path.empty()) {
+        if (!harness.write_json(options.json_path)) {
+            std::cerr << "Failed to write " << options.json_path << std::endl;
+            return 1;
+        }
+        std::cout << "\nResults written to " << options.json_path << std::endl;
+    }
+
+    if (!options.baseline_path.empty()) {
+        const auto regressions = harness.compare_baseline(options.baseline_path);
+        if (!regressions.empty()) {
+            std::cout << regressions.size() << " regression(s) above "
+                      << options.regression_threshold * 100 << "%" << std::endl;
+            return 2;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Hardware performance counters for chimera_bench, read with perf_event_open
+// on the calling thread (user space only, so perf_event_paranoid <= 2 is
+// enough). Each event is opened on its own: a VM or container that lacks one
+// event, typically the cache ones, still reports the rest, and one without
+// any (seccomp, paranoid 3, no PMU, not Linux) reports !available() and the
+// reason in error() instead of failing the run. Counts are scaled up when the kernel
+// multiplexed the counters. Threads started by the measured code are not
+// counted.
+namespace chimera::bench {
+
+enum class PerfEvent : size_t {
+    Cycles,
+    Instructions,
+    L1dMisses,        // L1 data cache read misses
+    LlcMisses,        // Last-level cache misses
+    BranchMisses,
+    Count
+};
+
+inline const char* perf_event_name(PerfEvent event) {
+    switch (event) {
+        case PerfEvent::Cycles: return "cycles";
+        case PerfEvent::Instructions: return "instructions";
+        case PerfEvent::L1dMisses: return "l1d_misses";
+        case PerfEvent::LlcMisses: return "llc_misses";
+        case PerfEvent::BranchMisses: return "branch_misses";
+        case PerfEvent::Count: break;
+    }
+    return "?";
+}
+
+constexpr size_t PERF_EVENT_COUNT = static_cast<size_t>(PerfEvent::Count);
+
+struct PerfSample {
+    std::array<double, PERF_EVENT_COUNT> values;     // -1 = event not available
+    PerfSample() { values.fill(-1); }
+    double& operator[](PerfEvent event) { return values[static_cast<size_t>(event)]; }
+    double operator[](PerfEvent event) const { return values[static_cast<size_t>(event)]; }
+};
+
+class PerfCounters {
+    std::array<int, PERF_EVENT_COUNT> fds_;
+    std::string error_;
+
+public:
+    PerfCounters() {
+        fds_.fill(-1);
+#if defined(__linux__)
+        constexpr uint64_t l1d_read_miss = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                           (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        const std::pair<uint32_t, uint64_t> events[PERF_EVENT_COUNT] = {
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HW_CACHE, l1d_read_miss},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        };
+        int first_errno = 0;
+        for (size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = events[i].first;
+            attr.config = events[i].second;
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            fds_[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+            if (fds_[i] < 0 && first_errno == 0) {
+                first_errno = errno;
+            }
+        }
+        if (!available()) {
+            error_ = describe(first_errno);
+        }
+#else
+        error_ = "perf_event_open needs Linux";
+#endif
+    }
+
+    ~PerfCounters() {
+#if defined(__linux__)
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    // True when at least one event could be opened
+    bool available() const {
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool has(PerfEvent event) const { return fds_[static_cast<size_t>(event)] >= 0; }
+
+    // Why nothing could be opened; empty when available()
+    const std::string& error() const { return error_; }
+
+    // Zeroes the totals; start()/stop() pairs then accumulate into them
+    void reset() {
+#if defined(__linux__)
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            }
+        }
+#endif
+    }
+
+    void start() {
+#if defined(__linux__)
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+    }
+
+    void stop() {
+#if defined(__linux__)
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            }
+        }
+#endif
+    }
+
+    // Totals since reset(), scaled for multiplexing and divided by `operations`
+    PerfSample per_op(double operations) const {
+        PerfSample sample;
+#if defined(__linux__)
+        for (size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+            uint64_t data[3] = {};   // value, time enabled, time running
+            if (fds_[i] < 0 || read(fds_[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data))) {
+                continue;
+            }
+            if (data[2] == 0) {
+                continue;            // Never scheduled onto the PMU
+            }
+            const double scaled = static_cast<double>(data[0]) * data[1] / data[2];
+            sample.values[i] = operations > 0 ? scaled / operations : 0;
+        }
+#else
+        (void)operations;
+#endif
+        return sample;
+    }
+
+private:
+    static std::string describe(int error) {
+        switch (error) {
+            case EACCES:
+            case EPERM:
+                return "perf_event_open not permitted (kernel.perf_event_paranoid or container seccomp policy)";
+            case ENOENT:
+            case ENODEV:
+            case EOPNOTSUPP:
+                return "no hardware PMU events on this machine";
+            case ENOSYS:
+                return "perf_event_open not supported by this kernel";
+            default:
+                return std::string("perf_event_open failed: ") + std::strerror(error);
+        }
+    }
+};
+
+} // namespace chimera::bench
@@ -17,6 +17,7 @@ struct AsyncResult {
     std::vector<uint8_t> data;
     std::chrono::milliseconds latency;
     TransportError error;
+    StageTimings timings{};
 };
 
 // Callback for async operations
@@ -29,6 +30,12 @@ struct AsyncRequest {
     AsyncCallback callback;
     std::chrono::steady_clock::time_point start_time;
     std::chrono::milliseconds timeout;
+    // Call start and the stages done before submit (encode, mimicry delay);
+    // the manager adds queue wait, send, first byte and complete. A default
+    // created_time means the call started at submit
+    std::chrono::steady_clock::time_point created_time{};
+    StageTimings timings{};
+    uint64_t transfer_id = 0;   // Trace id (Tracer::next_transfer_id); 0 = untraced
 };
 
 // High-performance async I/O manager
@@ -9,8 +9,8 @@
 #include <arpa/inet.h>
 #include <unistd.h>
 #include <cstring>
-#include <iostream>
 #include "tl/expected.hpp"
+#include "chimera/logging.hpp"
 
 namespace chimera {
 
@@ -40,13 +40,13 @@ public:
     TransportUdp(const std::string& server_ip, uint16_t port) {
         sock_ = socket(AF_INET, SOCK_DGRAM, 0);
         if (sock_ < 0) {
-            std::cerr << "Socket creation failed: " << strerror(errno) << std::endl;
+            CHIMERA_LOG_ERROR("Socket creation failed: {}", strerror(errno));
             return;
         }
         server_addr_.sin_family = AF_INET;
         server_addr_.sin_port = htons(port);
         if (inet_pton(AF_INET, server_ip.c_str(), &server_addr_.sin_addr) <= 0) {
-            std::cerr << "Invalid server IP address" << std::endl;
+            CHIMERA_LOG_ERROR("Invalid server IP address: {}", server_ip);
             close(sock_);
             sock_ = -1;
             return;
@@ -72,10 +72,13 @@ public:
 
     tl::expected<std::vector<uint8_t>, TransportError> receive() override {
         if (sock_ < 0) return tl::unexpected(TransportError::SocketCreationFailed);
-        std::vector<uint8_t> buffer(512);
+        // EDNS0-sized buffer so multi-string TXT answers are not cut at 512 bytes
+        std::vector<uint8_t> buffer(4096);
         ssize_t received = recvfrom(sock_, buffer.data(), buffer.size(), 0, nullptr, nullptr);
         if (received < 0) {
-            return tl::unexpected(TransportError::ReceiveFailed);
+            // SO_RCVTIMEO expiry surfaces as EAGAIN
+            return tl::unexpected(errno == EAGAIN || errno == EWOULDBLOCK ? TransportError::Timeout
+                                                                          : TransportError::ReceiveFailed);
         }
         buffer.resize(received);
         return buffer;
@@ -95,11 +98,13 @@ public:
 // DoH (DNS-over-HTTPS) transport implementation
 class TransportDoH : public ITransport {
     std::string server_url_;
+    std::string ca_file_; // Trust anchors in place of the system store (e.g. a private test CA)
     std::chrono::milliseconds timeout_ = std::chrono::milliseconds(5000);
     std::vector<uint8_t> last_response_; // Store response from HTTPS request
     
 public:
-    TransportDoH(const std::string& server_url) : server_url_(server_url) {
+    TransportDoH(const std::string& server_url, std::string ca_file = "")
+        : server_url_(server_url), ca_file_(std::move(ca_file)) {
         // Ensure URL has proper format
         if (server_url_.find("https://") != 0) {
             server_url_ = "https://" + server_url_;
@@ -129,6 +134,7 @@ class TransportDoT : public ITransport {
     void* ssl_ctx_ = nullptr;
     void* ssl_ = nullptr;
     int sock_ = -1;
+    bool connected_ = false; // A later connect is a reconnect after a failure
 
 public:
     TransportDoT(const std::string& server_ip, uint16_t port = 853) 
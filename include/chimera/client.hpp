@@ -3,6 +3,7 @@
 #include <string>
 #include <chrono>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include "tl/expected.hpp"
 #include "common.hpp"
@@ -11,12 +12,19 @@
 // Forward declarations
 namespace chimera {
     class ITransport;
+    class AEADSession;
 }
 
 // Client class - DNS steganography handling
 // Now also with hybrid key exchange
 namespace chimera {
 
+    // Creates the client's transport in place of the built-in UDP/DoH/DoT ones
+    using TransportFactory = std::function<std::unique_ptr<ITransport>()>;
+
+    // Wraps each transport the client creates (fault injection, instrumentation)
+    using TransportDecorator = std::function<std::unique_ptr<ITransport>(std::unique_ptr<ITransport>)>;
+
     enum class ChimeraError {
         NetworkError,
         ConfigError,
@@ -35,6 +43,9 @@ namespace chimera {
         bool use_random_subdomains = true;
         bool use_hybrid_crypto = true; // Enable hybrid key exchange
         TransportType transport = TransportType::UDP;
+        std::string doh_ca_file; // PEM trust anchors for DoH; empty uses the system store
+        TransportFactory transport_factory; // Replaces transport/dns_server (e.g. LoopbackServer::factory()); empty = built-in
+        TransportDecorator transport_decorator; // Applied to every transport; empty = none
         bool adaptive_transport = false; // Behavioral mimicry
         std::chrono::milliseconds timing_variance{100}; // Jitter for behavioral mimicry
         BehavioralProfile behavioral_profile = BehavioralProfile::Normal;
@@ -45,6 +56,31 @@ namespace chimera {
         bool randomize_fragments = true;
         double noise_ratio = 0.1;
         size_t max_fragments = 10;
+        size_t max_txt_length = 255; // Raise over TCP/DoT to pack several KB per TXT answer
+        std::chrono::milliseconds fragment_delay{10}; // Pause between fragment queries; 0 for benchmarks
+        bool collect_fragment_timings = false; // send_data waits for each fragment's answer and reports its RTT
+    };
+
+    // Where the time of one call went, in nanoseconds. Stages that do not
+    // apply to a call (no compression, no reply read) stay zero.
+    struct StageTimings {
+        std::chrono::nanoseconds encode{0};        // Payload -> queries, compression included
+        std::chrono::nanoseconds compress{0};
+        std::chrono::nanoseconds crypto{0};        // Session sealing
+        std::chrono::nanoseconds mimicry_delay{0}; // Behavioral delay and pauses between fragments
+        std::chrono::nanoseconds queue_wait{0};    // Async: submitted -> picked up by a worker
+        std::chrono::nanoseconds send{0};          // Summed over every ITransport::send
+        std::chrono::nanoseconds first_byte{0};    // Call start -> first response received
+        std::chrono::nanoseconds complete{0};      // Call start -> result ready
+    };
+
+    // One fragment query of send_data (ClientConfig::collect_fragment_timings)
+    struct FragmentTiming {
+        uint32_t fragment_id = 0;
+        DnsType record_type = DnsType::TXT;
+        std::chrono::nanoseconds send{0};
+        std::chrono::nanoseconds rtt{0};           // Query sent -> answer received; zero when unanswered
+        bool answered = false;
     };
 
     struct SendResult {
@@ -57,10 +93,14 @@ namespace chimera {
         size_t fragments_sent;
         EncodingStrategy encoding_used;
         bool compression_used;
+
+        StageTimings timings{};
+        std::vector<FragmentTiming> fragment_timings{}; // Empty unless collect_fragment_timings
     };
 
     class ChimeraClient {
         ClientConfig config_;
+        std::shared_ptr<AEADSession> session_;
 
     public:
         explicit ChimeraClient(ClientConfig config) : config_(std::move(config)) {}
@@ -85,6 +125,11 @@ namespace chimera {
         [[nodiscard]] const ClientConfig& get_config() const { return config_; }
         void update_config(ClientConfig new_config) { config_ = std::move(new_config); }
 
+        // Seal outgoing and open received payloads with an established session
+        // (16-byte tag per 64 KiB segment, no nonce on the wire); nullptr sends in the clear
+        void set_session(std::shared_ptr<AEADSession> session) { session_ = std::move(session); }
+        [[nodiscard]] const std::shared_ptr<AEADSession>& get_session() const { return session_; }
+
         // Kapcsolat teszt
         tl::expected<std::chrono::milliseconds, ChimeraError> ping_dns_server() const;
 
@@ -3,17 +3,82 @@
 #include <string>
 #include <functional>
 #include <unordered_map>
+#include <vector>
 #include "client.hpp"
 
 namespace chimera {
 
+// A transport/resolver pair auto-tune may choose
+struct TuneCandidate {
+    TransportType transport = TransportType::UDP;
+    std::string dns_server = "8.8.8.8";
+    uint16_t dns_port = 53;
+    std::string doh_ca_file;
+    TransportFactory transport_factory;   // Replaces transport/dns_server (loopback, tests)
+    std::string label;                    // Report name; empty = "<transport> <server>:<port>"
+};
+
+enum class TuneGoal {
+    Goodput,    // Most payload bytes per second
+    Latency     // Shortest time until one payload is delivered
+};
+
+struct AutoTuneOptions {
+    std::vector<TuneCandidate> candidates;            // Empty = the base config's transport and server
+    TuneGoal goal = TuneGoal::Goodput;
+    size_t probes_per_candidate = 8;                  // Plus one unmeasured warm-up query
+    std::chrono::milliseconds probe_timeout{1000};
+    std::vector<uint8_t> sample_payload;              // Empty = 4 KiB of text-like data
+};
+
+struct CandidateMeasurement {
+    std::string label;
+    size_t probes = 0;
+    size_t answered = 0;
+    double loss = 1.0;                                // Unanswered fraction
+    std::chrono::microseconds rtt_median{0};
+    std::chrono::microseconds rtt_max{0};
+    double score = 0.0;                               // Bytes/s (Goodput) or 1/seconds (Latency); 0 = unusable
+};
+
+struct AutoTuneReport {
+    std::vector<CandidateMeasurement> candidates;
+    size_t chosen = 0;                                // Index into candidates; candidates.size() = none answered
+
+    size_t sample_bytes = 0;
+    double compression_ratio = 1.0;                   // Compressed / original size
+    double encode_mb_per_s = 0.0;                     // Without compression
+    double encode_compressed_mb_per_s = 0.0;
+    size_t fragments = 0;                             // Queries per sample without compression
+    size_t fragments_compressed = 0;
+
+    bool use_compression = true;
+    size_t max_fragments = 0;
+    std::chrono::milliseconds timeout{0};
+    double predicted_goodput = 0.0;                   // Payload bytes/s on the chosen settings
+    std::chrono::milliseconds predicted_latency{0};   // One sample payload
+
+    std::string summary() const;
+};
+
+struct AutoTuneResult {
+    ClientConfig config;
+    AutoTuneReport report;
+};
+
 class ConfigWizard {
 public:
     ConfigWizard();
-    
+
     // Run interactive configuration setup
     ClientConfig runInteractiveSetup();
 
+    // Non-interactive: measures RTT and loss of every candidate, compression
+    // ratio and encoder speed on the sample, then returns `base` with the
+    // transport, compression, max_fragments and timeout that score best for
+    // the goal. Prints nothing; the report carries the measurements.
+    AutoTuneResult runAutoTune(const ClientConfig& base, const AutoTuneOptions& options = {});
+
 private:
     // Validation rules for configuration fields
     std::unordered_map<std::string, std::function<bool(const std::string&)>> validationRules;
@@ -31,10 +96,14 @@ private:
     void displayConfigSummary(const ClientConfig& config);
 
     // Convert transport type to human-readable string
-    std::string transportToString(TransportType type);
+    static std::string transportToString(TransportType type);
 
     // Convert encoding strategy to human-readable string
-    std::string encodingToString(EncodingStrategy strategy);
+    static std::string encodingToString(EncodingStrategy strategy);
+
+    // RTT and loss of one candidate over options.probes_per_candidate queries
+    static CandidateMeasurement probeCandidate(const ClientConfig& base, const TuneCandidate& candidate,
+                                               const AutoTuneOptions& options);
 };
 
-}  // namespace chimera
\ No newline at end of file
+}  // namespace chimera
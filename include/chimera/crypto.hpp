@@ -2,11 +2,18 @@
 
 #include <vector>
 #include <string>
+#include <memory>
 #include "tl/expected.hpp"
+#include "secure_memory.hpp"
 #include <utility>
+#include <cstdint>
+#include <atomic>
+#include <bitset>
+#include <functional>
+#include <mutex>
 
 // Cryptographic layer - AEAD + hybrid key exchange
-// X25519 + ML-KEM768 combination for post-quantum security
+// X25519 + ML-KEM combination for post-quantum security (ML-KEM768 by default)
 namespace chimera {
 
 enum class CryptoError {
@@ -18,18 +25,22 @@ enum class CryptoError {
     KeyExchangeFailed,
     InvalidPublicKey,
     InvalidCiphertext,
-    UnsupportedAlgorithm
+    UnsupportedAlgorithm,
+    InvalidTicket,
+    TicketExpired,
+    KeyExpired,
+    ReplayDetected
 };
 
-// Basic types
-using CryptoKey = std::vector<uint8_t>;
+// Basic types - secret material lives in the secure arena and is wiped on release
+using CryptoKey = SecureBytes;
 using Nonce = std::vector<uint8_t>;
 using Plaintext = std::vector<uint8_t>;
 using Ciphertext = std::vector<uint8_t>;
 using AssociatedData = std::vector<uint8_t>;
 using PublicKey = std::vector<uint8_t>;
-using PrivateKey = std::vector<uint8_t>;
-using SharedSecret = std::vector<uint8_t>;
+using PrivateKey = SecureBytes;
+using SharedSecret = SecureBytes;
 
 // AEAD encrypted package
 struct EncryptedPacket {
@@ -37,42 +48,299 @@ struct EncryptedPacket {
     Nonce nonce;
 };
 
+// AEAD cipher suites - both use 32-byte keys, 12-byte nonces and 16-byte tags,
+// so packets and sessions have the same layout whichever suite is negotiated
+enum class CipherSuite : uint8_t {
+    ChaCha20Poly1305 = 1,
+    AES256GCM = 2            // Requires AES-NI + PCLMUL (libsodium runtime check)
+};
+
+// KEM parameter sets - smaller sets trade security margin for fewer DNS fragments.
+// FIPS 203 ML-KEM and round-3 Kyber share key and ciphertext sizes but do not
+// interoperate (decapsulation silently yields a different secret), so each value
+// names exactly one liboqs method and both peers must agree on it. The values
+// are the one-byte wire identifiers.
+enum class KemAlgorithm : uint8_t {
+    MLKEM512 = 1,
+    MLKEM768 = 2,
+    MLKEM1024 = 3,
+    Kyber512 = 0x11,         // Round-3 Kyber, for peers built against older liboqs
+    Kyber768 = 0x12,
+    Kyber1024 = 0x13
+};
+
+// Wire sizes and relative cost of a KEM parameter set
+struct KemParameters {
+    KemAlgorithm algorithm;
+    std::string name;            // liboqs method name
+    size_t public_key_bytes;
+    size_t secret_key_bytes;
+    size_t ciphertext_bytes;
+    size_t shared_secret_bytes;
+    uint8_t nist_level;
+    double relative_cost;        // Keygen/encaps/decaps work relative to ML-KEM768
+
+    // Bytes on the wire for one handshake (server public keys + client key and ciphertext)
+    size_t handshake_bytes() const;
+
+    // DNS fragments needed for the handshake at the given per-query capacity
+    size_t handshake_fragments(size_t bytes_per_query) const;
+};
+
 // Hybrid key exchange keypair
 struct HybridKeyPair {
     PublicKey x25519_public;
     PrivateKey x25519_private;
     PublicKey mlkem_public;
     PrivateKey mlkem_private;
+    KemAlgorithm kem = KemAlgorithm::MLKEM768;
 };
 
 // Hybrid key exchange result
 struct HybridKeyExchangeResult {
     SharedSecret shared_secret;
     Ciphertext mlkem_ciphertext;
+    PublicKey client_x25519_public; // Ephemeral key the responder needs
+    std::vector<CipherSuite> cipher_offer; // Initiator's AEAD preference, sent with the key share
+};
+
+class HybridKeyPool;
+class WorkerPool;
+
+// Runtime cipher suite selection and negotiation
+class CipherSuites {
+public:
+    // Suites usable on this host, fastest first (detected once at startup)
+    static const std::vector<CipherSuite>& supported();
+    static CipherSuite preferred();
+    static bool is_available(CipherSuite suite);
+    static const char* name(CipherSuite suite);
+
+    // Responder side: first suite in the initiator's preference order that is
+    // available locally
+    static tl::expected<CipherSuite, CryptoError> negotiate(const std::vector<CipherSuite>& offer);
+
+    // Wire form of an offer, one byte per suite; unknown ids are skipped on decode
+    static std::vector<uint8_t> encode_offer(const std::vector<CipherSuite>& offer);
+    static std::vector<CipherSuite> decode_offer(const std::vector<uint8_t>& bytes);
 };
 
-// AEAD class for ChaCha20-Poly1305 handling
+// AEAD class - ChaCha20-Poly1305 by default, AES-256-GCM when selected
 class AEAD {
 public:
     // Libsodium initialization
     AEAD();
 
-    // Key generation for ChaCha20-Poly1305
+    // Key generation (same key size for every suite)
     static tl::expected<CryptoKey, CryptoError> generate_key();
 
     // Encryption
     static tl::expected<EncryptedPacket, CryptoError> encrypt(
         const Plaintext& message,
         const CryptoKey& key,
-        const AssociatedData& ad = {}
+        const AssociatedData& ad = {},
+        CipherSuite suite = CipherSuite::ChaCha20Poly1305
     );
 
     // Decryption
     static tl::expected<Plaintext, CryptoError> decrypt(
         const EncryptedPacket& packet,
         const CryptoKey& key,
+        const AssociatedData& ad = {},
+        CipherSuite suite = CipherSuite::ChaCha20Poly1305
+    );
+};
+
+// Which side of the key exchange a session belongs to; selects the
+// send/receive key direction so the two peers never share a nonce space
+enum class SessionRole {
+    Initiator,
+    Responder
+};
+
+// Session AEAD with implicit, counter-derived nonces (negotiated cipher suite).
+// Per-direction keys and nonce prefixes are derived from the session key and
+// chunk i is sealed under nonce = prefix XOR i, so only the 16-byte tag travels
+// with a chunk. Unlike a secretstream, chunks can be opened in any order given
+// their sequence number, which suits lossy, reordering DNS transports.
+class AEADSession {
+public:
+    static constexpr size_t TAG_BYTES = 16;
+
+    // Sequences this far behind the newest accepted one are still accepted
+    // once by open_next(); older ones are rejected as replays
+    static constexpr size_t REPLAY_WINDOW = 1024;
+
+    // Throws std::invalid_argument on a malformed session key or a suite
+    // that is not available on this host
+    AEADSession(const CryptoKey& session_key, SessionRole role,
+                CipherSuite suite = CipherSuite::ChaCha20Poly1305);
+    ~AEADSession();
+
+    AEADSession(const AEADSession&) = delete;
+    AEADSession& operator=(const AEADSession&) = delete;
+
+    // Encrypt buffer[0, length) in place and append the tag; capacity must be
+    // at least length + TAG_BYTES. Returns the sealed length.
+    tl::expected<size_t, CryptoError> seal_in_place(
+        uint8_t* buffer, size_t length, size_t capacity,
+        uint64_t sequence, const AssociatedData& ad = {}
+    ) const;
+
+    // Verify and decrypt a sealed chunk in place. Returns the plaintext length.
+    tl::expected<size_t, CryptoError> open_in_place(
+        uint8_t* buffer, size_t length,
+        uint64_t sequence, const AssociatedData& ad = {}
+    ) const;
+
+    // Vector forms; seal grows the buffer by TAG_BYTES, open shrinks it
+    tl::expected<void, CryptoError> seal(std::vector<uint8_t>& buffer, uint64_t sequence,
+                                         const AssociatedData& ad = {}) const;
+    tl::expected<void, CryptoError> open(std::vector<uint8_t>& buffer, uint64_t sequence,
+                                         const AssociatedData& ad = {}) const;
+
+    // Sender side: seals under the next per-direction sequence and returns it;
+    // the caller carries the sequence with the chunk
+    tl::expected<uint64_t, CryptoError> seal_next(std::vector<uint8_t>& buffer, const AssociatedData& ad = {});
+
+    // Receiver side: opens a chunk by its carried sequence. Lost or reordered
+    // chunks are fine; a sequence already accepted or older than REPLAY_WINDOW
+    // fails with ReplayDetected
+    tl::expected<void, CryptoError> open_next(std::vector<uint8_t>& buffer, uint64_t sequence,
+                                              const AssociatedData& ad = {});
+
+    // Large payloads: split into segments of segment_bytes, each sealed under
+    // its own sequence (first + i) with (index, is_last) bound into its AD, so
+    // segments cannot be reordered, spliced or truncated. Segments are sealed in
+    // parallel on `pool` (inline when nullptr) and written in order into `out`
+    // as ct || tag per segment. Returns the first sequence used.
+    static constexpr size_t DEFAULT_SEGMENT_BYTES = 64 * 1024;
+
+    static size_t sealed_segments_size(size_t plaintext_size, size_t segment_bytes = DEFAULT_SEGMENT_BYTES);
+    static size_t segment_count(size_t plaintext_size, size_t segment_bytes = DEFAULT_SEGMENT_BYTES);
+
+    tl::expected<uint64_t, CryptoError> seal_segments(
+        const std::vector<uint8_t>& plaintext, std::vector<uint8_t>& out,
+        WorkerPool* pool = nullptr, size_t segment_bytes = DEFAULT_SEGMENT_BYTES,
+        const AssociatedData& ad = {}
+    );
+
+    tl::expected<void, CryptoError> open_segments(
+        const std::vector<uint8_t>& sealed, std::vector<uint8_t>& out, uint64_t first_sequence,
+        WorkerPool* pool = nullptr, size_t segment_bytes = DEFAULT_SEGMENT_BYTES,
+        const AssociatedData& ad = {}
+    ) const;
+
+    // Receiver side of seal_segments: opens by the carried first sequence and
+    // accepts the whole range once, under the same replay window as open_next()
+    tl::expected<void, CryptoError> open_next_segments(
+        const std::vector<uint8_t>& sealed, std::vector<uint8_t>& out, uint64_t first_sequence,
+        WorkerPool* pool = nullptr, size_t segment_bytes = DEFAULT_SEGMENT_BYTES,
+        const AssociatedData& ad = {}
+    );
+
+    // Self-describing transfer: the first sequence (big-endian u64) followed by
+    // the seal_segments() output. A transfer that fails to encode, send or arrive
+    // leaves a gap the receiver skips instead of desynchronizing its counter.
+    static constexpr size_t TRANSFER_HEADER_BYTES = 8;
+
+    tl::expected<uint64_t, CryptoError> seal_transfer(
+        const std::vector<uint8_t>& plaintext, std::vector<uint8_t>& out,
+        WorkerPool* pool = nullptr, size_t segment_bytes = DEFAULT_SEGMENT_BYTES,
         const AssociatedData& ad = {}
     );
+
+    // Returns the transfer's first sequence
+    tl::expected<uint64_t, CryptoError> open_transfer(
+        const std::vector<uint8_t>& transfer, std::vector<uint8_t>& out,
+        WorkerPool* pool = nullptr, size_t segment_bytes = DEFAULT_SEGMENT_BYTES,
+        const AssociatedData& ad = {}
+    );
+
+    [[nodiscard]] SessionRole role() const { return role_; }
+    [[nodiscard]] CipherSuite suite() const { return suite_; }
+    [[nodiscard]] uint64_t next_send_sequence() const { return send_sequence_.load(); }
+    // One past the newest sequence accepted by open_next()
+    [[nodiscard]] uint64_t next_receive_sequence() const;
+
+private:
+    struct Direction {
+        uint8_t key[32];
+        uint8_t nonce_prefix[12];
+    };
+
+    static bool derive_direction(Direction& direction, const CryptoKey& session_key, uint64_t id);
+    static void make_nonce(uint8_t* nonce, const Direction& direction, uint64_t sequence);
+    static AssociatedData make_segment_ad(const AssociatedData& ad, uint64_t index, bool last);
+    static void for_each_segment(WorkerPool* pool, size_t count, const std::function<void(size_t)>& fn);
+
+    // Pointer forms behind the segment API; `out` of seal_segments_into holds
+    // sealed_segments_size() bytes
+    bool seal_segments_into(const std::vector<uint8_t>& plaintext, uint8_t* out, uint64_t first,
+                            WorkerPool* pool, size_t segment_bytes, const AssociatedData& ad) const;
+    tl::expected<void, CryptoError> open_segments_from(
+        const uint8_t* sealed, size_t sealed_size, std::vector<uint8_t>& out, uint64_t first_sequence,
+        WorkerPool* pool, size_t segment_bytes, const AssociatedData& ad) const;
+    tl::expected<void, CryptoError> open_accepted_segments(
+        const uint8_t* sealed, size_t sealed_size, std::vector<uint8_t>& out, uint64_t first_sequence,
+        WorkerPool* pool, size_t segment_bytes, const AssociatedData& ad);
+
+    // Replay window over [first, first + count); caller holds receive_mutex_
+    bool window_allows_locked(uint64_t first, uint64_t count) const;
+    void window_accept_locked(uint64_t first, uint64_t count);
+
+    SessionRole role_;
+    CipherSuite suite_;
+    Direction send_{};
+    Direction receive_{};
+    std::atomic<uint64_t> send_sequence_{0};
+    mutable std::mutex receive_mutex_;
+    uint64_t receive_sequence_ = 0;                // One past the newest accepted sequence
+    std::bitset<REPLAY_WINDOW> receive_window_;    // Bit s % REPLAY_WINDOW: s was accepted
+};
+
+// Reusable storage for batched handshake responses. Requests and results live
+// in contiguous buffers sized once by reserve(), so processing a burst of
+// reconnects performs no per-request allocation.
+class HandshakeBatch {
+public:
+    // Throws std::runtime_error if the KEM is not available
+    explicit HandshakeBatch(KemAlgorithm kem = KemAlgorithm::MLKEM768, size_t capacity = 0);
+    ~HandshakeBatch();
+
+    HandshakeBatch(const HandshakeBatch&) = delete;
+    HandshakeBatch& operator=(const HandshakeBatch&) = delete;
+
+    void reserve(size_t capacity);
+    void clear();
+
+    // Queue one client handshake (ephemeral X25519 key + ML-KEM ciphertext)
+    tl::expected<size_t, CryptoError> add(const PublicKey& client_x25519_public,
+                                          const Ciphertext& mlkem_ciphertext);
+
+    [[nodiscard]] size_t size() const { return count_; }
+    [[nodiscard]] KemAlgorithm kem() const { return kem_; }
+    [[nodiscard]] size_t secret_bytes() const { return secret_bytes_; }
+
+    // Results, valid after HybridKeyExchange::respond_to_exchanges
+    [[nodiscard]] bool succeeded(size_t index) const;
+    [[nodiscard]] CryptoError error(size_t index) const { return errors_[index]; }
+    [[nodiscard]] const uint8_t* secret_data(size_t index) const { return secrets_.data() + index * secret_bytes_; }
+    [[nodiscard]] SharedSecret secret(size_t index) const;
+
+private:
+    friend class HybridKeyExchange;
+
+    KemAlgorithm kem_;
+    size_t public_key_bytes_;
+    size_t ciphertext_bytes_;
+    size_t secret_bytes_;
+    size_t count_ = 0;
+    std::vector<uint8_t> public_keys_;
+    std::vector<uint8_t> ciphertexts_;
+    SecureBytes secrets_;              // Arena-backed; replaced, never grown in place
+    std::vector<uint8_t> status_;
+    std::vector<CryptoError> errors_;
 };
 
 // Hybrid key exchange class - X25519 + ML-KEM768
@@ -81,13 +349,30 @@ public:
     // Initialization
     HybridKeyExchange();
 
-    // Keypair generation (X25519 + ML-KEM768)
-    static tl::expected<HybridKeyPair, CryptoError> generate_keypair();
+    // Keypair generation (X25519 + ML-KEM, 768 unless specified)
+    static tl::expected<HybridKeyPair, CryptoError> generate_keypair(
+        KemAlgorithm kem = KemAlgorithm::MLKEM768
+    );
+
+    // KEM parameter sets and their wire sizes
+    static tl::expected<KemParameters, CryptoError> kem_parameters(KemAlgorithm kem);
+    static std::vector<KemParameters> available_kems();
+
+    // Strongest available ML-KEM set whose handshake fits in max_fragments queries
+    // of bytes_per_query each; falls back to the smallest set when none fits
+    static tl::expected<KemAlgorithm, CryptoError> select_kem(
+        size_t bytes_per_query,
+        size_t max_fragments
+    );
 
     // Client-side key exchange initiation
+    // `kem` must match the server keypair; it is never inferred from the key size.
+    // With a pool, the ephemeral X25519 key is precomputed and only the encapsulation runs inline
     static tl::expected<HybridKeyExchangeResult, CryptoError> initiate_exchange(
         const PublicKey& server_x25519_public,
-        const PublicKey& server_mlkem_public
+        const PublicKey& server_mlkem_public,
+        KemAlgorithm kem = KemAlgorithm::MLKEM768,
+        HybridKeyPool* pool = nullptr
     );
 
     // Server-side key exchange response
@@ -97,6 +382,16 @@ public:
         const Ciphertext& client_mlkem_ciphertext
     );
 
+    // Batch responder for reconnect storms: decapsulates every queued request
+    // across `pool` (inline when nullptr) with per-thread KEM contexts and writes
+    // each hybrid secret into the batch's preallocated slot. Returns the number
+    // of successful handshakes; per-request failures are reported by the batch.
+    static size_t respond_to_exchanges(
+        const HybridKeyPair& server_keypair,
+        HandshakeBatch& batch,
+        WorkerPool* pool = nullptr
+    );
+
     // Key derivation from hybrid shared secrets
     static tl::expected<CryptoKey, CryptoError> derive_key(
         const SharedSecret& shared_secret,
@@ -110,14 +405,16 @@ private:
         const PublicKey& public_key
     );
 
-    // ML-KEM768 key exchange helper functions - PRODUCTION
+    // ML-KEM key exchange helper functions - PRODUCTION
     static tl::expected<std::pair<SharedSecret, Ciphertext>, CryptoError> mlkem_encapsulate(
-        const PublicKey& public_key
+        const PublicKey& public_key,
+        KemAlgorithm kem
     );
 
     static tl::expected<SharedSecret, CryptoError> mlkem_decapsulate(
         const PrivateKey& private_key,
-        const Ciphertext& ciphertext
+        const Ciphertext& ciphertext,
+        KemAlgorithm kem
     );
 
     // HKDF key derivation
@@ -128,4 +425,32 @@ private:
     );
 };
 
+// Background pool of precomputed ephemeral keypairs, keeping key generation
+// off the handshake critical path. Falls back to inline generation when drained.
+class HybridKeyPool {
+public:
+    explicit HybridKeyPool(size_t capacity = 8, KemAlgorithm kem = KemAlgorithm::MLKEM768);
+    ~HybridKeyPool();
+
+    HybridKeyPool(const HybridKeyPool&) = delete;
+    HybridKeyPool& operator=(const HybridKeyPool&) = delete;
+
+    // Start/stop the refill thread
+    void start();
+    void stop();
+
+    // Full X25519 + ML-KEM keypair (e.g. ephemeral responder keys)
+    tl::expected<HybridKeyPair, CryptoError> acquire();
+
+    // X25519-only keypair for initiating an exchange
+    tl::expected<HybridKeyPair, CryptoError> acquire_x25519();
+
+    // Number of ready keypairs (hybrid, x25519)
+    std::pair<size_t, size_t> available() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
 } // namespace chimera
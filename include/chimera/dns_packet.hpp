@@ -7,6 +7,12 @@
 
 namespace chimera {
 
+    // Message size limits that bound how much TXT RDATA fits in one answer
+    constexpr size_t DNS_UDP_MESSAGE_LIMIT = 512;
+    constexpr size_t DNS_EDNS_MESSAGE_LIMIT = 4096;
+    constexpr size_t DNS_TCP_MESSAGE_LIMIT = 65535;
+    constexpr size_t TXT_CHARACTER_STRING_MAX = 255;
+
     enum class DnsType : uint16_t {
         A = 1,
         AAAA = 28,
@@ -51,8 +57,28 @@ namespace chimera {
 
     public:
         static std::vector<uint8_t> build_query(const DnsQuestion& q, const std::string& payload = "");
+        // Same query written into `packet`, reusing its capacity: no allocation
+        // once the buffer has grown to the largest query built into it
+        static void build_query_into(std::vector<uint8_t>& packet, const DnsQuestion& q,
+                                     const std::string& payload = "");
         static std::vector<uint8_t> parse_response(const std::vector<uint8_t>& response, std::vector<DnsResourceRecord>& answers);
 
+        // Responder side: read the header and first question of a query, and build
+        // the matching response (answers named like the question are compressed)
+        static DnsQuestion parse_query(const std::vector<uint8_t>& query, DnsHeader& header);
+        static std::vector<uint8_t> build_response(const DnsHeader& query_header, const DnsQuestion& q,
+                                                   const std::vector<DnsResourceRecord>& answers,
+                                                   uint8_t rcode = 0, bool truncated = false);
+
+        // TXT RDATA is a sequence of <length><bytes> character-strings (RFC 1035 3.3.14).
+        // Data longer than 255 bytes is split across as many strings as needed.
+        static std::vector<uint8_t> build_txt_rdata(const std::string& data);
+        static std::vector<std::string> parse_txt_rdata(const std::vector<uint8_t>& rdata);
+        static std::string join_txt_rdata(const std::vector<uint8_t>& rdata);
+
+        // Largest TXT payload whose RDATA (including length octets) fits in rdata_limit bytes
+        static size_t txt_capacity(size_t rdata_limit);
+
         static void print_packet_hex(const std::vector<uint8_t>& packet);
         static bool validate_domain_name(const std::string& domain);
 
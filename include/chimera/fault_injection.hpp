@@ -0,0 +1,107 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+#include "Transport.hpp"
+#include "client.hpp"
+
+// Fault-injecting transport - wraps any ITransport and impairs it like a bad
+// network: request/response loss, delay distributions, duplication,
+// reordering, truncation and a bandwidth cap. All decisions come from one
+// seeded generator per FaultInjector, so a single-threaded run replays the
+// same faults for the same seed.
+namespace chimera {
+
+enum class DelayDistribution {
+    Constant,      // Always delay
+    Uniform,       // delay +/- delay_jitter
+    Normal,        // Mean delay, standard deviation delay_jitter
+    Exponential,   // Mean delay
+    Pareto         // Heavy tail with mean delay (pareto_shape > 1)
+};
+
+struct FaultProfile {
+    double loss_rate = 0.0;                          // Requests dropped before the wire
+    double response_loss_rate = 0.0;                 // Responses dropped on the way back
+    DelayDistribution delay_distribution = DelayDistribution::Constant;
+    std::chrono::microseconds delay{0};              // Added to each response
+    std::chrono::microseconds delay_jitter{0};
+    double pareto_shape = 2.0;
+    double duplicate_rate = 0.0;                     // Response delivered twice
+    double reorder_rate = 0.0;                       // Response swapped with the next pipelined one
+    double truncate_rate = 0.0;                      // Response cut to a random shorter length
+    uint64_t bandwidth_bps = 0;                      // Shared link capacity, 0 = unlimited
+    uint64_t seed = 1;
+};
+
+struct FaultStats {
+    uint64_t requests = 0;
+    uint64_t dropped_requests = 0;
+    uint64_t responses = 0;
+    uint64_t dropped_responses = 0;
+    uint64_t late_responses = 0;                     // Delay exceeded the timeout
+    uint64_t duplicated = 0;
+    uint64_t reordered = 0;
+    uint64_t truncated = 0;
+    uint64_t delay_ns = 0;
+    uint64_t throttle_ns = 0;                        // Time spent waiting for link capacity
+};
+
+// Shared fault source: one generator, one link and one set of counters for
+// every transport it wraps
+class FaultInjector {
+public:
+    explicit FaultInjector(FaultProfile profile = {});
+    ~FaultInjector();
+
+    FaultInjector(const FaultInjector&) = delete;
+    FaultInjector& operator=(const FaultInjector&) = delete;
+
+    const FaultProfile& profile() const;
+    FaultStats stats() const;
+
+    // Bernoulli draw from the seeded generator
+    bool roll(double probability);
+    std::chrono::nanoseconds sample_delay();
+    size_t sample_length(size_t below);
+
+    // Blocks until `bytes` fit through the capped link
+    void throttle(size_t bytes);
+
+    // Counter update from the transports, e.g. count(&FaultStats::reordered)
+    void count(uint64_t FaultStats::*counter, uint64_t amount = 1);
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+class FaultInjectingTransport : public ITransport {
+public:
+    FaultInjectingTransport(std::unique_ptr<ITransport> inner, std::shared_ptr<FaultInjector> injector);
+
+    // A dropped request still reports success, like an unacknowledged datagram;
+    // its receive() waits out the timeout
+    tl::expected<size_t, TransportError> send(const std::vector<uint8_t>& data) override;
+    tl::expected<std::vector<uint8_t>, TransportError> receive() override;
+    void set_timeout(std::chrono::milliseconds timeout) override;
+
+private:
+    tl::expected<std::vector<uint8_t>, TransportError> time_out();
+
+    std::unique_ptr<ITransport> inner_;
+    std::shared_ptr<FaultInjector> injector_;
+    std::chrono::milliseconds timeout_{5000};
+    std::deque<bool> outstanding_;                   // Per sent request: reached the inner transport
+    std::deque<std::vector<uint8_t>> held_;          // Reordered responses; their requests are already popped
+    std::deque<std::vector<uint8_t>> duplicates_;    // Extra copies; each answers the next pending request
+    size_t stale_ = 0;                               // Inner responses superseded by a duplicate
+};
+
+// ClientConfig::transport_decorator that routes every client transport through the injector
+TransportDecorator inject_faults(std::shared_ptr<FaultInjector> injector);
+
+} // namespace chimera
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+
+// Log-linear latency histogram (HdrHistogram layout): values below 128 have
+// their own bucket, larger values fall into 64 linear sub-buckets per power
+// of two, so any recorded value is reported within 1/64 (~1.6%) of itself.
+// Fixed size, no allocation on record; one histogram per thread, merged at the end.
+namespace chimera {
+
+class LatencyHistogram {
+public:
+    static constexpr unsigned SUB_BUCKET_BITS = 7;
+    static constexpr size_t SUB_BUCKETS = size_t{1} << SUB_BUCKET_BITS;       // 128
+    static constexpr size_t HALF_SUB_BUCKETS = SUB_BUCKETS / 2;                 // 64
+    static constexpr size_t BUCKET_COUNT = SUB_BUCKETS + (64 - SUB_BUCKET_BITS) * HALF_SUB_BUCKETS;
+
+    void record(uint64_t value, uint64_t count = 1);
+
+    // Coordinated-omission correction for a closed loop that should have issued
+    // a request every expected_interval: a stall also stands in for the requests
+    // that could not be sent meanwhile (value - interval, value - 2*interval, ...)
+    void record_corrected(uint64_t value, uint64_t expected_interval);
+
+    void merge(const LatencyHistogram& other);
+    void reset();
+
+    uint64_t count() const { return total_; }
+    uint64_t min() const { return total_ ? min_ : 0; }
+    uint64_t max() const { return max_; }
+    double mean() const;
+    double stddev() const;
+
+    // Highest value equivalent to the percentile (0..100) sample
+    uint64_t value_at_percentile(double percentile) const;
+
+    // Samples in buckets that lie entirely at or below value (cumulative
+    // bucket count for Prometheus `le` bounds)
+    uint64_t count_at_or_below(uint64_t value) const;
+
+    // HdrHistogram percentile distribution text ("Value Percentile TotalCount
+    // 1/(1-Percentile)"), values divided by unit_scale (1e6 turns ns into ms);
+    // readable by the HdrHistogram plotter
+    void write_percentile_distribution(std::ostream& out, double unit_scale = 1e6,
+                                       unsigned ticks_per_half_distance = 5) const;
+
+    static size_t bucket_index(uint64_t value);
+    static uint64_t bucket_lowest(size_t index);
+    static uint64_t bucket_highest(size_t index);
+
+private:
+    std::array<uint64_t, BUCKET_COUNT> counts_{};
+    uint64_t total_ = 0;
+    uint64_t min_ = UINT64_MAX;
+    uint64_t max_ = 0;
+};
+
+} // namespace chimera
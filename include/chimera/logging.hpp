@@ -0,0 +1,173 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#ifndef CHIMERA_LOG_MIN_LEVEL
+#define CHIMERA_LOG_MIN_LEVEL 0
+#endif
+
+// Asynchronous logging - the calling thread copies the format string pointer
+// and the raw arguments into its own lock-free ring; a background thread does
+// the formatting and the writing. A disabled level costs one relaxed load and
+// a branch, and levels below CHIMERA_LOG_MIN_LEVEL (CMake: -DCHIMERA_LOG_LEVEL)
+// are compiled out together with their arguments.
+//
+//   CHIMERA_LOG_DEBUG("DNS packet created: {} bytes, ID={:x}", packet.size(), id);
+//
+// Formats must be string literals. "{}" prints the next argument, "{:x}" prints
+// an integer in hex. Strings are copied (up to LogRecord::TEXT_BYTES in total
+// per message); a message that does not fit in its thread's ring is dropped
+// and counted rather than blocking the caller.
+namespace chimera {
+
+enum class LogLevel : uint8_t {
+    Trace = 0,
+    Debug = 1,
+    Info = 2,
+    Warn = 3,
+    Error = 4,
+    Off = 5
+};
+
+const char* log_level_name(LogLevel level);
+
+struct LogArg {
+    enum class Kind : uint8_t { Signed, Unsigned, Float, Text };
+    struct TextRef {
+        uint16_t offset;   // Into LogRecord::text
+        uint16_t length;
+    };
+
+    Kind kind = Kind::Signed;
+    union {
+        int64_t i;
+        uint64_t u;
+        double f;
+        TextRef text;
+    };
+
+    LogArg() : i(0) {}
+};
+
+struct LogRecord {
+    static constexpr size_t MAX_ARGS = 8;
+    static constexpr size_t TEXT_BYTES = 192;
+
+    const char* format = nullptr;
+    int64_t wall_ns = 0;              // system_clock; orders lines across threads
+    LogLevel level = LogLevel::Info;
+    uint8_t arg_count = 0;
+    uint16_t text_used = 0;
+    LogArg args[MAX_ARGS];
+    char text[TEXT_BYTES];
+
+    void add(std::string_view value) {
+        const size_t length = std::min(value.size(), TEXT_BYTES - text_used);
+        LogArg& arg = args[arg_count++];
+        arg.kind = LogArg::Kind::Text;
+        arg.text.offset = text_used;
+        arg.text.length = static_cast<uint16_t>(length);
+        std::memcpy(text + text_used, value.data(), length);
+        text_used = static_cast<uint16_t>(text_used + length);
+    }
+    void add(const std::string& value) { add(std::string_view(value)); }
+    void add(const char* value) { add(std::string_view(value ? value : "(null)")); }
+
+    template <typename T>
+    std::enable_if_t<std::is_arithmetic_v<T> || std::is_enum_v<T>> add(T value) {
+        LogArg& arg = args[arg_count++];
+        if constexpr (std::is_enum_v<T>) {
+            arg.kind = LogArg::Kind::Signed;
+            arg.i = static_cast<int64_t>(value);
+        } else if constexpr (std::is_floating_point_v<T>) {
+            arg.kind = LogArg::Kind::Float;
+            arg.f = static_cast<double>(value);
+        } else if constexpr (std::is_signed_v<T>) {
+            arg.kind = LogArg::Kind::Signed;
+            arg.i = static_cast<int64_t>(value);
+        } else {
+            arg.kind = LogArg::Kind::Unsigned;
+            arg.u = static_cast<uint64_t>(value);
+        }
+    }
+
+    // "[CHIMERA LEVEL] message" with the placeholders filled in
+    std::string format_line() const;
+};
+
+// Called on the logger thread with each formatted line (no trailing newline).
+// A sink may log, but must not call Logger::flush() or Logger::set_sink()
+using LogSink = std::function<void(LogLevel, const std::string&)>;
+
+class Logger {
+public:
+    static bool enabled(LogLevel level) {
+        return static_cast<uint8_t>(level) >= level_.load(std::memory_order_relaxed);
+    }
+
+    // Runtime threshold; defaults to Info, or CHIMERA_LOG_LEVEL from the
+    // environment (trace, debug, info, warn, error, off)
+    static void set_level(LogLevel level);
+    static LogLevel level();
+
+    // Replaces the output (std::cerr by default); an empty sink restores it
+    static void set_sink(LogSink sink);
+
+    // Ring size for threads that have not logged yet (rounded up to a power of two)
+    static void set_ring_capacity(size_t records_per_thread);
+
+    template <typename... Args>
+    static void write(LogLevel level, const char* format, const Args&... args) {
+        static_assert(sizeof...(Args) <= LogRecord::MAX_ARGS, "too many log arguments");
+        LogRecord record;
+        record.format = format;
+        record.level = level;
+        record.wall_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        (record.add(args), ...);
+        submit(record);
+    }
+
+    // Formats and writes everything logged so far; also runs at exit
+    static void flush();
+
+    static size_t dropped();
+
+private:
+    static void submit(const LogRecord& record);
+
+    static inline std::atomic<uint8_t> level_{static_cast<uint8_t>(LogLevel::Info)};
+};
+
+// Levels below the build's CHIMERA_LOG_MIN_LEVEL are compiled out
+inline constexpr LogLevel LOG_MIN_LEVEL = static_cast<LogLevel>(CHIMERA_LOG_MIN_LEVEL);
+
+constexpr bool log_compiled_in(LogLevel level) {
+    return level >= LOG_MIN_LEVEL;
+}
+
+} // namespace chimera
+
+#define CHIMERA_LOG(level, ...)                                                   \
+    do {                                                                          \
+        if constexpr (::chimera::log_compiled_in(level)) {                        \
+            if (::chimera::Logger::enabled(level)) {                              \
+                ::chimera::Logger::write(level, __VA_ARGS__);                     \
+            }                                                                     \
+        }                                                                         \
+    } while (0)
+
+#define CHIMERA_LOG_TRACE(...) CHIMERA_LOG(::chimera::LogLevel::Trace, __VA_ARGS__)
+#define CHIMERA_LOG_DEBUG(...) CHIMERA_LOG(::chimera::LogLevel::Debug, __VA_ARGS__)
+#define CHIMERA_LOG_INFO(...) CHIMERA_LOG(::chimera::LogLevel::Info, __VA_ARGS__)
+#define CHIMERA_LOG_WARN(...) CHIMERA_LOG(::chimera::LogLevel::Warn, __VA_ARGS__)
+#define CHIMERA_LOG_ERROR(...) CHIMERA_LOG(::chimera::LogLevel::Error, __VA_ARGS__)
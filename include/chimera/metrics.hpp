@@ -0,0 +1,163 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "latency_histogram.hpp"
+
+// Metrics registry - counters, gauges and latency histograms for the client
+// pipeline, exported in Prometheus text format. Counters and histograms are
+// sharded per thread (threads are spread over METRIC_SHARDS slots on first
+// use), so recording never contends across threads; reads sum the shards.
+namespace chimera {
+
+constexpr size_t METRIC_SHARDS = 16;
+
+// Shard of the calling thread, fixed for the thread's lifetime
+size_t metric_shard();
+
+class Counter {
+public:
+    void inc(uint64_t amount = 1) {
+        shards_[metric_shard()].value.fetch_add(amount, std::memory_order_relaxed);
+    }
+    uint64_t value() const;
+    void reset();
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> value{0};
+    };
+    std::array<Shard, METRIC_SHARDS> shards_;
+};
+
+class Gauge {
+public:
+    void set(int64_t value) { value_.store(value, std::memory_order_relaxed); }
+    void add(int64_t amount) { value_.fetch_add(amount, std::memory_order_relaxed); }
+    int64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<int64_t> value_{0};
+};
+
+// Durations in nanoseconds; exported in seconds
+class Histogram {
+public:
+    void record(uint64_t nanoseconds);
+    void record(std::chrono::nanoseconds duration) {
+        record(static_cast<uint64_t>(duration.count() > 0 ? duration.count() : 0));
+    }
+
+    // Merged copy of all shards
+    LatencyHistogram snapshot() const;
+    uint64_t sum() const;
+    void reset();
+
+private:
+    // A shard is only locked by the threads mapped to it, so the lock is
+    // uncontended unless more threads than shards record at once
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        std::unique_ptr<LatencyHistogram> histogram;   // Allocated on first record
+        uint64_t sum = 0;
+    };
+    std::array<Shard, METRIC_SHARDS> shards_;
+};
+
+// Records the lifetime of the scope into a histogram
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Histogram& histogram)
+        : histogram_(histogram), start_(std::chrono::steady_clock::now()) {}
+    ~ScopedTimer() { histogram_.record(std::chrono::steady_clock::now() - start_); }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    Histogram& histogram_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+class MetricsRegistry {
+public:
+    // Process-wide registry; never destroyed so instrumented code may run during shutdown
+    static MetricsRegistry& global();
+
+    MetricsRegistry();
+    ~MetricsRegistry();
+
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    // Returns the existing metric for name + labels (e.g. `transport="udp"`);
+    // throws std::runtime_error when the name is registered with another type.
+    // References stay valid for the registry's lifetime.
+    Counter& counter(const std::string& name, const std::string& help, const std::string& labels = "");
+    Gauge& gauge(const std::string& name, const std::string& help, const std::string& labels = "");
+    Histogram& histogram(const std::string& name, const std::string& help, const std::string& labels = "");
+
+    // Prometheus text exposition format (version 0.0.4)
+    std::string prometheus_text() const;
+
+    // Writes via a temporary file and rename, so scrapers never see a partial file
+    bool write_prometheus(const std::string& path) const;
+
+    // Zeroes every value; registrations stay
+    void reset();
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+// Stage metrics of the client pipeline, registered in the global registry
+struct PipelineMetrics {
+    Histogram& encode;          // Steganographic encoding, compression included
+    Histogram& compress;
+    Histogram& crypto;          // Session sealing of the payload
+    Histogram& queue_wait;      // Async request submitted -> picked up
+    Histogram& send;            // ITransport::send
+    Histogram& rtt;             // Query sent -> response received
+    Counter& retries;           // Reconnects and re-routed sends
+    Counter& timeouts;
+    Counter& send_errors;
+    Counter& bytes_sent;
+    Counter& fragments_sent;
+    Gauge& async_pending;       // Async requests submitted and not yet completed
+
+    static PipelineMetrics& get();
+};
+
+struct MetricsExportOptions {
+    std::string file_path;                           // Rewritten every file_interval; empty = off
+    std::chrono::milliseconds file_interval{10000};
+    std::string socket_path;                         // Unix stream socket; each connection gets one snapshot
+};
+
+// Background exporter for a registry: periodic file (node_exporter textfile
+// collector) and/or a local Unix socket (e.g. `socat - UNIX-CONNECT:<path>`)
+class MetricsExporter {
+public:
+    // Binds the socket; throws std::runtime_error on failure
+    MetricsExporter(MetricsRegistry& registry, MetricsExportOptions options);
+    ~MetricsExporter();
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    void start();
+    void stop();     // Writes a final file snapshot
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace chimera
@@ -0,0 +1,38 @@
+#pragma once
+
+// USDT probes (provider "chimera") for perf, bpftrace and bcc, compiled in
+// when configured with -DCHIMERA_USDT=ON. A probe site is a single nop plus an
+// ELF note describing where its arguments live, so an unattached probe costs
+// nothing beyond keeping the arguments in registers. Without the option the
+// macros expand to nothing and the arguments are not evaluated.
+//
+// chimera_core is static, so the probes land in the binary that links it:
+//   bpftrace -e 'usdt:./chimera_loadgen:chimera:transport_send { @ns = hist(arg3); }'
+//   perf buildid-cache --add ./chimera_loadgen && perf record -e sdt_chimera:encode_done ...
+//
+// Probes and arguments (latencies in nanoseconds):
+//   dns_query_built(query id, qtype, bytes)
+//   dns_response_parsed(query id, answers, bytes)
+//   transport_send(transfer id, fragment, bytes, latency, ok)
+//   transport_receive(transfer id, fragment, bytes, latency, ok)
+//   encode_start(payload bytes)          encode_done(payload bytes, fragments, ok)
+//   decode_start(fragments)              decode_done(payload bytes, ok)
+//   aead_seal(suite, bytes, ok)          aead_open(suite, bytes, ok)
+//   async_submit(transfer id, timeout ms)
+//   async_complete(transfer id, ok, queue wait, complete)
+// Transfer ids come from Tracer::next_transfer_id() and are 0 while tracing is off.
+
+#if defined(CHIMERA_USDT)
+#include <sys/sdt.h>
+#define CHIMERA_PROBE1(name, a) DTRACE_PROBE1(chimera, name, a)
+#define CHIMERA_PROBE2(name, a, b) DTRACE_PROBE2(chimera, name, a, b)
+#define CHIMERA_PROBE3(name, a, b, c) DTRACE_PROBE3(chimera, name, a, b, c)
+#define CHIMERA_PROBE4(name, a, b, c, d) DTRACE_PROBE4(chimera, name, a, b, c, d)
+#define CHIMERA_PROBE5(name, a, b, c, d, e) DTRACE_PROBE5(chimera, name, a, b, c, d, e)
+#else
+#define CHIMERA_PROBE1(name, a) do { } while (0)
+#define CHIMERA_PROBE2(name, a, b) do { } while (0)
+#define CHIMERA_PROBE3(name, a, b, c) do { } while (0)
+#define CHIMERA_PROBE4(name, a, b, c, d) do { } while (0)
+#define CHIMERA_PROBE5(name, a, b, c, d, e) do { } while (0)
+#endif
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "tl/expected.hpp"
+#include "crypto.hpp"
+
+// Background rekeying - session keys advance through epochs derived from a
+// one-way key chain. The next epoch is prepared off the data path, the switch
+// happens at a fragment boundary, and the previous epoch stays accepted for a
+// short overlap so in-flight fragments still open.
+namespace chimera {
+
+struct RekeyPolicy {
+    uint64_t max_bytes = 1ull << 30;                 // Bytes sealed under one epoch
+    std::chrono::seconds max_age{3600};              // Lifetime of one epoch
+    std::chrono::milliseconds overlap{5000};         // Previous epoch accepted after a switch
+};
+
+// Identifies the key a fragment was sealed under; travels with the fragment
+struct FragmentKeyId {
+    uint32_t epoch;
+    uint64_t sequence;
+};
+
+class RekeyingSession {
+public:
+    // Epoch 0 uses the session key directly; throws like AEADSession
+    RekeyingSession(const CryptoKey& session_key, SessionRole role,
+                    CipherSuite suite = CipherSuite::ChaCha20Poly1305,
+                    RekeyPolicy policy = {});
+    ~RekeyingSession();
+
+    RekeyingSession(const RekeyingSession&) = delete;
+    RekeyingSession& operator=(const RekeyingSession&) = delete;
+
+    // Start/stop the background thread preparing the next epoch. Without it
+    // the next epoch is derived inline when a switch is due.
+    void start();
+    void stop();
+
+    // Seal one fragment in place under the current epoch, switching first if a
+    // threshold was crossed and the next epoch is ready
+    tl::expected<FragmentKeyId, CryptoError> seal(std::vector<uint8_t>& fragment, const AssociatedData& ad = {});
+
+    // Open a fragment from the peer; an authenticated fragment from the next
+    // epoch moves this side to that epoch as well
+    tl::expected<void, CryptoError> open(std::vector<uint8_t>& fragment, const FragmentKeyId& id,
+                                         const AssociatedData& ad = {});
+
+    // Switch at the next fragment boundary regardless of thresholds
+    void request_rekey();
+
+    uint32_t current_epoch() const;
+    size_t live_epochs() const;   // Current, overlapping and prepared epochs
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace chimera
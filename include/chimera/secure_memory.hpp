@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+// Secure memory arena for key material and crypto buffers.
+// Fixed-size slots are carved out of a few sodium_malloc'd (guard-paged,
+// mlock'ed) slabs, so key material stays off the general heap without paying
+// sodium_malloc's guard-page cost per allocation. Slots are zeroed on release.
+namespace chimera {
+
+class SecureArena {
+public:
+    // Slot size classes; larger requests go straight to sodium_malloc
+    static constexpr size_t SIZE_CLASSES[] = {64, 256, 1024, 4096};
+    static constexpr size_t SLAB_BYTES = 64 * 1024;
+
+    struct Stats {
+        size_t slabs;           // Slabs allocated so far
+        size_t slots_in_use;    // Live slot allocations
+        size_t large_in_use;    // Live allocations above the largest size class
+    };
+
+    // Process-wide arena; intentionally never destroyed so key types in other
+    // static objects can release their memory during shutdown
+    static SecureArena& instance();
+
+    void* allocate(size_t bytes);
+    void deallocate(void* ptr, size_t bytes) noexcept;
+
+    Stats stats() const;
+
+    SecureArena(const SecureArena&) = delete;
+    SecureArena& operator=(const SecureArena&) = delete;
+
+private:
+    SecureArena();
+    ~SecureArena() = default;
+
+    class Impl;
+    Impl* impl_;
+};
+
+// Standard allocator over SecureArena
+template <typename T>
+class SecureAllocator {
+public:
+    using value_type = T;
+
+    SecureAllocator() noexcept = default;
+    template <typename U>
+    SecureAllocator(const SecureAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(SecureArena::instance().allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* ptr, size_t n) noexcept {
+        SecureArena::instance().deallocate(ptr, n * sizeof(T));
+    }
+
+    template <typename U>
+    bool operator==(const SecureAllocator<U>&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const SecureAllocator<U>&) const noexcept { return false; }
+};
+
+// Byte buffer for secrets: arena-backed and wiped when freed
+using SecureBytes = std::vector<uint8_t, SecureAllocator<uint8_t>>;
+
+} // namespace chimera
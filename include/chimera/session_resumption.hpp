@@ -0,0 +1,99 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <chrono>
+#include <optional>
+#include "tl/expected.hpp"
+#include "crypto.hpp"
+
+// Session resumption - reconnect from a cached ticket with a nonce exchange
+// and a key derivation step, skipping the X25519 + ML-KEM handshake
+namespace chimera {
+
+// Sent by the client to resume: opaque ticket plus a fresh nonce
+struct ResumptionRequest {
+    std::vector<uint8_t> ticket;
+    std::vector<uint8_t> client_nonce;
+};
+
+// Server reply completing the single resumption round trip
+struct ResumptionResponse {
+    std::vector<uint8_t> server_nonce;
+};
+
+// Client state between sending a ResumptionRequest and receiving the response
+struct PendingResumption {
+    ResumptionRequest request;
+    SharedSecret resumption_secret;
+
+    tl::expected<CryptoKey, CryptoError> complete(const ResumptionResponse& response) const;
+};
+
+class SessionResumption {
+public:
+    static constexpr size_t NONCE_BYTES = 32;
+
+    // Both peers derive this from the full-handshake hybrid shared secret
+    static tl::expected<SharedSecret, CryptoError> derive_resumption_secret(
+        const SharedSecret& handshake_secret
+    );
+
+    // Session key for a resumed session, bound to both nonces
+    static tl::expected<CryptoKey, CryptoError> derive_session_key(
+        const SharedSecret& resumption_secret,
+        const std::vector<uint8_t>& client_nonce,
+        const std::vector<uint8_t>& server_nonce
+    );
+};
+
+// Server side: seals resumption secrets into opaque tickets under a
+// process-local ticket key, so no per-client state is kept
+class SessionTicketIssuer {
+    CryptoKey ticket_key_;
+    std::chrono::seconds lifetime_;
+
+public:
+    explicit SessionTicketIssuer(std::chrono::seconds lifetime = std::chrono::hours(1));
+
+    // Issue a ticket after a full (or resumed) handshake
+    tl::expected<std::vector<uint8_t>, CryptoError> issue(const SharedSecret& handshake_secret) const;
+
+    // Validate a ticket and derive the resumed session key
+    tl::expected<std::pair<ResumptionResponse, CryptoKey>, CryptoError> accept(
+        const ResumptionRequest& request
+    ) const;
+
+    [[nodiscard]] std::chrono::seconds lifetime() const { return lifetime_; }
+};
+
+// Client side: tickets cached per server with their expiry
+class ResumptionCache {
+    struct Entry {
+        std::vector<uint8_t> ticket;
+        SharedSecret resumption_secret;
+        std::chrono::steady_clock::time_point expiry;
+    };
+
+    std::map<std::string, Entry> entries_;
+    mutable std::mutex mutex_;
+
+public:
+    // Store a ticket received after a handshake that produced handshake_secret
+    tl::expected<void, CryptoError> store(
+        const std::string& server_id,
+        const SharedSecret& handshake_secret,
+        std::vector<uint8_t> ticket,
+        std::chrono::seconds lifetime
+    );
+
+    // Start resuming with a cached ticket; tickets are single use
+    std::optional<PendingResumption> resume(const std::string& server_id);
+
+    void purge_expired();
+    size_t size() const;
+};
+
+} // namespace chimera
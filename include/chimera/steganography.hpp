@@ -4,6 +4,7 @@
 #include <vector>
 #include <cstdint>
 #include <memory>
+#include <chrono>
 #include <map>
 #include "tl/expected.hpp"
 #include "dns_packet.hpp"
@@ -28,7 +29,7 @@ namespace chimera {
 
     struct EncodingConfig {
         EncodingStrategy strategy = EncodingStrategy::MULTI_RECORD;
-        size_t max_txt_length = 255;      // Maximum TXT record length
+        size_t max_txt_length = 255;      // Maximum TXT record length (>255 spans several character-strings)
         size_t max_fragments = 10;        // Maximum number of DNS fragments
         bool use_compression = true;       // Enable payload compression
         bool randomize_order = true;       // Randomize fragment order
@@ -67,7 +68,13 @@ namespace chimera {
 
     // TXT record encoding (enhanced from Phase 1/2)
     struct TXTEncoding {
-        static std::vector<std::string> encode_to_txt_fragments(const std::vector<uint8_t>& payload);
+        // Base64 characters carried per record for a given TXT length budget.
+        // Budgets above 255 use multi-string RDATA; larger budgets are clamped so one
+        // record always fits a TCP message.
+        static size_t chunk_size_for(size_t max_txt_length);
+
+        static std::vector<std::string> encode_to_txt_fragments(const std::vector<uint8_t>& payload,
+                                                                size_t max_txt_length = TXT_CHARACTER_STRING_MAX);
         static std::vector<uint8_t> decode_from_txt_fragments(const std::vector<std::string>& txt_records);
         static std::string create_steganographic_txt(const std::vector<uint8_t>& chunk, uint32_t fragment_id);
     };
@@ -85,9 +92,10 @@ namespace chimera {
     public:
         explicit SteganographicEncoder(EncodingConfig config = {}) : config_(std::move(config)) {}
 
-        // Main encoding interface
+        // Main encoding interface; compress_time (optional) receives the time spent in compression
         tl::expected<std::vector<EncodedFragment>, SteganographyError> 
-        encode_payload(const std::vector<uint8_t>& payload, const std::string& base_domain) const;
+        encode_payload(const std::vector<uint8_t>& payload, const std::string& base_domain,
+                       std::chrono::nanoseconds* compress_time = nullptr) const;
 
         // Main decoding interface  
         tl::expected<DecodedPayload, SteganographyError>
@@ -120,17 +128,24 @@ namespace chimera {
         void update_config(EncodingConfig new_config) { config_ = std::move(new_config); }
 
         // Capacity estimation
-        static size_t estimate_capacity(DnsType record_type, size_t max_fragments = 10);
+        static size_t estimate_capacity(DnsType record_type, size_t max_fragments = 10,
+                                        size_t max_txt_length = TXT_CHARACTER_STRING_MAX);
         static size_t estimate_total_capacity(const EncodingConfig& config);
 
-    private:
+        // Payload transforms used by the encoding pipeline (zlib, CRC32)
         std::vector<uint8_t> compress_payload(const std::vector<uint8_t>& payload) const;
         std::vector<uint8_t> decompress_payload(const std::vector<uint8_t>& compressed) const;
-        
+
         std::vector<uint8_t> calculate_checksum(const std::vector<uint8_t>& data) const;
         bool verify_checksum(const std::vector<uint8_t>& data, const std::vector<uint8_t>& checksum) const;
 
+    private:
         std::string generate_steganographic_subdomain(uint32_t fragment_id, DnsType record_type) const;
+        // "<subdomain>.<base_domain>" built in a single allocation
+        std::string fragment_domain(uint32_t fragment_id, DnsType record_type, const std::string& base_domain) const;
+
+        // Raw payload bytes per TXT fragment in multi-record mode
+        size_t txt_chunk_bytes() const;
     };
 
     // Response parsing and extraction for bidirectional communication
@@ -7,6 +7,8 @@
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <utility>
+#include "chimera/crypto.hpp"
 
 namespace chimera {
 
@@ -23,13 +25,65 @@ struct DiagnosticReport {
     std::string suggestion;
 };
 
+// Host capabilities and short measurements that bound throughput
+struct PerformanceProfile {
+    // CPU features, as seen by libsodium's runtime dispatch
+    bool aesni = false;
+    bool pclmul = false;
+    bool avx2 = false;
+    unsigned cores = 0;                              // Usable by this process (affinity mask)
+
+    long rmem_max = -1;                              // net.core.rmem_max / wmem_max in bytes, -1 = unknown
+    long wmem_max = -1;
+    uint64_t nofile_soft = 0;                        // RLIMIT_NOFILE
+    uint64_t nofile_hard = 0;
+    bool ktls_kernel = false;                        // "tls" in net.ipv4.tcp_available_ulp
+    bool ktls_openssl = false;                       // OpenSSL built with kTLS (reported only)
+
+    std::chrono::nanoseconds loopback_udp_rtt{0};    // Median 127.0.0.1 round trip, 0 = not measured
+    std::vector<std::pair<CipherSuite, double>> aead_mb_per_s;   // Sealing 16 KiB chunks, per available suite
+};
+
+struct PreflightOptions {
+    // Resolver for the network probe; empty = first IPv4 nameserver in
+    // /etc/resolv.conf, falling back to 8.8.8.8
+    std::string dns_server;
+    uint16_t dns_port = 53;
+    std::string probe_domain = "example.com";
+    std::chrono::milliseconds network_deadline{250};   // The probe never waits longer
+    std::chrono::seconds cache_ttl{60};                // 0 = always rerun
+    bool probe_performance = true;                     // probePerformance() + tuning advice
+
+    bool operator==(const PreflightOptions&) const = default;
+};
+
+struct PreflightResult {
+    std::vector<DiagnosticReport> checks;   // Libraries, network, memory, permissions
+    PerformanceProfile profile;             // Default-constructed unless probe_performance
+    std::vector<DiagnosticReport> tuning;
+    std::chrono::steady_clock::time_point measured_at{};
+    std::chrono::milliseconds duration{0};
+};
+
 class SystemDiagnostics {
 public:
+    // Runs the checks in parallel and caches the result for options.cache_ttl;
+    // a call with different options reruns them
+    static PreflightResult runPreflight(const PreflightOptions& options = {});
+    static void clearCache();
+
     // Check system compatibility and readiness
-    static std::vector<DiagnosticReport> runPreflightChecks();
+    static std::vector<DiagnosticReport> runPreflightChecks(const PreflightOptions& options = {});
 
     // Generate a comprehensive system diagnostic report
-    static std::string generateDetailedReport();
+    static std::string generateDetailedReport(const PreflightOptions& options = {});
+
+    // Reads CPU features and system limits, then measures loopback UDP round
+    // trips and AEAD throughput (about 50 ms in total)
+    static PerformanceProfile probePerformance();
+
+    // Concrete tuning advice for a measured profile
+    static std::vector<DiagnosticReport> tuningSuggestions(const PerformanceProfile& profile);
 
     // Log diagnostic information
     static void logDiagnostic(DiagnosticLevel level, 
@@ -40,8 +94,8 @@ private:
     // Check cryptographic library availability
     static DiagnosticReport checkCryptoLibraries();
 
-    // Check network capabilities
-    static DiagnosticReport checkNetworkCapabilities();
+    // Check network capabilities: one in-process A query within the deadline
+    static DiagnosticReport checkNetworkCapabilities(const PreflightOptions& options);
 
     // Verify system performance metrics
     static DiagnosticReport checkPerformanceMetrics();
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Pipeline tracing - spans recorded into per-thread lock-free rings and
+// dumped as Chrome trace-event JSON (chrome://tracing, ui.perfetto.dev).
+// Every span carries the transfer it belongs to and, where it applies, the
+// fragment, so encoder/network overlap and head-of-line blocking show up on
+// one timeline. While tracing is off a span costs one relaxed load and a branch.
+namespace chimera {
+
+struct TraceEvent {
+    const char* category = nullptr;   // String literals: stored by pointer
+    const char* name = nullptr;
+    uint64_t start_ns = 0;            // Since the tracer epoch
+    uint64_t duration_ns = 0;
+    uint64_t transfer_id = 0;         // 0 = not part of a transfer
+    int64_t fragment_id = -1;         // -1 = whole transfer
+};
+
+class Tracer {
+public:
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    // Starts recording; threads get a ring of events_per_thread on their first
+    // span (capacity is rounded up to a power of two). Events that do not fit
+    // before the next dump are dropped and counted. A thread's ring is freed
+    // after it exits and its events are drained.
+    static void start(size_t events_per_thread = 65536);
+    static void stop();
+
+    // Unique id for spans of one send/receive; 0 while tracing is off
+    static uint64_t next_transfer_id();
+
+    static void record(const char* category, const char* name,
+                       std::chrono::steady_clock::time_point start,
+                       std::chrono::steady_clock::time_point end,
+                       uint64_t transfer_id = 0, int64_t fragment_id = -1);
+
+    // Drains every ring and returns all events so far as a Chrome trace
+    // ({"traceEvents": [...]}, complete "X" events in microseconds)
+    static std::string chrome_json();
+    static bool write_chrome_json(const std::string& path);
+
+    static size_t dropped();
+    static void clear();
+
+private:
+    static inline std::atomic<bool> enabled_{false};
+};
+
+// Records its scope as one span when tracing is on
+class TraceSpan {
+public:
+    TraceSpan(const char* category, const char* name, uint64_t transfer_id = 0, int64_t fragment_id = -1) {
+        if (Tracer::enabled()) {
+            category_ = category;
+            name_ = name;
+            transfer_id_ = transfer_id;
+            fragment_id_ = fragment_id;
+            start_ = std::chrono::steady_clock::now();
+        }
+    }
+    ~TraceSpan() {
+        if (category_) {
+            Tracer::record(category_, name_, start_, std::chrono::steady_clock::now(), transfer_id_, fragment_id_);
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* category_ = nullptr;   // nullptr = not recording
+    const char* name_ = nullptr;
+    uint64_t transfer_id_ = 0;
+    int64_t fragment_id_ = -1;
+    std::chrono::steady_clock::time_point start_{};
+};
+
+} // namespace chimera
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "Transport.hpp"
+#include "client.hpp"
+#include "spsc_ring.hpp"
+
+// In-process loopback transport - queries go straight to a responder callback
+// instead of the network, so benchmarks see the encoder, pipeline and async
+// engine without kernel networking noise. The responder runs on the sending
+// thread; responses wait in a lock-free ring (or, in SocketPair mode, in a Unix
+// datagram socketpair) until receive().
+namespace chimera {
+
+enum class LoopbackMode {
+    Ring,          // In-memory SPSC ring, no syscalls
+    SocketPair     // AF_UNIX SOCK_DGRAM pair: kernel datagram path without a network stack
+};
+
+// Returns the response to a query; empty = no answer (receive() times out)
+using LoopbackResponder = std::function<std::vector<uint8_t>(const std::vector<uint8_t>& query)>;
+
+struct LoopbackStats {
+    uint64_t queries = 0;
+    uint64_t responses = 0;
+    uint64_t dropped = 0;          // Response queue full, like an overflowing socket buffer
+};
+
+// Shared by every transport it creates: responder, mode and counters
+class LoopbackServer : public std::enable_shared_from_this<LoopbackServer> {
+public:
+    // Empty responder = answer_empty(): NOERROR with no records. queue_depth
+    // bounds unread responses per transport in Ring mode; SocketPair mode uses
+    // the socket buffer
+    static std::shared_ptr<LoopbackServer> create(LoopbackResponder responder = {},
+                                                  LoopbackMode mode = LoopbackMode::Ring,
+                                                  size_t queue_depth = 256);
+
+    // Echoes the question with an empty NOERROR answer section
+    static std::vector<uint8_t> answer_empty(const std::vector<uint8_t>& query);
+
+    std::unique_ptr<ITransport> connect();
+
+    // ClientConfig::transport_factory that connects every client transport here
+    TransportFactory factory();
+
+    LoopbackMode mode() const { return mode_; }
+    size_t queue_depth() const { return queue_depth_; }
+    LoopbackStats stats() const;
+
+    // Runs the responder and counts the exchange; empty = no answer
+    std::vector<uint8_t> respond(const std::vector<uint8_t>& query);
+    void count_drop() { dropped_.fetch_add(1, std::memory_order_relaxed); }
+
+private:
+    LoopbackServer(LoopbackResponder responder, LoopbackMode mode, size_t queue_depth);
+
+    LoopbackResponder responder_;
+    LoopbackMode mode_;
+    size_t queue_depth_;
+    std::atomic<uint64_t> queries_{0};
+    std::atomic<uint64_t> responses_{0};
+    std::atomic<uint64_t> dropped_{0};
+};
+
+class TransportLoopback : public ITransport {
+public:
+    // Throws std::runtime_error when the socketpair cannot be created
+    explicit TransportLoopback(std::shared_ptr<LoopbackServer> server);
+    ~TransportLoopback() override;
+
+    TransportLoopback(const TransportLoopback&) = delete;
+    TransportLoopback& operator=(const TransportLoopback&) = delete;
+
+    tl::expected<size_t, TransportError> send(const std::vector<uint8_t>& data) override;
+    tl::expected<std::vector<uint8_t>, TransportError> receive() override;
+    void set_timeout(std::chrono::milliseconds timeout) override;
+
+private:
+    std::shared_ptr<LoopbackServer> server_;
+    SpscRing<std::vector<uint8_t>> responses_;
+    int client_fd_ = -1;           // SocketPair mode: client end
+    int server_fd_ = -1;           // SocketPair mode: responder end
+    std::vector<uint8_t> scratch_; // SocketPair mode: query as read by the responder end
+};
+
+} // namespace chimera
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+// Fixed-size worker pool for data-parallel crypto work (segment sealing,
+// batched handshakes). The calling thread participates, so a pool of N
+// workers runs a parallel_for on up to N + 1 cores.
+namespace chimera {
+
+class WorkerPool {
+public:
+    // 0 threads = one per hardware core, minus the calling thread
+    explicit WorkerPool(size_t threads = 0);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Run fn(i) for every i in [0, count) and block until all calls finished.
+    // The first exception thrown by fn is rethrown on the calling thread.
+    void parallel_for(size_t count, const std::function<void(size_t)>& fn);
+
+    // Worker threads, not counting the caller
+    size_t size() const;
+
+    // Lazily created process-wide pool
+    static WorkerPool& shared();
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace chimera
@@ -4,12 +4,17 @@
 #include "chimera/base64.hpp"
 #include "chimera/dns_packet.hpp"
 #include "chimera/BehavioralMimicry.hpp"
+#include "chimera/metrics.hpp"
+#include "chimera/tracing.hpp"
+#include "chimera/probes.hpp"
+#include "chimera/logging.hpp"
 #include <queue>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
 #include <atomic>
-#include <iostream>
+#include <cerrno>
+#include <cstring>
 
 #ifdef __APPLE__
 #include <sys/event.h>
@@ -42,18 +47,21 @@ public:
 #ifdef __APPLE__
         kqueue_fd_ = kqueue();
         if (kqueue_fd_ == -1) {
-            std::cerr << "Failed to create kqueue" << std::endl;
+            CHIMERA_LOG_ERROR("Failed to create kqueue: {}", std::strerror(errno));
         }
 #elif __linux__
         epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
         if (epoll_fd_ == -1) {
-            std::cerr << "Failed to create epoll" << std::endl;
+            CHIMERA_LOG_ERROR("Failed to create epoll: {}", std::strerror(errno));
         }
 #endif
     }
     
     ~Impl() {
         stop_background_processing();
+        // Requests still queued are dropped without a callback
+        PipelineMetrics::get().async_pending.add(
+            -static_cast<int64_t>(pending_requests_.size() + active_requests_.size()));
 #ifdef __APPLE__
         if (kqueue_fd_ >= 0) {
             close(kqueue_fd_);
@@ -68,6 +76,8 @@ public:
     void submit_request(std::unique_ptr<AsyncRequest> request) {
         std::lock_guard<std::mutex> lock(requests_mutex_);
         request->start_time = std::chrono::steady_clock::now();
+        PipelineMetrics::get().async_pending.add(1);
+        CHIMERA_PROBE2(async_submit, request->transfer_id, request->timeout.count());
         pending_requests_.push(std::move(request));
         requests_cv_.notify_one();
     }
@@ -123,12 +133,21 @@ public:
             
             if (elapsed >= request->timeout) {
                 // Timeout
+                StageTimings timings = request->timings;
+                timings.queue_wait = now - request->start_time;
+                timings.complete = now - call_start(*request);
                 AsyncResult result{
                     .success = false,
                     .data = {},
                     .latency = elapsed,
-                    .error = TransportError::Timeout
+                    .error = TransportError::Timeout,
+                    .timings = timings
                 };
+                auto& metrics = PipelineMetrics::get();
+                metrics.timeouts.inc();
+                metrics.async_pending.add(-1);
+                CHIMERA_PROBE4(async_complete, request->transfer_id, false, timings.queue_wait.count(),
+                               timings.complete.count());
                 request->callback(result);
                 continue;
             }
@@ -149,61 +168,111 @@ public:
     }
     
     static void process_single_request(std::unique_ptr<AsyncRequest> request) {
-        auto start_time = request->start_time;
+        using Clock = std::chrono::steady_clock;
+        const auto start_time = request->start_time;
+        const auto picked_at = Clock::now();
+        auto& metrics = PipelineMetrics::get();
+
+        // The request stops counting as pending once its callback runs
+        struct PendingGuard {
+            Gauge& pending;
+            ~PendingGuard() { pending.add(-1); }
+        } pending_guard{metrics.async_pending};
+
+        const uint64_t transfer = request->transfer_id;
+        StageTimings timings = request->timings;
+        timings.queue_wait = picked_at - start_time;
+        metrics.queue_wait.record(timings.queue_wait);
+        Tracer::record("async", "queue_wait", start_time, picked_at, transfer);
+
+        const auto finish = [&](bool success, std::vector<uint8_t> data, TransportError error) {
+            const auto end_time = Clock::now();
+            timings.complete = end_time - call_start(*request);
+            Tracer::record("async", "request", call_start(*request), end_time, transfer);
+            CHIMERA_PROBE4(async_complete, transfer, success, timings.queue_wait.count(), timings.complete.count());
+            AsyncResult result{
+                .success = success,
+                .data = std::move(data),
+                .latency = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time),
+                .error = error,
+                .timings = timings
+            };
+            TraceSpan callback_span("async", "callback", transfer);
+            request->callback(result);
+        };
         
         try {
             // Send the request
+            const auto sent_at = Clock::now();
             auto send_result = request->transport->send(request->dns_query);
+            timings.send = Clock::now() - sent_at;
+            metrics.send.record(timings.send);
+            Tracer::record("transport", "send", sent_at, sent_at + timings.send, transfer);
+            CHIMERA_PROBE5(transport_send, transfer, -1, request->dns_query.size(), timings.send.count(),
+                           send_result.has_value());
             if (!send_result) {
-                AsyncResult result{
-                    .success = false,
-                    .data = {},
-                    .latency = std::chrono::duration_cast<std::chrono::milliseconds>(
-                        std::chrono::steady_clock::now() - start_time),
-                    .error = send_result.error()
-                };
-                request->callback(result);
+                metrics.send_errors.inc();
+                finish(false, {}, send_result.error());
                 return;
             }
             
+            metrics.bytes_sent.inc(*send_result);
+            
             // Receive the response
+            const auto receive_start = Clock::now();
             auto recv_result = request->transport->receive();
-            auto end_time = std::chrono::steady_clock::now();
-            auto latency = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
-            
+            const auto receive_end = Clock::now();
+            Tracer::record("transport", "receive", receive_start, receive_end, transfer);
+            CHIMERA_PROBE5(transport_receive, transfer, -1, recv_result ? recv_result->size() : 0,
+                           std::chrono::nanoseconds(receive_end - sent_at).count(), recv_result.has_value());
             if (!recv_result) {
-                AsyncResult result{
-                    .success = false,
-                    .data = {},
-                    .latency = latency,
-                    .error = recv_result.error()
-                };
-                request->callback(result);
+                if (recv_result.error() == TransportError::Timeout) {
+                    metrics.timeouts.inc();
+                }
+                finish(false, {}, recv_result.error());
                 return;
             }
             
             // Success
-            AsyncResult result{
-                .success = true,
-                .data = recv_result.value(),
-                .latency = latency,
-                .error = TransportError::SocketCreationFailed  // Unused for success
-            };
-            request->callback(result);
+            const auto received_at = Clock::now();
+            timings.first_byte = received_at - call_start(*request);
+            metrics.rtt.record(received_at - sent_at);
+            finish(true, std::move(recv_result.value()),
+                   TransportError::SocketCreationFailed);  // Error unused for success
             
         } catch (const std::exception& e) {
-            AsyncResult result{
-                .success = false,
-                .data = {},
-                .latency = std::chrono::duration_cast<std::chrono::milliseconds>(
-                    std::chrono::steady_clock::now() - start_time),
-                .error = TransportError::SendFailed
-            };
-            request->callback(result);
+            finish(false, {}, TransportError::SendFailed);
         }
     }
+
+    // Stage timings are measured from the client call, which precedes submit
+    static std::chrono::steady_clock::time_point call_start(const AsyncRequest& request) {
+        return request.created_time == std::chrono::steady_clock::time_point{} ? request.start_time
+                                                                                : request.created_time;
+    }
 };
 
+namespace {
+
+std::unique_ptr<ITransport> create_transport(const ClientConfig& config) {
+    std::unique_ptr<ITransport> transport;
+    if (config.transport_factory) {
+        transport = config.transport_factory();
+    } else if (config.transport == TransportType::UDP) {
+        transport = std::make_unique<TransportUdp>(config.dns_server, config.dns_port);
+    } else if (config.transport == TransportType::DoH) {
+        transport = std::make_unique<TransportDoH>(config.dns_server, config.doh_ca_file);
+    } else if (config.transport == TransportType::DoT) {
+        transport = std::make_unique<TransportDoT>(config.dns_server, config.dns_port);
+    }
+    if (transport && config.transport_decorator) {
+        transport = config.transport_decorator(std::move(transport));
+    }
+    return transport;
+}
+
+} // namespace
+
 // AsyncIOManager implementation
 AsyncIOManager::AsyncIOManager() : impl_(std::make_unique<Impl>()) {}
 AsyncIOManager::~AsyncIOManager() = default;
@@ -232,13 +301,20 @@ size_t AsyncIOManager::pending_requests() const {
 AsyncChimeraClient::AsyncChimeraClient(ClientConfig config) : config_(std::move(config)) {}
 
 void AsyncChimeraClient::send_text_async(const std::string& message, AsyncCallback callback) {
+    const auto created_time = std::chrono::steady_clock::now();
+    const uint64_t transfer = Tracer::next_transfer_id();
+    StageTimings timings;
+
     // Apply behavioral mimicry
     if (config_.adaptive_transport) {
         BehavioralMimicry mimicry(config_.behavioral_profile);
         mimicry.apply_behavioral_delay();
+        timings.mimicry_delay = std::chrono::steady_clock::now() - created_time;
+        Tracer::record("mimicry", "behavioral_delay", created_time, created_time + timings.mimicry_delay, transfer);
     }
     
     // Create DNS query
+    const auto encode_start = std::chrono::steady_clock::now();
     std::string encoded_message;
     try {
         encoded_message = Base64::encode(message);
@@ -278,16 +354,11 @@ void AsyncChimeraClient::send_text_async(const std::string& message, AsyncCallba
         callback(result);
         return;
     }
+    timings.encode = std::chrono::steady_clock::now() - encode_start;
+    Tracer::record("encode", "encode", encode_start, encode_start + timings.encode, transfer);
     
     // Create transport
-    std::unique_ptr<ITransport> transport;
-    if (config_.transport == TransportType::UDP) {
-        transport = std::make_unique<TransportUdp>(config_.dns_server, config_.dns_port);
-    } else if (config_.transport == TransportType::DoH) {
-        transport = std::make_unique<TransportDoH>(config_.dns_server);
-    } else if (config_.transport == TransportType::DoT) {
-        transport = std::make_unique<TransportDoT>(config_.dns_server, config_.dns_port);
-    }
+    auto transport = create_transport(config_);
     
     if (!transport) {
         AsyncResult result{
@@ -308,6 +379,9 @@ void AsyncChimeraClient::send_text_async(const std::string& message, AsyncCallba
     request->transport = std::move(transport);
     request->callback = callback;
     request->timeout = config_.timeout;
+    request->created_time = created_time;
+    request->timings = timings;
+    request->transfer_id = transfer;
     
     io_manager_.submit_request(std::move(request));
 }
@@ -324,6 +398,8 @@ std::future<AsyncResult> AsyncChimeraClient::send_text_future(const std::string&
 }
 
 void AsyncChimeraClient::ping_async(AsyncCallback callback) {
+    const auto created_time = std::chrono::steady_clock::now();
+    const uint64_t transfer = Tracer::next_transfer_id();
     DnsQuestion ping_question{"ping.test", DnsType::A};
     std::vector<uint8_t> packet;
     try {
@@ -340,14 +416,7 @@ void AsyncChimeraClient::ping_async(AsyncCallback callback) {
     }
     
     // Create transport
-    std::unique_ptr<ITransport> transport;
-    if (config_.transport == TransportType::UDP) {
-        transport = std::make_unique<TransportUdp>(config_.dns_server, config_.dns_port);
-    } else if (config_.transport == TransportType::DoH) {
-        transport = std::make_unique<TransportDoH>(config_.dns_server);
-    } else if (config_.transport == TransportType::DoT) {
-        transport = std::make_unique<TransportDoT>(config_.dns_server, config_.dns_port);
-    }
+    auto transport = create_transport(config_);
     
     if (!transport) {
         AsyncResult result{
@@ -367,6 +436,8 @@ void AsyncChimeraClient::ping_async(AsyncCallback callback) {
     request->transport = std::move(transport);
     request->callback = callback;
     request->timeout = config_.timeout;
+    request->created_time = created_time;
+    request->transfer_id = transfer;
     
     io_manager_.submit_request(std::move(request));
 }
@@ -1,4 +1,5 @@
 #include "chimera/Transport.hpp"
+#include "chimera/metrics.hpp"
 #include <curl/curl.h>
 #include <openssl/ssl.h>
 #include <openssl/err.h>
@@ -68,6 +69,9 @@ tl::expected<std::vector<uint8_t>, TransportError> TransportDoH::perform_https_r
     curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
     curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 1L);
     curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 2L);
+    if (!ca_file_.empty()) {
+        curl_easy_setopt(curl, CURLOPT_CAINFO, ca_file_.c_str());
+    }
 
     CURLcode res = curl_easy_perform(curl);
     
@@ -112,10 +116,14 @@ TransportDoT::~TransportDoT() {
 
 tl::expected<size_t, TransportError> TransportDoT::send(const std::vector<uint8_t>& data) {
     if (!ssl_) {
+        if (connected_) {
+            PipelineMetrics::get().retries.inc();
+        }
         auto conn_result = establish_tls_connection();
         if (!conn_result) {
             return tl::unexpected(conn_result.error());
         }
+        connected_ = true;
     }
 
     // DNS-over-TLS uses a 2-byte length prefix
@@ -4,15 +4,68 @@
 #include "chimera/Transport.hpp"
 #include "chimera/BehavioralMimicry.hpp"
 #include "chimera/steganography.hpp"
-#include <iostream>
+#include "chimera/crypto.hpp"
+#include "chimera/worker_pool.hpp"
+#include "chimera/metrics.hpp"
+#include "chimera/tracing.hpp"
+#include "chimera/probes.hpp"
+#include "chimera/logging.hpp"
 #include <random>
 #include <thread>
 #include <fstream>
 
 namespace chimera {
 
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Sends one query, recording its duration, size and failure; the duration is
+// added to `elapsed`
+tl::expected<size_t, TransportError> timed_send(ITransport& transport, const std::vector<uint8_t>& packet,
+                                                std::chrono::nanoseconds& elapsed,
+                                                uint64_t transfer = 0, int64_t fragment = -1) {
+    auto& metrics = PipelineMetrics::get();
+    const auto start = Clock::now();
+    auto sent = transport.send(packet);
+    const auto end = Clock::now();
+    Tracer::record("transport", "send", start, end, transfer, fragment);
+    const auto duration = end - start;
+    elapsed += duration;
+    metrics.send.record(duration);
+    CHIMERA_PROBE5(transport_send, transfer, fragment, packet.size(),
+                   std::chrono::nanoseconds(duration).count(), sent.has_value());
+    if (sent) {
+        metrics.bytes_sent.inc(*sent);
+    } else {
+        metrics.send_errors.inc();
+    }
+    return sent;
+}
+
+// Waits for the answer to a query sent at `sent_at`, recording RTT or timeout
+tl::expected<std::vector<uint8_t>, TransportError> timed_receive(ITransport& transport, Clock::time_point sent_at,
+                                                                 uint64_t transfer = 0, int64_t fragment = -1) {
+    auto& metrics = PipelineMetrics::get();
+    TraceSpan span("transport", "receive", transfer, fragment);
+    auto response = transport.receive();
+    CHIMERA_PROBE5(transport_receive, transfer, fragment, response ? response->size() : 0,
+                   std::chrono::nanoseconds(Clock::now() - sent_at).count(), response.has_value());
+    if (response) {
+        metrics.rtt.record(Clock::now() - sent_at);
+    } else if (response.error() == TransportError::Timeout) {
+        metrics.timeouts.inc();
+    }
+    return response;
+}
+
+} // namespace
+
 tl::expected<SendResult, ChimeraError> ChimeraClient::send_text(const std::string& message) const {
-    auto start_time = std::chrono::steady_clock::now();
+    auto start_time = Clock::now();
+    StageTimings timings;
+    const uint64_t transfer = Tracer::next_transfer_id();
+    TraceSpan transfer_span("client", "send_text", transfer);
 
     // Create appropriate transport
     auto transport = create_transport();
@@ -25,10 +78,14 @@ tl::expected<SendResult, ChimeraError> ChimeraClient::send_text(const std::strin
     // Behavioral mimicry: add random delay if enabled
     if (config_.adaptive_transport) {
         BehavioralMimicry mimicry(config_.behavioral_profile);
+        const auto delay_start = Clock::now();
         mimicry.apply_behavioral_delay();
+        timings.mimicry_delay = Clock::now() - delay_start;
+        Tracer::record("mimicry", "behavioral_delay", delay_start, delay_start + timings.mimicry_delay, transfer);
         
-        // Potentially switch transport based on behavioral patterns
-        if (mimicry.should_switch_transport()) {
+        // Potentially switch transport based on behavioral patterns; a custom
+        // transport factory (loopback, test doubles) stays in place
+        if (!config_.transport_factory && mimicry.should_switch_transport()) {
             AdaptiveTransportManager transport_manager;
             auto recommended = mimicry.get_recommended_transport();
             // Use recommended transport for this request
@@ -38,13 +95,17 @@ tl::expected<SendResult, ChimeraError> ChimeraClient::send_text(const std::strin
                     alt_transport = std::make_unique<TransportUdp>(config_.dns_server, config_.dns_port);
                     break;
                 case TransportType::DoH:
-                    alt_transport = std::make_unique<TransportDoH>(config_.dns_server);
+                    alt_transport = std::make_unique<TransportDoH>(config_.dns_server, config_.doh_ca_file);
                     break;
                 case TransportType::DoT:
                     alt_transport = std::make_unique<TransportDoT>(config_.dns_server, config_.dns_port);
                     break;
             }
             if (alt_transport) {
+                PipelineMetrics::get().retries.inc();
+                if (config_.transport_decorator) {
+                    alt_transport = config_.transport_decorator(std::move(alt_transport));
+                }
                 transport = std::move(alt_transport);
                 transport->set_timeout(config_.timeout);
             }
@@ -52,11 +113,12 @@ tl::expected<SendResult, ChimeraError> ChimeraClient::send_text(const std::strin
     }
 
     // Base64 encoding
+    const auto encode_start = Clock::now();
     std::string encoded_message;
     try {
         encoded_message = Base64::encode(message);
     } catch (const std::exception& e) {
-        std::cerr << "Base64 encoding error: " << e.what() << std::endl;
+        CHIMERA_LOG_ERROR("Base64 encoding error: {}", e.what());
         return tl::unexpected(ChimeraError::EncodingError);
     }
 
@@ -71,27 +133,30 @@ tl::expected<SendResult, ChimeraError> ChimeraClient::send_text(const std::strin
     try {
         packet = DnsPacketBuilder::build_query(question, encoded_message);
     } catch (const std::exception& e) {
-        std::cerr << "DNS packet building error: " << e.what() << std::endl;
+        CHIMERA_LOG_ERROR("DNS packet building error: {}", e.what());
         return tl::unexpected(ChimeraError::DnsError);
     }
+    timings.encode = Clock::now() - encode_start;
+    Tracer::record("encode", "encode", encode_start, encode_start + timings.encode, transfer);
 
-    auto send_result = transport->send(packet);
+    auto send_result = timed_send(*transport, packet, timings.send, transfer);
     if (!send_result) {
-        std::cerr << "Send error" << std::endl;
+        CHIMERA_LOG_ERROR("Send error");
         return tl::unexpected(ChimeraError::NetworkError);
     }
 
-    auto end_time = std::chrono::steady_clock::now();
+    auto end_time = Clock::now();
+    timings.complete = end_time - start_time;
     auto latency = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
 
-    std::cout << "Sent bytes: " << send_result.value() << std::endl;
-    std::cout << "Used domain: " << target_domain << std::endl;
-    std::cout << "Latency: " << latency.count() << " ms" << std::endl;
+    CHIMERA_LOG_DEBUG("Sent bytes: {}, used domain: {}, latency: {} ms",
+                      send_result.value(), target_domain, latency.count());
 
     return SendResult{
         .bytes_sent = send_result.value(),
         .latency = latency,
-        .used_domain = target_domain
+        .used_domain = target_domain,
+        .timings = timings
     };
 }
 
@@ -110,19 +175,21 @@ tl::expected<std::chrono::milliseconds, ChimeraError> ChimeraClient::ping_dns_se
     try {
         packet = DnsPacketBuilder::build_query(ping_question);
     } catch (const std::exception& e) {
-        std::cerr << "DNS packet building error for ping: " << e.what() << std::endl;
+        CHIMERA_LOG_ERROR("DNS packet building error for ping: {}", e.what());
         return tl::unexpected(ChimeraError::DnsError);
     }
 
-    auto send_result = transport->send(packet);
+    const auto sent_at = Clock::now();
+    std::chrono::nanoseconds send_time{0};
+    auto send_result = timed_send(*transport, packet, send_time);
     if (!send_result) {
-        std::cerr << "Ping send error" << std::endl;
+        CHIMERA_LOG_ERROR("Ping send error");
         return tl::unexpected(ChimeraError::NetworkError);
     }
 
-    auto recv_result = transport->receive();
+    auto recv_result = timed_receive(*transport, sent_at);
     if (!recv_result) {
-        std::cerr << "Ping receive error" << std::endl;
+        CHIMERA_LOG_ERROR("Ping receive error");
         return tl::unexpected(ChimeraError::NetworkError);
     }
 
@@ -131,15 +198,14 @@ tl::expected<std::chrono::milliseconds, ChimeraError> ChimeraClient::ping_dns_se
     try {
         DnsPacketBuilder::parse_response(recv_result.value(), answers);
     } catch (const std::exception& e) {
-        std::cerr << "DNS response parsing error: " << e.what() << std::endl;
+        CHIMERA_LOG_WARN("DNS response parsing error: {}", e.what());
     }
 
     const auto end_time = std::chrono::steady_clock::now();
     auto latency = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
 
-    std::cout << "Ping response size: " << recv_result.value().size() << " bytes" << std::endl;
-    std::cout << "Answer count: " << answers.size() << std::endl;
-    std::cout << "Ping latency: " << latency.count() << " ms" << std::endl;
+    CHIMERA_LOG_DEBUG("Ping response: {} bytes, {} answers, latency: {} ms",
+                      recv_result.value().size(), answers.size(), latency.count());
 
     return latency;
 }
@@ -159,21 +225,39 @@ std::string ChimeraClient::generate_random_subdomain() {
 }
 
 std::unique_ptr<ITransport> ChimeraClient::create_transport() const {
+    std::unique_ptr<ITransport> transport;
+    if (config_.transport_factory) {
+        transport = config_.transport_factory();
+        if (transport && config_.transport_decorator) {
+            transport = config_.transport_decorator(std::move(transport));
+        }
+        return transport;
+    }
     switch (config_.transport) {
         case TransportType::UDP:
-            return std::make_unique<TransportUdp>(config_.dns_server, config_.dns_port);
+            transport = std::make_unique<TransportUdp>(config_.dns_server, config_.dns_port);
+            break;
         case TransportType::DoH:
-            return std::make_unique<TransportDoH>(config_.dns_server);
+            transport = std::make_unique<TransportDoH>(config_.dns_server, config_.doh_ca_file);
+            break;
         case TransportType::DoT:
-            return std::make_unique<TransportDoT>(config_.dns_server, config_.dns_port);
+            transport = std::make_unique<TransportDoT>(config_.dns_server, config_.dns_port);
+            break;
         default:
             return nullptr;
     }
+    if (config_.transport_decorator) {
+        transport = config_.transport_decorator(std::move(transport));
+    }
+    return transport;
 }
 
 // Phase 3: Enhanced steganographic sending methods
 tl::expected<SendResult, ChimeraError> ChimeraClient::send_data(const std::vector<uint8_t>& data) const {
-    auto start_time = std::chrono::steady_clock::now();
+    auto start_time = Clock::now();
+    StageTimings timings;
+    const uint64_t transfer = Tracer::next_transfer_id();
+    TraceSpan transfer_span("client", "send_data", transfer);
 
     // Create steganographic encoder with client configuration
     EncodingConfig encoding_config;
@@ -182,11 +266,33 @@ tl::expected<SendResult, ChimeraError> ChimeraClient::send_data(const std::vecto
     encoding_config.randomize_order = config_.randomize_fragments;
     encoding_config.noise_ratio = config_.noise_ratio;
     encoding_config.max_fragments = config_.max_fragments;
+    encoding_config.max_txt_length = config_.max_txt_length;
 
     SteganographicEncoder encoder(encoding_config);
 
+    // Seal the payload with the session before encoding; nonces are implicit
+    // in the session's send counter, so only the transfer's first sequence and
+    // a tag per segment are added, and large payloads are sealed in parallel
+    auto& metrics = PipelineMetrics::get();
+    std::vector<uint8_t> sealed;
+    if (session_) {
+        const auto crypto_start = Clock::now();
+        const auto sealed_ok = session_->seal_transfer(data, sealed, &WorkerPool::shared());
+        timings.crypto = Clock::now() - crypto_start;
+        metrics.crypto.record(timings.crypto);
+        Tracer::record("crypto", "seal", crypto_start, crypto_start + timings.crypto, transfer);
+        if (!sealed_ok) {
+            return tl::unexpected(ChimeraError::CryptoError);
+        }
+    }
+    const auto& payload = session_ ? sealed : data;
+
     // Encode the data into fragments
-    auto fragments_result = encoder.encode_payload(data, config_.target_domain);
+    const auto encode_start = Clock::now();
+    auto fragments_result = encoder.encode_payload(payload, config_.target_domain, &timings.compress);
+    timings.encode = Clock::now() - encode_start;
+    metrics.encode.record(timings.encode);
+    Tracer::record("encode", "encode_payload", encode_start, encode_start + timings.encode, transfer);
     if (!fragments_result) {
         return tl::unexpected(ChimeraError::EncodingError);
     }
@@ -204,12 +310,20 @@ tl::expected<SendResult, ChimeraError> ChimeraClient::send_data(const std::vecto
     // Apply behavioral mimicry if enabled
     if (config_.adaptive_transport) {
         BehavioralMimicry mimicry(config_.behavioral_profile);
+        const auto delay_start = Clock::now();
         mimicry.apply_behavioral_delay();
+        const auto delay_end = Clock::now();
+        timings.mimicry_delay += delay_end - delay_start;
+        Tracer::record("mimicry", "behavioral_delay", delay_start, delay_end, transfer);
     }
 
     // Send each fragment
     size_t total_bytes_sent = 0;
     std::vector<DnsType> used_record_types;
+    std::vector<FragmentTiming> fragment_timings;
+    if (config_.collect_fragment_timings) {
+        fragment_timings.reserve(fragments.size());
+    }
     
     for (const auto& fragment : fragments) {
         // Create DNS query based on fragment type
@@ -220,20 +334,45 @@ tl::expected<SendResult, ChimeraError> ChimeraClient::send_data(const std::vecto
 
         // Build and send the query
         auto packet = DnsPacketBuilder::build_query(question);
-        auto send_result = transport->send(packet);
+        const auto sent_at = Clock::now();
+        std::chrono::nanoseconds send_time{0};
+        auto send_result = timed_send(*transport, packet, send_time, transfer, fragment.fragment_id);
+        timings.send += send_time;
         
         if (!send_result) {
             return tl::unexpected(ChimeraError::NetworkError);
         }
+        metrics.fragments_sent.inc();
+
+        // Diagnostics mode: wait for this fragment's answer before the next query
+        if (config_.collect_fragment_timings) {
+            FragmentTiming sample{fragment.fragment_id, fragment.record_type, send_time};
+            if (timed_receive(*transport, sent_at, transfer, fragment.fragment_id)) {
+                const auto answered_at = Clock::now();
+                sample.rtt = answered_at - sent_at;
+                sample.answered = true;
+                if (timings.first_byte.count() == 0) {
+                    timings.first_byte = answered_at - start_time;
+                }
+            }
+            fragment_timings.push_back(sample);
+        }
 
         total_bytes_sent += fragment.encoded_data.size();
         used_record_types.push_back(fragment.record_type);
 
         // Small delay between fragments for stealth
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        if (config_.fragment_delay.count() > 0) {
+            const auto delay_start = Clock::now();
+            std::this_thread::sleep_for(config_.fragment_delay);
+            const auto delay_end = Clock::now();
+            timings.mimicry_delay += delay_end - delay_start;
+            Tracer::record("mimicry", "fragment_delay", delay_start, delay_end, transfer, fragment.fragment_id);
+        }
     }
 
-    auto end_time = std::chrono::steady_clock::now();
+    auto end_time = Clock::now();
+    timings.complete = end_time - start_time;
     auto latency = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
 
     SendResult result;
@@ -244,6 +383,8 @@ tl::expected<SendResult, ChimeraError> ChimeraClient::send_data(const std::vecto
     result.fragments_sent = fragments.size();
     result.encoding_used = config_.encoding_strategy;
     result.compression_used = config_.use_compression;
+    result.timings = timings;
+    result.fragment_timings = std::move(fragment_timings);
 
     return result;
 }
@@ -279,6 +420,9 @@ tl::expected<SendResult, ChimeraError> ChimeraClient::send_multi_record(const st
 }
 
 tl::expected<std::vector<uint8_t>, ChimeraError> ChimeraClient::receive_data(const std::string& query_domain) const {
+    const uint64_t transfer = Tracer::next_transfer_id();
+    TraceSpan transfer_span("client", "receive_data", transfer);
+
     // Create transport
     auto transport = create_transport();
     if (!transport) {
@@ -292,17 +436,21 @@ tl::expected<std::vector<uint8_t>, ChimeraError> ChimeraClient::receive_data(con
     
     std::vector<DnsType> query_types = {DnsType::A, DnsType::AAAA, DnsType::TXT};
     
-    for (auto record_type : query_types) {
+    for (size_t query_index = 0; query_index < query_types.size(); ++query_index) {
+        const auto record_type = query_types[query_index];
+        const auto query_id = static_cast<int64_t>(query_index);
         DnsQuestion question;
         question.name = query_domain;
         question.type = record_type;
         question.cls = DnsClass::IN;
 
         auto packet = DnsPacketBuilder::build_query(question);
-        auto response = transport->send(packet);
+        const auto sent_at = Clock::now();
+        std::chrono::nanoseconds send_time{0};
+        auto response = timed_send(*transport, packet, send_time, transfer, query_id);
         
         if (response) {
-            auto receive_result = transport->receive();
+            auto receive_result = timed_receive(*transport, sent_at, transfer, query_id);
             if (receive_result) {
                 std::vector<DnsResourceRecord> records;
                 DnsPacketBuilder::parse_response(receive_result.value(), records);
@@ -312,11 +460,21 @@ tl::expected<std::vector<uint8_t>, ChimeraError> ChimeraClient::receive_data(con
     }
 
     // Extract steganographic data from responses
+    TraceSpan reassembly_span("decode", "reassembly", transfer);
     auto extracted = SteganographicExtractor::extract_from_dns_response(all_records);
     if (!extracted) {
         return tl::unexpected(ChimeraError::DecodingError);
     }
 
+    if (session_) {
+        std::vector<uint8_t> opened;
+        // Opens by the carried sequence, so an earlier lost or failed transfer does not matter
+        if (!session_->open_transfer(extracted.value(), opened, &WorkerPool::shared())) {
+            return tl::unexpected(ChimeraError::CryptoError);
+        }
+        return opened;
+    }
+
     return extracted.value();
 }
 
@@ -324,6 +482,7 @@ size_t ChimeraClient::estimate_capacity() const {
     EncodingConfig encoding_config;
     encoding_config.strategy = config_.encoding_strategy;
     encoding_config.max_fragments = config_.max_fragments;
+    encoding_config.max_txt_length = config_.max_txt_length;
     
     return SteganographicEncoder::estimate_total_capacity(encoding_config);
 }
@@ -1,4 +1,9 @@
 #include "chimera/config_wizard.hpp"
+#include "chimera/Transport.hpp"
+#include "chimera/dns_packet.hpp"
+#include "chimera/steganography.hpp"
+#include <algorithm>
+#include <future>
 #include <iostream>
 #include <iomanip>
 #include <sstream>
@@ -9,6 +14,106 @@
 
 namespace chimera {
 
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr auto ENCODER_MEASURE_TIME = std::chrono::milliseconds(20);
+constexpr auto MIN_TIMEOUT = std::chrono::milliseconds(250);
+constexpr auto MAX_TIMEOUT = std::chrono::milliseconds(10000);
+
+// Same construction as ChimeraClient, for a config carrying the candidate
+std::unique_ptr<ITransport> makeTransport(const ClientConfig& config) {
+    std::unique_ptr<ITransport> transport;
+    if (config.transport_factory) {
+        transport = config.transport_factory();
+    } else if (config.transport == TransportType::UDP) {
+        transport = std::make_unique<TransportUdp>(config.dns_server, config.dns_port);
+    } else if (config.transport == TransportType::DoH) {
+        transport = std::make_unique<TransportDoH>(config.dns_server, config.doh_ca_file);
+    } else {
+        transport = std::make_unique<TransportDoT>(config.dns_server, config.dns_port);
+    }
+    if (transport && config.transport_decorator) {
+        transport = config.transport_decorator(std::move(transport));
+    }
+    return transport;
+}
+
+// Waits for the response echoing the query id, skipping strays, until the deadline
+bool awaitAnswer(ITransport& transport, const std::vector<uint8_t>& query, Clock::time_point deadline) {
+    for (;;) {
+        const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now());
+        if (remaining.count() <= 0) {
+            return false;
+        }
+        transport.set_timeout(remaining);
+        auto response = transport.receive();
+        if (!response) {
+            return false;
+        }
+        if (response->size() >= 12 && (*response)[0] == query[0] && (*response)[1] == query[1]) {
+            return true;
+        }
+    }
+}
+
+struct EncoderSample {
+    size_t fragments = 0;
+    double mb_per_s = 0.0;
+};
+
+EncoderSample measureEncoder(const EncodingConfig& config, const std::vector<uint8_t>& sample,
+                             const std::string& domain) {
+    SteganographicEncoder encoder(config);
+    EncoderSample result;
+    size_t runs = 0;
+    const auto start = Clock::now();
+    auto elapsed = Clock::duration::zero();
+    while (runs < 3 || elapsed < ENCODER_MEASURE_TIME) {
+        auto fragments = encoder.encode_payload(sample, domain);
+        if (!fragments) {
+            return {};
+        }
+        result.fragments = fragments->size();
+        ++runs;
+        elapsed = Clock::now() - start;
+    }
+    result.mb_per_s = sample.size() * runs / std::chrono::duration<double>(elapsed).count() / 1e6;
+    return result;
+}
+
+// Compressible text-like payload, closer to real tunnel traffic than random bytes
+std::vector<uint8_t> defaultSample() {
+    static const std::string words = "chimera dns tunnel payload fragment record query response ";
+    std::vector<uint8_t> data(4096);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(words[(i * 7 + i / words.size()) % words.size()]);
+    }
+    return data;
+}
+
+// Seconds to deliver the sample through one candidate. Queries are modelled
+// one at a time, as send_data with collect_fragment_timings or receive_data
+// run them. Goodput takes the mean: a lost query is retried, so each costs
+// rtt / (1 - loss). Latency takes the tail: the slowest answer, and each
+// expected loss waits out the timeout first.
+double deliveryTime(const CandidateMeasurement& candidate, TuneGoal goal, size_t fragments, double encode_mb_per_s,
+                    size_t sample_bytes, std::chrono::milliseconds fragment_delay, std::chrono::milliseconds timeout) {
+    const double encode = encode_mb_per_s > 0.0 ? sample_bytes / (encode_mb_per_s * 1e6) : 0.0;
+    const double loss = std::min(candidate.loss, 0.99);
+    double per_query = 0.0;
+    if (goal == TuneGoal::Goodput) {
+        per_query = std::chrono::duration<double>(candidate.rtt_median).count() / (1.0 - loss);
+    } else {
+        per_query = std::chrono::duration<double>(candidate.rtt_max).count() +
+                    loss / (1.0 - loss) * std::chrono::duration<double>(timeout).count();
+    }
+    return encode + fragments * (per_query + std::chrono::duration<double>(fragment_delay).count());
+}
+
+} // namespace
+
 ConfigWizard::ConfigWizard() {
     initializeValidationRules();
 }
@@ -121,7 +226,7 @@ ClientConfig ConfigWizard::runInteractiveSetup() {
 
     // Encoding Strategy with Risk Assessment
     std::vector<std::pair<EncodingStrategy, std::string>> encoding_options = {
-        {EncodingStrategy::SINGLE_RECORD, "Single Record (Lower Capacity, More Subtle)"},
+        {EncodingStrategy::TXT_ONLY, "TXT Only (Lower Capacity, More Subtle)"},
         {EncodingStrategy::MULTI_RECORD, "Multi-Record (Higher Capacity, More Complex)"}
     };
 
@@ -199,10 +304,191 @@ std::string ConfigWizard::transportToString(TransportType type) {
 
 std::string ConfigWizard::encodingToString(EncodingStrategy strategy) {
     switch (strategy) {
-        case EncodingStrategy::SINGLE_RECORD: return "Single record";
+        case EncodingStrategy::TXT_ONLY: return "TXT only";
         case EncodingStrategy::MULTI_RECORD: return "Multi record";
+        case EncodingStrategy::DISTRIBUTED: return "Distributed";
+        case EncodingStrategy::HTTP2_BODY: return "HTTP/2 body";
     }
     return "Unknown";
 }
 
-}  // namespace chimera
\ No newline at end of file
+CandidateMeasurement ConfigWizard::probeCandidate(const ClientConfig& base, const TuneCandidate& candidate,
+                                                  const AutoTuneOptions& options) {
+    CandidateMeasurement measurement;
+    measurement.label = candidate.label;
+
+    ClientConfig config = base;
+    config.transport = candidate.transport;
+    config.dns_server = candidate.dns_server;
+    config.dns_port = candidate.dns_port;
+    config.doh_ca_file = candidate.doh_ca_file;
+    config.transport_factory = candidate.transport_factory;
+    auto transport = makeTransport(config);
+    if (!transport) {
+        return measurement;
+    }
+
+    std::vector<int64_t> rtts;
+    // Query 0 warms up connections (TCP/TLS handshakes) and is not counted
+    for (size_t i = 0; i <= options.probes_per_candidate; ++i) {
+        std::vector<uint8_t> query;
+        try {
+            query = DnsPacketBuilder::build_query(
+                DnsQuestion{"tune" + std::to_string(i) + "." + base.target_domain, DnsType::A});
+        } catch (const std::exception&) {
+            return measurement;
+        }
+        const auto start = Clock::now();
+        const bool answered = transport->send(query).has_value() &&
+                              awaitAnswer(*transport, query, start + options.probe_timeout);
+        if (i == 0) {
+            continue;
+        }
+        ++measurement.probes;
+        if (answered) {
+            rtts.push_back(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count());
+        }
+    }
+
+    measurement.answered = rtts.size();
+    if (measurement.probes > 0) {
+        measurement.loss = 1.0 - static_cast<double>(measurement.answered) / measurement.probes;
+    }
+    if (!rtts.empty()) {
+        std::sort(rtts.begin(), rtts.end());
+        measurement.rtt_median = std::chrono::microseconds(rtts[rtts.size() / 2]);
+        measurement.rtt_max = std::chrono::microseconds(rtts.back());
+    }
+    return measurement;
+}
+
+AutoTuneResult ConfigWizard::runAutoTune(const ClientConfig& base, const AutoTuneOptions& options) {
+    AutoTuneResult result{base, {}};
+    AutoTuneReport& report = result.report;
+
+    std::vector<TuneCandidate> candidates = options.candidates;
+    if (candidates.empty()) {
+        candidates.push_back({base.transport, base.dns_server, base.dns_port, base.doh_ca_file,
+                              base.transport_factory, ""});
+    }
+    for (auto& candidate : candidates) {
+        if (candidate.label.empty()) {
+            candidate.label = candidate.transport_factory
+                ? "custom transport"
+                : transportToString(candidate.transport) + " " + candidate.dns_server + ":" +
+                      std::to_string(candidate.dns_port);
+        }
+    }
+
+    // Candidates are independent network paths: probe them side by side
+    std::vector<std::future<CandidateMeasurement>> probes;
+    for (const auto& candidate : candidates) {
+        probes.push_back(std::async(std::launch::async, [&base, &options, candidate] {
+            return probeCandidate(base, candidate, options);
+        }));
+    }
+
+    const std::vector<uint8_t> sample = options.sample_payload.empty() ? defaultSample() : options.sample_payload;
+    EncodingConfig encoding;
+    encoding.strategy = base.encoding_strategy;
+    encoding.max_txt_length = base.max_txt_length;
+    encoding.randomize_order = base.randomize_fragments;
+    encoding.noise_ratio = base.noise_ratio;
+    encoding.max_fragments = std::numeric_limits<uint32_t>::max();   // Count what the sample needs
+    encoding.use_compression = false;
+    const EncoderSample raw = measureEncoder(encoding, sample, base.target_domain);
+    encoding.use_compression = true;
+    const EncoderSample compressed = measureEncoder(encoding, sample, base.target_domain);
+
+    report.sample_bytes = sample.size();
+    if (!sample.empty()) {
+        report.compression_ratio =
+            static_cast<double>(SteganographicEncoder(encoding).compress_payload(sample).size()) / sample.size();
+    }
+    report.encode_mb_per_s = raw.mb_per_s;
+    report.encode_compressed_mb_per_s = compressed.mb_per_s;
+    report.fragments = raw.fragments;
+    report.fragments_compressed = compressed.fragments;
+
+    for (auto& probe : probes) {
+        report.candidates.push_back(probe.get());
+    }
+
+    // Score every candidate with its better compression setting
+    report.chosen = report.candidates.size();
+    double best_time = 0.0;
+    for (size_t i = 0; i < report.candidates.size(); ++i) {
+        auto& candidate = report.candidates[i];
+        if (candidate.answered == 0) {
+            continue;
+        }
+        const auto timeout = std::clamp(
+            std::chrono::ceil<std::chrono::milliseconds>(candidate.rtt_max * 4), MIN_TIMEOUT, MAX_TIMEOUT);
+        const double raw_time = deliveryTime(candidate, options.goal, raw.fragments, raw.mb_per_s,
+                                             sample.size(), base.fragment_delay, timeout);
+        const double compressed_time = deliveryTime(candidate, options.goal, compressed.fragments,
+                                                    compressed.mb_per_s, sample.size(), base.fragment_delay, timeout);
+        const bool compress = compressed.fragments > 0 && compressed_time < raw_time;
+        const double time = compress ? compressed_time : raw_time;
+        candidate.score = time > 0.0 ? (options.goal == TuneGoal::Goodput ? sample.size() / time : 1.0 / time) : 0.0;
+
+        if (report.chosen == report.candidates.size() || time < best_time) {
+            report.chosen = i;
+            best_time = time;
+            report.use_compression = compress;
+            report.timeout = timeout;
+        }
+    }
+
+    ClientConfig& config = result.config;
+    if (report.chosen < report.candidates.size()) {
+        const TuneCandidate& chosen = candidates[report.chosen];
+        config.transport = chosen.transport;
+        config.dns_server = chosen.dns_server;
+        config.dns_port = chosen.dns_port;
+        config.doh_ca_file = chosen.doh_ca_file;
+        config.transport_factory = chosen.transport_factory;
+        config.use_compression = report.use_compression;
+        config.timeout = report.timeout;
+        report.predicted_goodput = best_time > 0.0 ? sample.size() / best_time : 0.0;
+        report.predicted_latency = std::chrono::ceil<std::chrono::milliseconds>(std::chrono::duration<double>(best_time));
+    } else {
+        report.use_compression = config.use_compression;
+        report.timeout = config.timeout;
+    }
+    // Never cap below what the sample needs: the encoder drops what does not fit
+    const size_t needed = report.use_compression ? report.fragments_compressed : report.fragments;
+    config.max_fragments = std::max(config.max_fragments, needed);
+    report.max_fragments = config.max_fragments;
+    return result;
+}
+
+std::string AutoTuneReport::summary() const {
+    std::ostringstream out;
+    out << std::fixed;
+    out << "Auto-tune measurements\n";
+    out << "  " << std::left << std::setw(28) << "candidate" << std::right << std::setw(8) << "answered"
+        << std::setw(8) << "loss" << std::setw(12) << "rtt median" << std::setw(12) << "rtt max" << "\n";
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        const auto& candidate = candidates[i];
+        out << (i == chosen ? "* " : "  ") << std::left << std::setw(28) << candidate.label << std::right
+            << std::setw(4) << candidate.answered << "/" << std::setw(3) << std::left << candidate.probes << std::right
+            << std::setw(7) << std::setprecision(1) << candidate.loss * 100.0 << "%"
+            << std::setw(9) << std::setprecision(2) << candidate.rtt_median.count() / 1000.0 << " ms"
+            << std::setw(9) << candidate.rtt_max.count() / 1000.0 << " ms\n";
+    }
+    out << "Sample " << sample_bytes << " B: compression ratio " << std::setprecision(2) << compression_ratio
+        << ", encoder " << std::setprecision(1) << encode_mb_per_s << " MB/s raw / " << encode_compressed_mb_per_s
+        << " MB/s compressed, " << fragments << " / " << fragments_compressed << " queries\n";
+    if (chosen >= candidates.size()) {
+        out << "No candidate answered; transport and timeout left unchanged\n";
+    } else {
+        out << "Chosen: " << candidates[chosen].label << ", compression " << (use_compression ? "on" : "off")
+            << ", timeout " << timeout.count() << " ms, predicted " << std::setprecision(1)
+            << predicted_goodput / 1024.0 << " KiB/s, " << predicted_latency.count() << " ms per sample\n";
+    }
+    out << "max_fragments " << max_fragments << "\n";
+    return out.str();
+}
+
+}  // namespace chimera
@@ -1,16 +1,149 @@
 #include "chimera/crypto.hpp"
+#include "chimera/worker_pool.hpp"
+#include "chimera/probes.hpp"
+#include "chimera/logging.hpp"
 #include <sodium.h>
 #include <oqs/oqs.h>
-#include <iostream>
 #include <cstring>
-
-// Production ML-KEM768 implementation with liboqs
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <atomic>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+
+// Production ML-KEM implementation with liboqs
 namespace chimera {
 
+namespace {
+
+// libsodium and liboqs only need to be initialized once per process
+bool ensure_crypto_initialized() {
+    static const bool initialized = []() {
+        if (sodium_init() < 0) {
+            return false;
+        }
+        OQS_init();
+        return true;
+    }();
+    return initialized;
+}
+
+struct KemDeleter {
+    void operator()(OQS_KEM* kem) const { OQS_KEM_free(kem); }
+};
+
+// liboqs method name for a parameter set; nullptr when this liboqs lacks it.
+// There is deliberately no fallback between ML-KEM and Kyber
+const char* kem_method_name(KemAlgorithm kem) {
+    const char* name = nullptr;
+    switch (kem) {
+#ifdef OQS_KEM_alg_ml_kem_512
+        case KemAlgorithm::MLKEM512: name = OQS_KEM_alg_ml_kem_512; break;
+#endif
+#ifdef OQS_KEM_alg_ml_kem_768
+        case KemAlgorithm::MLKEM768: name = OQS_KEM_alg_ml_kem_768; break;
+#endif
+#ifdef OQS_KEM_alg_ml_kem_1024
+        case KemAlgorithm::MLKEM1024: name = OQS_KEM_alg_ml_kem_1024; break;
+#endif
+#ifdef OQS_KEM_alg_kyber_512
+        case KemAlgorithm::Kyber512: name = OQS_KEM_alg_kyber_512; break;
+#endif
+#ifdef OQS_KEM_alg_kyber_768
+        case KemAlgorithm::Kyber768: name = OQS_KEM_alg_kyber_768; break;
+#endif
+#ifdef OQS_KEM_alg_kyber_1024
+        case KemAlgorithm::Kyber1024: name = OQS_KEM_alg_kyber_1024; break;
+#endif
+        default: break;
+    }
+    return name && OQS_KEM_alg_is_enabled(name) ? name : nullptr;
+}
+
+// Smallest to strongest within each family; select_kem() relies on the order
+constexpr KemAlgorithm ALL_KEMS[] = {
+    KemAlgorithm::MLKEM512, KemAlgorithm::MLKEM768, KemAlgorithm::MLKEM1024,
+    KemAlgorithm::Kyber512, KemAlgorithm::Kyber768, KemAlgorithm::Kyber1024
+};
+
+bool is_mlkem(KemAlgorithm kem) {
+    return static_cast<uint8_t>(kem) < static_cast<uint8_t>(KemAlgorithm::Kyber512);
+}
+
+// Module rank k: 2, 3 or 4
+int kem_rank(KemAlgorithm kem) {
+    return 1 + (static_cast<uint8_t>(kem) & 0x0F);
+}
+
+// OQS_KEM holds only immutable parameters, so one instance per thread and
+// parameter set is reused instead of OQS_KEM_new/OQS_KEM_free on every operation
+OQS_KEM* cached_kem(KemAlgorithm algorithm) {
+    thread_local std::unique_ptr<OQS_KEM, KemDeleter> kems[std::size(ALL_KEMS)];
+    const auto slot = std::find(std::begin(ALL_KEMS), std::end(ALL_KEMS), algorithm);
+    if (slot == std::end(ALL_KEMS)) {
+        return nullptr;
+    }
+    auto& kem = kems[slot - std::begin(ALL_KEMS)];
+    if (!kem && ensure_crypto_initialized()) {
+        const char* name = kem_method_name(algorithm);
+        if (name) {
+            kem.reset(OQS_KEM_new(name));
+        }
+    }
+    return kem.get();
+}
+
+tl::expected<HybridKeyPair, CryptoError> generate_x25519_keypair() {
+    if (!ensure_crypto_initialized()) {
+        return tl::unexpected(CryptoError::SodiumInitFailed);
+    }
+
+    HybridKeyPair keypair;
+    keypair.x25519_public.resize(crypto_box_PUBLICKEYBYTES);
+    keypair.x25519_private.resize(crypto_box_SECRETKEYBYTES);
+
+    if (crypto_box_keypair(keypair.x25519_public.data(), keypair.x25519_private.data()) != 0) {
+        return tl::unexpected(CryptoError::KeyGenerationFailed);
+    }
+    return keypair;
+}
+
+constexpr size_t AEAD_NONCE_BYTES = crypto_aead_chacha20poly1305_ietf_NPUBBYTES;
+constexpr size_t AEAD_TAG_BYTES = crypto_aead_chacha20poly1305_ietf_ABYTES;
+static_assert(AEAD_NONCE_BYTES == crypto_aead_aes256gcm_NPUBBYTES &&
+              AEAD_TAG_BYTES == crypto_aead_aes256gcm_ABYTES,
+              "cipher suites must share the packet layout");
+
+// Detached seal/open for a suite; c and m may be the same buffer
+int seal_detached(CipherSuite suite, uint8_t* c, uint8_t* mac, const uint8_t* m, size_t mlen,
+                  const AssociatedData& ad, const uint8_t* nonce, const uint8_t* key) {
+    if (suite == CipherSuite::AES256GCM) {
+        return crypto_aead_aes256gcm_encrypt_detached(c, mac, nullptr, m, mlen,
+                                                      ad.data(), ad.size(), nullptr, nonce, key);
+    }
+    return crypto_aead_chacha20poly1305_ietf_encrypt_detached(c, mac, nullptr, m, mlen,
+                                                              ad.data(), ad.size(), nullptr, nonce, key);
+}
+
+int open_detached(CipherSuite suite, uint8_t* m, const uint8_t* c, size_t clen, const uint8_t* mac,
+                  const AssociatedData& ad, const uint8_t* nonce, const uint8_t* key) {
+    if (suite == CipherSuite::AES256GCM) {
+        return crypto_aead_aes256gcm_decrypt_detached(m, nullptr, c, clen, mac,
+                                                      ad.data(), ad.size(), nonce, key);
+    }
+    return crypto_aead_chacha20poly1305_ietf_decrypt_detached(m, nullptr, c, clen, mac,
+                                                              ad.data(), ad.size(), nonce, key);
+}
+
+} // namespace
+
 // AEAD constructor - libsodium initialization
 AEAD::AEAD() {
-    if (sodium_init() < 0) {
-        std::cerr << "FATAL: libsodium initialization failed!" << std::endl;
+    if (!ensure_crypto_initialized()) {
+        CHIMERA_LOG_ERROR("libsodium initialization failed");
         throw std::runtime_error("Sodium initialization failed");
     }
 }
@@ -24,91 +157,532 @@ tl::expected<CryptoKey, CryptoError> AEAD::generate_key() {
 tl::expected<EncryptedPacket, CryptoError> AEAD::encrypt(
     const Plaintext& message,
     const CryptoKey& key,
-    const AssociatedData& ad) {
+    const AssociatedData& ad,
+    CipherSuite suite) {
 
     if (key.size() != crypto_aead_chacha20poly1305_ietf_KEYBYTES) {
         return tl::unexpected(CryptoError::InvalidKeyOrNonce);
     }
+    if (!CipherSuites::is_available(suite)) {
+        return tl::unexpected(CryptoError::UnsupportedAlgorithm);
+    }
 
     // Nonce generation for every encryption
-    Nonce nonce(crypto_aead_chacha20poly1305_ietf_NPUBBYTES);
+    Nonce nonce(AEAD_NONCE_BYTES);
     randombytes_buf(nonce.data(), nonce.size());
 
-    Ciphertext ciphertext(message.size() + crypto_aead_chacha20poly1305_ietf_ABYTES);
-    unsigned long long ciphertext_len;
+    // Layout matches the combined mode: ciphertext || tag
+    Ciphertext ciphertext(message.size() + AEAD_TAG_BYTES);
 
-    int result = crypto_aead_chacha20poly1305_ietf_encrypt(
-        ciphertext.data(), &ciphertext_len,
+    int result = seal_detached(
+        suite,
+        ciphertext.data(), ciphertext.data() + message.size(),
         message.data(), message.size(),
-        ad.data(), ad.size(),
-        nullptr,
-        nonce.data(), key.data()
+        ad, nonce.data(), key.data()
     );
+    CHIMERA_PROBE3(aead_seal, static_cast<int>(suite), message.size(), result == 0);
 
     if (result != 0) {
         return tl::unexpected(CryptoError::EncryptionFailed);
     }
 
-    ciphertext.resize(ciphertext_len);
     return EncryptedPacket{ .data = ciphertext, .nonce = nonce };
 }
 
 tl::expected<Plaintext, CryptoError> AEAD::decrypt(
     const EncryptedPacket& packet,
     const CryptoKey& key,
-    const AssociatedData& ad) {
+    const AssociatedData& ad,
+    CipherSuite suite) {
 
     if (key.size() != crypto_aead_chacha20poly1305_ietf_KEYBYTES ||
-        packet.nonce.size() != crypto_aead_chacha20poly1305_ietf_NPUBBYTES) {
+        packet.nonce.size() != AEAD_NONCE_BYTES) {
         return tl::unexpected(CryptoError::InvalidKeyOrNonce);
     }
+    if (!CipherSuites::is_available(suite)) {
+        return tl::unexpected(CryptoError::UnsupportedAlgorithm);
+    }
+    if (packet.data.size() < AEAD_TAG_BYTES) {
+        return tl::unexpected(CryptoError::DecryptionFailed);
+    }
 
-    Plaintext decrypted_message(packet.data.size());
-    unsigned long long decrypted_len;
+    const size_t message_len = packet.data.size() - AEAD_TAG_BYTES;
+    Plaintext decrypted_message(message_len);
 
-    int result = crypto_aead_chacha20poly1305_ietf_decrypt(
-        decrypted_message.data(), &decrypted_len,
-        nullptr,
-        packet.data.data(), packet.data.size(),
-        ad.data(), ad.size(),
-        packet.nonce.data(), key.data()
+    int result = open_detached(
+        suite,
+        decrypted_message.data(),
+        packet.data.data(), message_len,
+        packet.data.data() + message_len,
+        ad, packet.nonce.data(), key.data()
     );
+    CHIMERA_PROBE3(aead_open, static_cast<int>(suite), message_len, result == 0);
 
     if (result != 0) {
         return tl::unexpected(CryptoError::DecryptionFailed);
     }
 
-    decrypted_message.resize(decrypted_len);
     return decrypted_message;
 }
 
-// Hybrid key exchange implementation - PRODUCTION ML-KEM768
+// Cipher suite selection
+const std::vector<CipherSuite>& CipherSuites::supported() {
+    static const std::vector<CipherSuite> suites = []() {
+        std::vector<CipherSuite> result;
+        // Hardware AES-GCM outpaces ChaCha20-Poly1305 for bulk data
+        if (ensure_crypto_initialized() && crypto_aead_aes256gcm_is_available()) {
+            result.push_back(CipherSuite::AES256GCM);
+        }
+        result.push_back(CipherSuite::ChaCha20Poly1305);
+        return result;
+    }();
+    return suites;
+}
+
+CipherSuite CipherSuites::preferred() {
+    return supported().front();
+}
+
+bool CipherSuites::is_available(CipherSuite suite) {
+    const auto& suites = supported();
+    return std::find(suites.begin(), suites.end(), suite) != suites.end();
+}
+
+const char* CipherSuites::name(CipherSuite suite) {
+    switch (suite) {
+        case CipherSuite::ChaCha20Poly1305: return "ChaCha20-Poly1305";
+        case CipherSuite::AES256GCM: return "AES-256-GCM";
+    }
+    return "unknown";
+}
+
+tl::expected<CipherSuite, CryptoError> CipherSuites::negotiate(const std::vector<CipherSuite>& offer) {
+    for (auto suite : offer) {
+        if (is_available(suite)) {
+            return suite;
+        }
+    }
+    return tl::unexpected(CryptoError::UnsupportedAlgorithm);
+}
+
+std::vector<uint8_t> CipherSuites::encode_offer(const std::vector<CipherSuite>& offer) {
+    std::vector<uint8_t> bytes;
+    bytes.reserve(offer.size());
+    for (auto suite : offer) {
+        bytes.push_back(static_cast<uint8_t>(suite));
+    }
+    return bytes;
+}
+
+std::vector<CipherSuite> CipherSuites::decode_offer(const std::vector<uint8_t>& bytes) {
+    std::vector<CipherSuite> offer;
+    for (auto id : bytes) {
+        if (id == static_cast<uint8_t>(CipherSuite::ChaCha20Poly1305) ||
+            id == static_cast<uint8_t>(CipherSuite::AES256GCM)) {
+            offer.push_back(static_cast<CipherSuite>(id));
+        }
+    }
+    return offer;
+}
+
+// Session AEAD implementation - implicit counter nonces
+AEADSession::AEADSession(const CryptoKey& session_key, SessionRole role, CipherSuite suite)
+    : role_(role), suite_(suite) {
+    if (!ensure_crypto_initialized()) {
+        throw std::runtime_error("Sodium initialization failed");
+    }
+    if (!CipherSuites::is_available(suite)) {
+        throw std::invalid_argument(std::string("Cipher suite not available: ") + CipherSuites::name(suite));
+    }
+    if (session_key.size() != crypto_kdf_blake2b_KEYBYTES) {
+        throw std::invalid_argument("Session key must be 32 bytes");
+    }
+
+    // Direction 1 carries initiator -> responder traffic, direction 2 the reverse
+    const uint64_t send_id = role == SessionRole::Initiator ? 1 : 2;
+    const uint64_t receive_id = role == SessionRole::Initiator ? 2 : 1;
+    if (!derive_direction(send_, session_key, send_id) ||
+        !derive_direction(receive_, session_key, receive_id)) {
+        throw std::runtime_error("Session key derivation failed");
+    }
+}
+
+AEADSession::~AEADSession() {
+    sodium_memzero(&send_, sizeof(send_));
+    sodium_memzero(&receive_, sizeof(receive_));
+}
+
+bool AEADSession::derive_direction(Direction& direction, const CryptoKey& session_key, uint64_t id) {
+    uint8_t material[sizeof(direction.key) + sizeof(direction.nonce_prefix)];
+    if (crypto_kdf_blake2b_derive_from_key(material, sizeof(material), id, "CHMSESSN",
+                                           session_key.data()) != 0) {
+        return false;
+    }
+    std::memcpy(direction.key, material, sizeof(direction.key));
+    std::memcpy(direction.nonce_prefix, material + sizeof(direction.key), sizeof(direction.nonce_prefix));
+    sodium_memzero(material, sizeof(material));
+    return true;
+}
+
+void AEADSession::make_nonce(uint8_t* nonce, const Direction& direction, uint64_t sequence) {
+    // nonce = prefix XOR (0^32 || sequence as big-endian u64)
+    std::memcpy(nonce, direction.nonce_prefix, sizeof(direction.nonce_prefix));
+    for (int i = 0; i < 8; ++i) {
+        nonce[11 - i] ^= static_cast<uint8_t>(sequence >> (8 * i));
+    }
+}
+
+tl::expected<size_t, CryptoError> AEADSession::seal_in_place(
+    uint8_t* buffer, size_t length, size_t capacity,
+    uint64_t sequence, const AssociatedData& ad) const {
+
+    if (capacity < length + TAG_BYTES) {
+        return tl::unexpected(CryptoError::EncryptionFailed);
+    }
+
+    uint8_t nonce[AEAD_NONCE_BYTES];
+    make_nonce(nonce, send_, sequence);
+
+    // The detached form allows ciphertext and plaintext to share the buffer
+    const int result = seal_detached(suite_, buffer, buffer + length, buffer, length, ad, nonce, send_.key);
+    CHIMERA_PROBE3(aead_seal, static_cast<int>(suite_), length, result == 0);
+    if (result != 0) {
+        return tl::unexpected(CryptoError::EncryptionFailed);
+    }
+    return length + TAG_BYTES;
+}
+
+tl::expected<size_t, CryptoError> AEADSession::open_in_place(
+    uint8_t* buffer, size_t length,
+    uint64_t sequence, const AssociatedData& ad) const {
+
+    if (length < TAG_BYTES) {
+        return tl::unexpected(CryptoError::DecryptionFailed);
+    }
+
+    uint8_t nonce[AEAD_NONCE_BYTES];
+    make_nonce(nonce, receive_, sequence);
+
+    const size_t plaintext_length = length - TAG_BYTES;
+    const int result = open_detached(suite_, buffer, buffer, plaintext_length, buffer + plaintext_length,
+                                     ad, nonce, receive_.key);
+    CHIMERA_PROBE3(aead_open, static_cast<int>(suite_), plaintext_length, result == 0);
+    if (result != 0) {
+        return tl::unexpected(CryptoError::DecryptionFailed);
+    }
+    return plaintext_length;
+}
+
+tl::expected<void, CryptoError> AEADSession::seal(std::vector<uint8_t>& buffer, uint64_t sequence,
+                                                  const AssociatedData& ad) const {
+    const size_t length = buffer.size();
+    buffer.resize(length + TAG_BYTES);
+    auto sealed = seal_in_place(buffer.data(), length, buffer.size(), sequence, ad);
+    if (!sealed) {
+        buffer.resize(length);
+        return tl::unexpected(sealed.error());
+    }
+    return {};
+}
+
+tl::expected<void, CryptoError> AEADSession::open(std::vector<uint8_t>& buffer, uint64_t sequence,
+                                                  const AssociatedData& ad) const {
+    auto opened = open_in_place(buffer.data(), buffer.size(), sequence, ad);
+    if (!opened) {
+        return tl::unexpected(opened.error());
+    }
+    buffer.resize(opened.value());
+    return {};
+}
+
+tl::expected<uint64_t, CryptoError> AEADSession::seal_next(std::vector<uint8_t>& buffer, const AssociatedData& ad) {
+    // Reserve the sequence first so concurrent senders never reuse a nonce
+    const uint64_t sequence = send_sequence_.fetch_add(1);
+    auto sealed = seal(buffer, sequence, ad);
+    if (!sealed) {
+        // Nothing was released under it; hand it back unless another sender moved on
+        uint64_t expected = sequence + 1;
+        send_sequence_.compare_exchange_strong(expected, sequence);
+        return tl::unexpected(sealed.error());
+    }
+    return sequence;
+}
+
+tl::expected<void, CryptoError> AEADSession::open_next(std::vector<uint8_t>& buffer, uint64_t sequence,
+                                                       const AssociatedData& ad) {
+    // Held across the open so two copies of one chunk cannot both be accepted
+    std::lock_guard<std::mutex> lock(receive_mutex_);
+    if (!window_allows_locked(sequence, 1)) {
+        return tl::unexpected(CryptoError::ReplayDetected);
+    }
+    // Only an authenticated chunk moves the window; forgeries leave it alone
+    auto opened = open(buffer, sequence, ad);
+    if (!opened) {
+        return opened;
+    }
+    window_accept_locked(sequence, 1);
+    return {};
+}
+
+uint64_t AEADSession::next_receive_sequence() const {
+    std::lock_guard<std::mutex> lock(receive_mutex_);
+    return receive_sequence_;
+}
+
+bool AEADSession::window_allows_locked(uint64_t first, uint64_t count) const {
+    if (count == 0 || first > UINT64_MAX - count) {
+        return false;
+    }
+    if (receive_sequence_ > REPLAY_WINDOW && first < receive_sequence_ - REPLAY_WINDOW) {
+        return false;   // Fell out of the window; cannot tell whether it was seen
+    }
+    // Sequences at or past receive_sequence_ have never been accepted
+    const uint64_t seen_end = std::min(first + count, receive_sequence_);
+    for (uint64_t sequence = first; sequence < seen_end; ++sequence) {
+        if (receive_window_.test(sequence % REPLAY_WINDOW)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void AEADSession::window_accept_locked(uint64_t first, uint64_t count) {
+    const uint64_t end = first + count;
+    if (end > receive_sequence_) {
+        // Slots entering the window belonged to sequences that just fell out of it
+        const uint64_t start = std::max(receive_sequence_, end > REPLAY_WINDOW ? end - REPLAY_WINDOW : 0);
+        for (uint64_t sequence = start; sequence < end; ++sequence) {
+            receive_window_.reset(sequence % REPLAY_WINDOW);
+        }
+        receive_sequence_ = end;
+    }
+    const uint64_t floor = receive_sequence_ > REPLAY_WINDOW ? receive_sequence_ - REPLAY_WINDOW : 0;
+    for (uint64_t sequence = std::max(first, floor); sequence < end; ++sequence) {
+        receive_window_.set(sequence % REPLAY_WINDOW);
+    }
+}
+
+size_t AEADSession::segment_count(size_t plaintext_size, size_t segment_bytes) {
+    if (segment_bytes == 0) {
+        return 0;
+    }
+    // An empty payload still produces one (final) segment carrying just a tag
+    return plaintext_size == 0 ? 1 : (plaintext_size + segment_bytes - 1) / segment_bytes;
+}
+
+size_t AEADSession::sealed_segments_size(size_t plaintext_size, size_t segment_bytes) {
+    return plaintext_size + segment_count(plaintext_size, segment_bytes) * TAG_BYTES;
+}
+
+tl::expected<uint64_t, CryptoError> AEADSession::seal_segments(
+    const std::vector<uint8_t>& plaintext, std::vector<uint8_t>& out,
+    WorkerPool* pool, size_t segment_bytes, const AssociatedData& ad) {
+
+    const size_t count = segment_count(plaintext.size(), segment_bytes);
+    if (count == 0) {
+        return tl::unexpected(CryptoError::EncryptionFailed);
+    }
+
+    // Reserve a contiguous sequence range up front; segment i uses first + i
+    const uint64_t first = send_sequence_.fetch_add(count);
+    out.resize(sealed_segments_size(plaintext.size(), segment_bytes));
+    if (!seal_segments_into(plaintext, out.data(), first, pool, segment_bytes, ad)) {
+        sodium_memzero(out.data(), out.size());
+        out.clear();
+        return tl::unexpected(CryptoError::EncryptionFailed);
+    }
+    return first;
+}
+
+tl::expected<void, CryptoError> AEADSession::open_segments(
+    const std::vector<uint8_t>& sealed, std::vector<uint8_t>& out, uint64_t first_sequence,
+    WorkerPool* pool, size_t segment_bytes, const AssociatedData& ad) const {
+
+    return open_segments_from(sealed.data(), sealed.size(), out, first_sequence, pool, segment_bytes, ad);
+}
+
+tl::expected<void, CryptoError> AEADSession::open_next_segments(
+    const std::vector<uint8_t>& sealed, std::vector<uint8_t>& out, uint64_t first_sequence,
+    WorkerPool* pool, size_t segment_bytes, const AssociatedData& ad) {
+
+    return open_accepted_segments(sealed.data(), sealed.size(), out, first_sequence, pool, segment_bytes, ad);
+}
+
+tl::expected<uint64_t, CryptoError> AEADSession::seal_transfer(
+    const std::vector<uint8_t>& plaintext, std::vector<uint8_t>& out,
+    WorkerPool* pool, size_t segment_bytes, const AssociatedData& ad) {
+
+    const size_t count = segment_count(plaintext.size(), segment_bytes);
+    if (count == 0) {
+        return tl::unexpected(CryptoError::EncryptionFailed);
+    }
+
+    // Segments are sealed straight after the header, so nothing is moved afterwards
+    const uint64_t first = send_sequence_.fetch_add(count);
+    out.resize(TRANSFER_HEADER_BYTES + sealed_segments_size(plaintext.size(), segment_bytes));
+    for (size_t i = 0; i < TRANSFER_HEADER_BYTES; ++i) {
+        out[i] = static_cast<uint8_t>(first >> (8 * (TRANSFER_HEADER_BYTES - 1 - i)));
+    }
+    if (!seal_segments_into(plaintext, out.data() + TRANSFER_HEADER_BYTES, first, pool, segment_bytes, ad)) {
+        sodium_memzero(out.data(), out.size());
+        out.clear();
+        return tl::unexpected(CryptoError::EncryptionFailed);
+    }
+    return first;
+}
+
+tl::expected<uint64_t, CryptoError> AEADSession::open_transfer(
+    const std::vector<uint8_t>& transfer, std::vector<uint8_t>& out,
+    WorkerPool* pool, size_t segment_bytes, const AssociatedData& ad) {
+
+    if (transfer.size() < TRANSFER_HEADER_BYTES) {
+        return tl::unexpected(CryptoError::DecryptionFailed);
+    }
+    uint64_t first = 0;
+    for (size_t i = 0; i < TRANSFER_HEADER_BYTES; ++i) {
+        first = (first << 8) | transfer[i];
+    }
+    // The header is not authenticated on its own; a wrong value selects wrong nonces and fails
+    auto opened = open_accepted_segments(transfer.data() + TRANSFER_HEADER_BYTES,
+                                         transfer.size() - TRANSFER_HEADER_BYTES,
+                                         out, first, pool, segment_bytes, ad);
+    if (!opened) {
+        return tl::unexpected(opened.error());
+    }
+    return first;
+}
+
+bool AEADSession::seal_segments_into(const std::vector<uint8_t>& plaintext, uint8_t* out, uint64_t first,
+                                     WorkerPool* pool, size_t segment_bytes, const AssociatedData& ad) const {
+    const size_t count = segment_count(plaintext.size(), segment_bytes);
+    std::atomic<bool> failed{false};
+    for_each_segment(pool, count, [&](size_t index) {
+        const size_t offset = index * segment_bytes;
+        const size_t length = std::min(segment_bytes, plaintext.size() - offset);
+        uint8_t* segment = out + index * (segment_bytes + TAG_BYTES);
+
+        uint8_t nonce[AEAD_NONCE_BYTES];
+        make_nonce(nonce, send_, first + index);
+        const auto segment_ad = make_segment_ad(ad, index, index + 1 == count);
+
+        if (seal_detached(suite_, segment, segment + length, plaintext.data() + offset, length,
+                          segment_ad, nonce, send_.key) != 0) {
+            failed = true;
+        }
+    });
+    return !failed;
+}
+
+tl::expected<void, CryptoError> AEADSession::open_segments_from(
+    const uint8_t* sealed, size_t sealed_size, std::vector<uint8_t>& out, uint64_t first_sequence,
+    WorkerPool* pool, size_t segment_bytes, const AssociatedData& ad) const {
+
+    const size_t stride = segment_bytes + TAG_BYTES;
+    if (segment_bytes == 0 || sealed_size < TAG_BYTES) {
+        return tl::unexpected(CryptoError::DecryptionFailed);
+    }
+
+    // Every segment but the last is full-sized; the last holds at least a tag
+    const size_t count = (sealed_size + stride - 1) / stride;
+    const size_t last_length = sealed_size - (count - 1) * stride;
+    if (last_length < TAG_BYTES) {
+        return tl::unexpected(CryptoError::DecryptionFailed);
+    }
+    out.resize(sealed_size - count * TAG_BYTES);
+
+    std::atomic<bool> failed{false};
+    for_each_segment(pool, count, [&](size_t index) {
+        const uint8_t* segment = sealed + index * stride;
+        const size_t length = (index + 1 == count ? last_length : stride) - TAG_BYTES;
+
+        uint8_t nonce[AEAD_NONCE_BYTES];
+        make_nonce(nonce, receive_, first_sequence + index);
+        const auto segment_ad = make_segment_ad(ad, index, index + 1 == count);
+
+        if (open_detached(suite_, out.data() + index * segment_bytes, segment, length, segment + length,
+                          segment_ad, nonce, receive_.key) != 0) {
+            failed = true;
+        }
+    });
+
+    if (failed) {
+        sodium_memzero(out.data(), out.size());
+        out.clear();
+        return tl::unexpected(CryptoError::DecryptionFailed);
+    }
+    return {};
+}
+
+tl::expected<void, CryptoError> AEADSession::open_accepted_segments(
+    const uint8_t* sealed, size_t sealed_size, std::vector<uint8_t>& out, uint64_t first_sequence,
+    WorkerPool* pool, size_t segment_bytes, const AssociatedData& ad) {
+
+    if (segment_bytes == 0) {
+        return tl::unexpected(CryptoError::DecryptionFailed);
+    }
+    const size_t stride = segment_bytes + TAG_BYTES;
+    const uint64_t count = std::max<uint64_t>(1, (sealed_size + stride - 1) / stride);
+
+    // Held across the open so two copies of one transfer cannot both be accepted
+    std::lock_guard<std::mutex> lock(receive_mutex_);
+    if (!window_allows_locked(first_sequence, count)) {
+        return tl::unexpected(CryptoError::ReplayDetected);
+    }
+    auto opened = open_segments_from(sealed, sealed_size, out, first_sequence, pool, segment_bytes, ad);
+    if (!opened) {
+        return opened;
+    }
+    window_accept_locked(first_sequence, count);
+    return {};
+}
+
+AssociatedData AEADSession::make_segment_ad(const AssociatedData& ad, uint64_t index, bool last) {
+    // ad || segment index (big-endian u64) || final-segment flag
+    AssociatedData segment_ad;
+    segment_ad.reserve(ad.size() + 9);
+    segment_ad.insert(segment_ad.end(), ad.begin(), ad.end());
+    for (int shift = 56; shift >= 0; shift -= 8) {
+        segment_ad.push_back(static_cast<uint8_t>(index >> shift));
+    }
+    segment_ad.push_back(last ? 1 : 0);
+    return segment_ad;
+}
+
+void AEADSession::for_each_segment(WorkerPool* pool, size_t count, const std::function<void(size_t)>& fn) {
+    if (pool && count > 1) {
+        pool->parallel_for(count, fn);
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        fn(i);
+    }
+}
+
+// Hybrid key exchange implementation - PRODUCTION ML-KEM
 HybridKeyExchange::HybridKeyExchange() {
-    if (sodium_init() < 0) {
+    if (!ensure_crypto_initialized()) {
         throw std::runtime_error("Sodium initialization failed");
     }
 
     // liboqs initialization check
-    if (!OQS_KEM_alg_is_enabled(OQS_KEM_alg_kyber_768)) {
+    if (!kem_method_name(KemAlgorithm::MLKEM768)) {
         throw std::runtime_error("ML-KEM768 not available in liboqs");
     }
 }
 
-tl::expected<HybridKeyPair, CryptoError> HybridKeyExchange::generate_keypair() {
-    HybridKeyPair keypair;
-
+tl::expected<HybridKeyPair, CryptoError> HybridKeyExchange::generate_keypair(KemAlgorithm kem_algorithm) {
     // X25519 keypair generation
-    keypair.x25519_public.resize(crypto_box_PUBLICKEYBYTES);
-    keypair.x25519_private.resize(crypto_box_SECRETKEYBYTES);
-
-    if (crypto_box_keypair(keypair.x25519_public.data(), keypair.x25519_private.data()) != 0) {
-        return tl::unexpected(CryptoError::KeyGenerationFailed);
+    auto keypair_result = generate_x25519_keypair();
+    if (!keypair_result) {
+        return keypair_result;
     }
+    HybridKeyPair keypair = std::move(keypair_result.value());
+    keypair.kem = kem_algorithm;
 
-    // ML-KEM768 keypair generation with liboqs
-    OQS_KEM* kem = OQS_KEM_new(OQS_KEM_alg_kyber_768);
+    // ML-KEM keypair generation with liboqs
+    OQS_KEM* kem = cached_kem(kem_algorithm);
     if (!kem) {
-        return tl::unexpected(CryptoError::KeyGenerationFailed);
+        return tl::unexpected(CryptoError::UnsupportedAlgorithm);
     }
 
     keypair.mlkem_public.resize(kem->length_public_key);
@@ -118,8 +692,6 @@ tl::expected<HybridKeyPair, CryptoError> HybridKeyExchange::generate_keypair() {
         keypair.mlkem_public.data(),
         keypair.mlkem_private.data());
 
-    OQS_KEM_free(kem);
-
     if (status != OQS_SUCCESS) {
         return tl::unexpected(CryptoError::KeyGenerationFailed);
     }
@@ -129,14 +701,16 @@ tl::expected<HybridKeyPair, CryptoError> HybridKeyExchange::generate_keypair() {
 
 tl::expected<HybridKeyExchangeResult, CryptoError> HybridKeyExchange::initiate_exchange(
     const PublicKey& server_x25519_public,
-    const PublicKey& server_mlkem_public) {
+    const PublicKey& server_mlkem_public,
+    KemAlgorithm kem_algorithm,
+    HybridKeyPool* pool) {
 
-    // Client-side keypair generation
-    auto client_keypair_result = generate_keypair();
+    // Client-side ephemeral X25519 key; the ML-KEM half is an encapsulation only
+    auto client_keypair_result = pool ? pool->acquire_x25519() : generate_x25519_keypair();
     if (!client_keypair_result) {
         return tl::unexpected(client_keypair_result.error());
     }
-    auto client_keypair = client_keypair_result.value();
+    auto client_keypair = std::move(client_keypair_result.value());
 
     // X25519 kulcscsere
     auto x25519_secret_result = x25519_exchange(client_keypair.x25519_private, server_x25519_public);
@@ -144,25 +718,22 @@ tl::expected<HybridKeyExchangeResult, CryptoError> HybridKeyExchange::initiate_e
         return tl::unexpected(x25519_secret_result.error());
     }
 
-    // ML-KEM768 encapsulation - PRODUCTION
-    auto mlkem_result = mlkem_encapsulate(server_mlkem_public);
+    // ML-KEM encapsulation - PRODUCTION
+    auto mlkem_result = mlkem_encapsulate(server_mlkem_public, kem_algorithm);
     if (!mlkem_result) {
         return tl::unexpected(mlkem_result.error());
     }
 
-    // Hybrid shared secret combination
-    auto x25519_secret = x25519_secret_result.value();
-    auto mlkem_secret = mlkem_result.value().first;
-    auto mlkem_ciphertext = mlkem_result.value().second;
-
-    SharedSecret combined_secret;
-    combined_secret.reserve(x25519_secret.size() + mlkem_secret.size());
-    combined_secret.insert(combined_secret.end(), x25519_secret.begin(), x25519_secret.end());
+    // Hybrid shared secret combination - the X25519 half is extended in place
+    const auto& mlkem_secret = mlkem_result->first;
+    SharedSecret combined_secret = std::move(x25519_secret_result.value());
     combined_secret.insert(combined_secret.end(), mlkem_secret.begin(), mlkem_secret.end());
 
     return HybridKeyExchangeResult{
-        .shared_secret = combined_secret,
-        .mlkem_ciphertext = mlkem_ciphertext
+        .shared_secret = std::move(combined_secret),
+        .mlkem_ciphertext = std::move(mlkem_result->second),
+        .client_x25519_public = std::move(client_keypair.x25519_public),
+        .cipher_offer = CipherSuites::supported()
     };
 }
 
@@ -177,24 +748,207 @@ tl::expected<SharedSecret, CryptoError> HybridKeyExchange::respond_to_exchange(
         return tl::unexpected(x25519_secret_result.error());
     }
 
-    // ML-KEM768 decapsulation - PRODUCTION
-    auto mlkem_secret_result = mlkem_decapsulate(server_keypair.mlkem_private, client_mlkem_ciphertext);
+    // ML-KEM decapsulation - PRODUCTION
+    auto mlkem_secret_result = mlkem_decapsulate(server_keypair.mlkem_private, client_mlkem_ciphertext,
+                                                 server_keypair.kem);
     if (!mlkem_secret_result) {
         return tl::unexpected(mlkem_secret_result.error());
     }
 
-    // Hybrid shared secret combination
-    auto x25519_secret = x25519_secret_result.value();
-    auto mlkem_secret = mlkem_secret_result.value();
-
-    SharedSecret combined_secret;
-    combined_secret.reserve(x25519_secret.size() + mlkem_secret.size());
-    combined_secret.insert(combined_secret.end(), x25519_secret.begin(), x25519_secret.end());
+    // Hybrid shared secret combination - the X25519 half is extended in place
+    const auto& mlkem_secret = mlkem_secret_result.value();
+    SharedSecret combined_secret = std::move(x25519_secret_result.value());
     combined_secret.insert(combined_secret.end(), mlkem_secret.begin(), mlkem_secret.end());
 
     return combined_secret;
 }
 
+size_t HybridKeyExchange::respond_to_exchanges(
+    const HybridKeyPair& server_keypair,
+    HandshakeBatch& batch,
+    WorkerPool* pool) {
+
+    const size_t count = batch.count_;
+    if (server_keypair.kem != batch.kem_ ||
+        server_keypair.x25519_private.size() != crypto_box_SECRETKEYBYTES) {
+        std::fill(batch.status_.begin(), batch.status_.begin() + count, 0);
+        std::fill(batch.errors_.begin(), batch.errors_.begin() + count, CryptoError::InvalidPublicKey);
+        return 0;
+    }
+
+    std::atomic<size_t> succeeded{0};
+    auto respond_one = [&](size_t index) {
+        uint8_t* secret = batch.secrets_.data() + index * batch.secret_bytes_;
+        const uint8_t* client_public = batch.public_keys_.data() + index * batch.public_key_bytes_;
+        const uint8_t* ciphertext = batch.ciphertexts_.data() + index * batch.ciphertext_bytes_;
+
+        // Same combination as respond_to_exchange: X25519 secret || ML-KEM secret
+        CryptoError error = CryptoError::KeyExchangeFailed;
+        bool ok = false;
+        OQS_KEM* kem = cached_kem(batch.kem_);
+        if (!kem || kem->length_secret_key != server_keypair.mlkem_private.size()) {
+            error = CryptoError::UnsupportedAlgorithm;
+        } else if (crypto_box_beforenm(secret, client_public, server_keypair.x25519_private.data()) == 0 &&
+                   OQS_KEM_decaps(kem, secret + crypto_box_BEFORENMBYTES, ciphertext,
+                                  server_keypair.mlkem_private.data()) == OQS_SUCCESS) {
+            ok = true;
+        }
+
+        batch.status_[index] = ok ? 1 : 0;
+        if (ok) {
+            succeeded.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            batch.errors_[index] = error;
+            sodium_memzero(secret, batch.secret_bytes_);
+        }
+    };
+
+    if (pool && count > 1) {
+        pool->parallel_for(count, respond_one);
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            respond_one(i);
+        }
+    }
+    return succeeded.load();
+}
+
+// Batch storage implementation
+HandshakeBatch::HandshakeBatch(KemAlgorithm kem, size_t capacity) : kem_(kem) {
+    auto params = HybridKeyExchange::kem_parameters(kem);
+    if (!params) {
+        throw std::runtime_error("KEM not available in liboqs");
+    }
+    public_key_bytes_ = crypto_box_PUBLICKEYBYTES;
+    ciphertext_bytes_ = params->ciphertext_bytes;
+    secret_bytes_ = crypto_box_BEFORENMBYTES + params->shared_secret_bytes;
+    reserve(capacity);
+}
+
+HandshakeBatch::~HandshakeBatch() {
+    sodium_memzero(secrets_.data(), secrets_.size());
+}
+
+void HandshakeBatch::reserve(size_t capacity) {
+    if (capacity <= status_.size()) {
+        return;
+    }
+    public_keys_.resize(capacity * public_key_bytes_);
+    ciphertexts_.resize(capacity * ciphertext_bytes_);
+
+    // Move live secrets into a fresh buffer and wipe the old one explicitly
+    // rather than letting a resize copy them around
+    SecureBytes secrets(capacity * secret_bytes_);
+    std::copy(secrets_.begin(), secrets_.begin() + count_ * secret_bytes_, secrets.begin());
+    sodium_memzero(secrets_.data(), secrets_.size());
+    secrets_.swap(secrets);
+    status_.resize(capacity, 0);
+    errors_.resize(capacity, CryptoError::KeyExchangeFailed);
+}
+
+void HandshakeBatch::clear() {
+    sodium_memzero(secrets_.data(), count_ * secret_bytes_);
+    std::fill(status_.begin(), status_.begin() + count_, 0);
+    count_ = 0;
+}
+
+tl::expected<size_t, CryptoError> HandshakeBatch::add(const PublicKey& client_x25519_public,
+                                                      const Ciphertext& mlkem_ciphertext) {
+    if (client_x25519_public.size() != public_key_bytes_) {
+        return tl::unexpected(CryptoError::InvalidPublicKey);
+    }
+    if (mlkem_ciphertext.size() != ciphertext_bytes_) {
+        return tl::unexpected(CryptoError::InvalidCiphertext);
+    }
+
+    // Grows geometrically only when the caller did not reserve enough
+    if (count_ == status_.size()) {
+        reserve(std::max<size_t>(16, count_ * 2));
+    }
+
+    const size_t index = count_++;
+    std::copy(client_x25519_public.begin(), client_x25519_public.end(),
+              public_keys_.begin() + index * public_key_bytes_);
+    std::copy(mlkem_ciphertext.begin(), mlkem_ciphertext.end(),
+              ciphertexts_.begin() + index * ciphertext_bytes_);
+    status_[index] = 0;
+    return index;
+}
+
+bool HandshakeBatch::succeeded(size_t index) const {
+    return index < count_ && status_[index] != 0;
+}
+
+SharedSecret HandshakeBatch::secret(size_t index) const {
+    return SharedSecret(secret_data(index), secret_data(index) + secret_bytes_);
+}
+
+size_t KemParameters::handshake_bytes() const {
+    return public_key_bytes + ciphertext_bytes + 2 * crypto_box_PUBLICKEYBYTES;
+}
+
+size_t KemParameters::handshake_fragments(size_t bytes_per_query) const {
+    if (bytes_per_query == 0) {
+        return 0;
+    }
+    return (handshake_bytes() + bytes_per_query - 1) / bytes_per_query;
+}
+
+tl::expected<KemParameters, CryptoError> HybridKeyExchange::kem_parameters(KemAlgorithm algorithm) {
+    OQS_KEM* kem = cached_kem(algorithm);
+    if (!kem) {
+        return tl::unexpected(CryptoError::UnsupportedAlgorithm);
+    }
+
+    // Work scales with the module rank squared (k = 2, 3, 4)
+    const double rank = kem_rank(algorithm);
+
+    return KemParameters{
+        .algorithm = algorithm,
+        .name = kem->method_name,
+        .public_key_bytes = kem->length_public_key,
+        .secret_key_bytes = kem->length_secret_key,
+        .ciphertext_bytes = kem->length_ciphertext,
+        .shared_secret_bytes = kem->length_shared_secret,
+        .nist_level = kem->claimed_nist_level,
+        .relative_cost = (rank * rank) / 9.0
+    };
+}
+
+std::vector<KemParameters> HybridKeyExchange::available_kems() {
+    std::vector<KemParameters> kems;
+    for (auto algorithm : ALL_KEMS) {
+        auto params = kem_parameters(algorithm);
+        if (params) {
+            kems.push_back(std::move(params.value()));
+        }
+    }
+    return kems;
+}
+
+tl::expected<KemAlgorithm, CryptoError> HybridKeyExchange::select_kem(
+    size_t bytes_per_query,
+    size_t max_fragments) {
+
+    // Never switch families on the caller's behalf; Kyber is opt-in only
+    auto kems = available_kems();
+    kems.erase(std::remove_if(kems.begin(), kems.end(),
+                              [](const KemParameters& params) { return !is_mlkem(params.algorithm); }),
+               kems.end());
+    if (kems.empty()) {
+        return tl::unexpected(CryptoError::UnsupportedAlgorithm);
+    }
+
+    // available_kems() is ordered from smallest to strongest
+    KemAlgorithm choice = kems.front().algorithm;
+    for (const auto& params : kems) {
+        if (params.handshake_fragments(bytes_per_query) <= max_fragments) {
+            choice = params.algorithm;
+        }
+    }
+    return choice;
+}
+
 tl::expected<CryptoKey, CryptoError> HybridKeyExchange::derive_key(
     const SharedSecret& shared_secret,
     const std::string& info) {
@@ -220,17 +974,17 @@ tl::expected<SharedSecret, CryptoError> HybridKeyExchange::x25519_exchange(
     return shared_secret;
 }
 
-// PRODUCTION ML-KEM768 encapsulation
+// PRODUCTION ML-KEM encapsulation
 tl::expected<std::pair<SharedSecret, Ciphertext>, CryptoError> HybridKeyExchange::mlkem_encapsulate(
-    const PublicKey& public_key) {
+    const PublicKey& public_key,
+    KemAlgorithm kem_algorithm) {
 
-    OQS_KEM* kem = OQS_KEM_new(OQS_KEM_alg_kyber_768);
+    OQS_KEM* kem = cached_kem(kem_algorithm);
     if (!kem) {
         return tl::unexpected(CryptoError::UnsupportedAlgorithm);
     }
 
     if (public_key.size() != kem->length_public_key) {
-        OQS_KEM_free(kem);
         return tl::unexpected(CryptoError::InvalidPublicKey);
     }
 
@@ -242,8 +996,6 @@ tl::expected<std::pair<SharedSecret, Ciphertext>, CryptoError> HybridKeyExchange
         shared_secret.data(),
         public_key.data());
 
-    OQS_KEM_free(kem);
-
     if (status != OQS_SUCCESS) {
         return tl::unexpected(CryptoError::KeyExchangeFailed);
     }
@@ -251,19 +1003,19 @@ tl::expected<std::pair<SharedSecret, Ciphertext>, CryptoError> HybridKeyExchange
     return std::make_pair(shared_secret, ciphertext);
 }
 
-// PRODUCTION ML-KEM768 decapsulation
+// PRODUCTION ML-KEM decapsulation
 tl::expected<SharedSecret, CryptoError> HybridKeyExchange::mlkem_decapsulate(
     const PrivateKey& private_key,
-    const Ciphertext& ciphertext) {
+    const Ciphertext& ciphertext,
+    KemAlgorithm kem_algorithm) {
 
-    OQS_KEM* kem = OQS_KEM_new(OQS_KEM_alg_kyber_768);
+    OQS_KEM* kem = cached_kem(kem_algorithm);
     if (!kem) {
         return tl::unexpected(CryptoError::UnsupportedAlgorithm);
     }
 
     if (private_key.size() != kem->length_secret_key ||
         ciphertext.size() != kem->length_ciphertext) {
-        OQS_KEM_free(kem);
         return tl::unexpected(CryptoError::InvalidCiphertext);
     }
 
@@ -274,8 +1026,6 @@ tl::expected<SharedSecret, CryptoError> HybridKeyExchange::mlkem_decapsulate(
         ciphertext.data(),
         private_key.data());
 
-    OQS_KEM_free(kem);
-
     if (status != OQS_SUCCESS) {
         return tl::unexpected(CryptoError::KeyExchangeFailed);
     }
@@ -301,4 +1051,122 @@ tl::expected<CryptoKey, CryptoError> HybridKeyExchange::hkdf_expand(
     return derived_key;
 }
 
+// Keypair pool implementation
+class HybridKeyPool::Impl {
+    const size_t capacity_;
+    const KemAlgorithm kem_;
+    std::deque<HybridKeyPair> hybrid_;
+    std::deque<HybridKeyPair> x25519_;
+    mutable std::mutex mutex_;
+    std::condition_variable refill_cv_;
+    std::atomic<bool> running_{false};
+    std::thread worker_thread_;
+
+public:
+    Impl(size_t capacity, KemAlgorithm kem) : capacity_(capacity), kem_(kem) {}
+
+    ~Impl() { stop(); }
+
+    void start() {
+        if (running_.exchange(true)) {
+            return; // Already running
+        }
+        worker_thread_ = std::thread([this]() { refill_loop(); });
+    }
+
+    void stop() {
+        {
+            // Under the mutex so the refill thread cannot miss the wakeup between
+            // checking its wait predicate and blocking
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!running_.exchange(false)) {
+                return; // Already stopped
+            }
+        }
+        refill_cv_.notify_all();
+        if (worker_thread_.joinable()) {
+            worker_thread_.join();
+        }
+    }
+
+    tl::expected<HybridKeyPair, CryptoError> acquire(bool hybrid) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto& queue = hybrid ? hybrid_ : x25519_;
+            if (!queue.empty()) {
+                HybridKeyPair keypair = std::move(queue.front());
+                queue.pop_front();
+                refill_cv_.notify_one();
+                return keypair;
+            }
+        }
+        // Pool drained - generate inline rather than wait
+        return hybrid ? HybridKeyExchange::generate_keypair(kem_) : generate_x25519_keypair();
+    }
+
+    std::pair<size_t, size_t> available() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return {hybrid_.size(), x25519_.size()};
+    }
+
+private:
+    void refill_loop() {
+        while (running_) {
+            bool need_hybrid = false;
+            bool need_x25519 = false;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                refill_cv_.wait(lock, [this]() {
+                    return !running_ || hybrid_.size() < capacity_ || x25519_.size() < capacity_;
+                });
+                if (!running_) {
+                    break;
+                }
+                need_hybrid = hybrid_.size() < capacity_;
+                need_x25519 = x25519_.size() < capacity_;
+            }
+
+            // Generate outside the lock so acquire() never waits on key generation
+            if (need_x25519) {
+                auto keypair = generate_x25519_keypair();
+                if (keypair) {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    x25519_.push_back(std::move(keypair.value()));
+                }
+            }
+            if (need_hybrid) {
+                auto keypair = HybridKeyExchange::generate_keypair(kem_);
+                if (keypair) {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    hybrid_.push_back(std::move(keypair.value()));
+                }
+            }
+        }
+    }
+};
+
+HybridKeyPool::HybridKeyPool(size_t capacity, KemAlgorithm kem)
+    : impl_(std::make_unique<Impl>(capacity, kem)) {}
+HybridKeyPool::~HybridKeyPool() = default;
+
+void HybridKeyPool::start() {
+    impl_->start();
+}
+
+void HybridKeyPool::stop() {
+    impl_->stop();
+}
+
+tl::expected<HybridKeyPair, CryptoError> HybridKeyPool::acquire() {
+    return impl_->acquire(true);
+}
+
+tl::expected<HybridKeyPair, CryptoError> HybridKeyPool::acquire_x25519() {
+    return impl_->acquire(false);
+}
+
+std::pair<size_t, size_t> HybridKeyPool::available() const {
+    return impl_->available();
+}
+
 } // namespace chimera
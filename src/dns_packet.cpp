@@ -1,9 +1,10 @@
 #include "chimera/dns_packet.hpp"
+#include "chimera/probes.hpp"
+#include "chimera/logging.hpp"
 
-#include <iostream>
-#include <iomanip>
 #include <stdexcept>
 #include <cctype>
+#include <algorithm>
 
 namespace chimera {
 
@@ -12,6 +13,12 @@ std::mt19937 DnsPacketBuilder::gen(DnsPacketBuilder::rd());
 
 std::vector<uint8_t> DnsPacketBuilder::build_query(const DnsQuestion& q, const std::string& payload) {
     std::vector<uint8_t> packet;
+    build_query_into(packet, q, payload);
+    return packet;
+}
+
+void DnsPacketBuilder::build_query_into(std::vector<uint8_t>& packet, const DnsQuestion& q, const std::string& payload) {
+    packet.clear();
     try {
         DnsHeader hdr{};
         hdr.id = gen() & 0xFFFF;
@@ -21,20 +28,24 @@ std::vector<uint8_t> DnsPacketBuilder::build_query(const DnsQuestion& q, const s
         hdr.nscount = 0;
         hdr.arcount = 0;
 
+        // Header, name (one length octet per label plus the root) and QTYPE/QCLASS
+        const bool with_payload = !payload.empty() && q.type == DnsType::TXT;
+        packet.reserve(12 + q.name.size() + 2 + 4 +
+                       (with_payload ? payload.size() + payload.size() / TXT_CHARACTER_STRING_MAX + 1 : 0));
+
         write_header(packet, hdr);
         write_question(packet, q);
 
-        if (!payload.empty() && q.type == DnsType::TXT) {
+        if (with_payload) {
             write_txt_data(packet, payload);
         }
+        CHIMERA_PROBE3(dns_query_built, hdr.id, static_cast<uint16_t>(q.type), packet.size());
 
-        std::cout << "DNS packet created: " << packet.size() << " bytes, ID="
-                  << std::hex << hdr.id << std::dec << std::endl;
+        CHIMERA_LOG_DEBUG("DNS packet created: {} bytes, ID={:x}", packet.size(), hdr.id);
     } catch (const std::exception& e) {
-        std::cerr << "DNS packet building error: " << e.what() << std::endl;
+        CHIMERA_LOG_ERROR("DNS packet building error: {}", e.what());
         throw;
     }
-    return packet;
 }
 
 std::vector<uint8_t> DnsPacketBuilder::parse_response(const std::vector<uint8_t>& response, std::vector<DnsResourceRecord>& answers) {
@@ -78,17 +89,87 @@ std::vector<uint8_t> DnsPacketBuilder::parse_response(const std::vector<uint8_t>
         answers.push_back(std::move(rr));
     }
 
+    CHIMERA_PROBE3(dns_response_parsed, hdr.id, hdr.ancount, response.size());
     return {};
 }
 
+DnsQuestion DnsPacketBuilder::parse_query(const std::vector<uint8_t>& query, DnsHeader& header) {
+    if (query.size() < 12) {
+        throw std::runtime_error("DNS query too short");
+    }
+
+    header.id = read_uint16(query, 0);
+    header.flags = read_uint16(query, 2);
+    header.qdcount = read_uint16(query, 4);
+    header.ancount = read_uint16(query, 6);
+    header.nscount = read_uint16(query, 8);
+    header.arcount = read_uint16(query, 10);
+    if (header.qdcount == 0) {
+        throw std::runtime_error("DNS query has no question");
+    }
+
+    DnsQuestion q;
+    size_t offset = 12;
+    offset += read_domain_name(query, offset, q.name);
+    q.type = static_cast<DnsType>(read_uint16(query, offset));
+    q.cls = static_cast<DnsClass>(read_uint16(query, offset + 2));
+    return q;
+}
+
+std::vector<uint8_t> DnsPacketBuilder::build_response(const DnsHeader& query_header, const DnsQuestion& q,
+                                                      const std::vector<DnsResourceRecord>& answers,
+                                                      uint8_t rcode, bool truncated) {
+    DnsHeader hdr{};
+    hdr.id = query_header.id;
+    // QR, opcode and RD copied from the query, RA, TC when truncated
+    hdr.flags = 0x8000 | (query_header.flags & 0x7900) | 0x0080 | (truncated ? 0x0200 : 0) | (rcode & 0x0F);
+    hdr.qdcount = 1;
+    hdr.ancount = truncated ? 0 : static_cast<uint16_t>(answers.size());
+
+    std::vector<uint8_t> packet;
+    size_t rdata_bytes = 0;
+    for (const auto& rr : answers) {
+        rdata_bytes += rr.rdata.size() + 12;
+    }
+    packet.reserve(12 + q.name.size() + 6 + (truncated ? 0 : rdata_bytes));
+
+    write_header(packet, hdr);
+    write_question(packet, q);
+    if (truncated) {
+        return packet;
+    }
+
+    for (const auto& rr : answers) {
+        if (rr.name == q.name) {
+            write_uint16(packet, 0xC00C); // Pointer to the question name
+        } else {
+            write_domain_name(packet, rr.name);
+        }
+        write_uint16(packet, static_cast<uint16_t>(rr.type));
+        write_uint16(packet, static_cast<uint16_t>(rr.cls));
+        write_uint16(packet, static_cast<uint16_t>(rr.ttl >> 16));
+        write_uint16(packet, static_cast<uint16_t>(rr.ttl & 0xFFFF));
+        if (rr.rdata.size() > 0xFFFF) {
+            throw std::runtime_error("RDATA too long: " + std::to_string(rr.rdata.size()));
+        }
+        write_uint16(packet, static_cast<uint16_t>(rr.rdata.size()));
+        packet.insert(packet.end(), rr.rdata.begin(), rr.rdata.end());
+    }
+    return packet;
+}
+
 void DnsPacketBuilder::print_packet_hex(const std::vector<uint8_t>& packet) {
-    std::cout << "DNS packet hex dump:" << std::endl;
-    for (size_t i = 0; i < packet.size(); ++i) {
-        if (i % 16 == 0) std::cout << std::endl;
-        std::cout << std::hex << std::setfill('0') << std::setw(2)
-                  << static_cast<int>(packet[i]) << " ";
+    static constexpr char digits[] = "0123456789abcdef";
+    CHIMERA_LOG_INFO("DNS packet hex dump: {} bytes", packet.size());
+    for (size_t row = 0; row < packet.size(); row += 16) {
+        std::string line;
+        for (size_t i = row; i < std::min(row + 16, packet.size()); ++i) {
+            line += digits[packet[i] >> 4];
+            line += digits[packet[i] & 0x0f];
+            line += ' ';
+        }
+        CHIMERA_LOG_INFO("{}", line);
     }
-    std::cout << std::dec << std::endl;
 }
 
 bool DnsPacketBuilder::validate_domain_name(const std::string& domain) {
@@ -125,28 +206,77 @@ void DnsPacketBuilder::write_question(std::vector<uint8_t>& packet, const DnsQue
 }
 
 void DnsPacketBuilder::write_domain_name(std::vector<uint8_t>& packet, const std::string& name) {
-    if (name.empty()) {
-        packet.push_back(0);
-        return;
-    }
-    auto labels = split_domain(name);
-    for (const auto& label : labels) {
-        if (label.empty()) continue;
-        if (label.size() > 63) {
-            throw std::runtime_error("DNS label too long: " + label);
+    // Walks the labels in place; this is on the per-query path
+    size_t start = 0;
+    while (start < name.size()) {
+        size_t end = name.find('.', start);
+        if (end == std::string::npos) {
+            end = name.size();
+        }
+        const size_t length = end - start;
+        if (length > 63) {
+            throw std::runtime_error("DNS label too long: " + name.substr(start, length));
         }
-        packet.push_back(static_cast<uint8_t>(label.size()));
-        packet.insert(packet.end(), label.begin(), label.end());
+        if (length > 0) {
+            packet.push_back(static_cast<uint8_t>(length));
+            packet.insert(packet.end(), name.begin() + start, name.begin() + end);
+        }
+        start = end + 1;
     }
     packet.push_back(0);
 }
 
 void DnsPacketBuilder::write_txt_data(std::vector<uint8_t>& packet, const std::string& data) {
-    if (data.size() > 255) {
+    // RDLENGTH is 16 bits, so the data plus one length octet per string must fit in 65535
+    const size_t strings = data.empty() ? 1 : (data.size() + TXT_CHARACTER_STRING_MAX - 1) / TXT_CHARACTER_STRING_MAX;
+    if (data.size() + strings > DNS_TCP_MESSAGE_LIMIT) {
         throw std::runtime_error("TXT data too long: " + std::to_string(data.size()));
     }
-    packet.push_back(static_cast<uint8_t>(data.size()));
-    packet.insert(packet.end(), data.begin(), data.end());
+    packet.reserve(packet.size() + data.size() + strings);
+
+    size_t offset = 0;
+    do {
+        const size_t len = std::min(TXT_CHARACTER_STRING_MAX, data.size() - offset);
+        packet.push_back(static_cast<uint8_t>(len));
+        packet.insert(packet.end(), data.begin() + offset, data.begin() + offset + len);
+        offset += len;
+    } while (offset < data.size());
+}
+
+std::vector<uint8_t> DnsPacketBuilder::build_txt_rdata(const std::string& data) {
+    std::vector<uint8_t> rdata;
+    write_txt_data(rdata, data);
+    return rdata;
+}
+
+std::vector<std::string> DnsPacketBuilder::parse_txt_rdata(const std::vector<uint8_t>& rdata) {
+    std::vector<std::string> strings;
+    size_t offset = 0;
+    while (offset < rdata.size()) {
+        const uint8_t len = rdata[offset++];
+        if (offset + len > rdata.size()) {
+            throw std::runtime_error("TXT character-string exceeds RDATA bounds");
+        }
+        strings.emplace_back(reinterpret_cast<const char*>(rdata.data() + offset), len);
+        offset += len;
+    }
+    return strings;
+}
+
+std::string DnsPacketBuilder::join_txt_rdata(const std::vector<uint8_t>& rdata) {
+    std::string joined;
+    joined.reserve(rdata.size());
+    for (const auto& part : parse_txt_rdata(rdata)) {
+        joined += part;
+    }
+    return joined;
+}
+
+size_t DnsPacketBuilder::txt_capacity(size_t rdata_limit) {
+    // Every full 256-byte block of RDATA carries 255 bytes of data
+    const size_t full_blocks = rdata_limit / (TXT_CHARACTER_STRING_MAX + 1);
+    const size_t remainder = rdata_limit % (TXT_CHARACTER_STRING_MAX + 1);
+    return full_blocks * TXT_CHARACTER_STRING_MAX + (remainder > 0 ? remainder - 1 : 0);
 }
 
 void DnsPacketBuilder::write_uint16(std::vector<uint8_t>& packet, uint16_t value) {
@@ -0,0 +1,233 @@
+#include "chimera/fault_injection.hpp"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <random>
+#include <thread>
+
+namespace chimera {
+
+class FaultInjector::Impl {
+public:
+    explicit Impl(FaultProfile profile) : profile_(profile), rng_(profile.seed) {}
+
+    FaultProfile profile_;
+    std::mutex mutex_;
+    std::mt19937_64 rng_;
+    FaultStats stats_;
+    std::chrono::steady_clock::time_point link_free_{};
+};
+
+FaultInjector::FaultInjector(FaultProfile profile) : impl_(std::make_unique<Impl>(profile)) {}
+
+FaultInjector::~FaultInjector() = default;
+
+const FaultProfile& FaultInjector::profile() const {
+    return impl_->profile_;
+}
+
+FaultStats FaultInjector::stats() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    return impl_->stats_;
+}
+
+bool FaultInjector::roll(double probability) {
+    if (probability <= 0.0) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    return std::bernoulli_distribution(std::min(probability, 1.0))(impl_->rng_);
+}
+
+std::chrono::nanoseconds FaultInjector::sample_delay() {
+    const auto& profile = impl_->profile_;
+    const double mean = std::chrono::duration<double, std::nano>(profile.delay).count();
+    const double jitter = std::chrono::duration<double, std::nano>(profile.delay_jitter).count();
+    if (mean <= 0.0 && jitter <= 0.0) {
+        return std::chrono::nanoseconds(0);
+    }
+
+    double delay = mean;
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex_);
+        auto& rng = impl_->rng_;
+        switch (profile.delay_distribution) {
+            case DelayDistribution::Constant:
+                break;
+            case DelayDistribution::Uniform:
+                delay = std::uniform_real_distribution<double>(mean - jitter, mean + jitter)(rng);
+                break;
+            case DelayDistribution::Normal:
+                delay = std::normal_distribution<double>(mean, jitter)(rng);
+                break;
+            case DelayDistribution::Exponential:
+                delay = mean > 0.0 ? std::exponential_distribution<double>(1.0 / mean)(rng) : 0.0;
+                break;
+            case DelayDistribution::Pareto: {
+                // Scale chosen so the mean stays at `delay`
+                const double shape = std::max(profile.pareto_shape, 1.01);
+                const double scale = mean * (shape - 1.0) / shape;
+                const double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+                delay = scale / std::pow(1.0 - u, 1.0 / shape);
+                break;
+            }
+        }
+    }
+    return std::chrono::nanoseconds(static_cast<int64_t>(std::max(delay, 0.0)));
+}
+
+size_t FaultInjector::sample_length(size_t below) {
+    if (below == 0) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    return std::uniform_int_distribution<size_t>(0, below - 1)(impl_->rng_);
+}
+
+void FaultInjector::throttle(size_t bytes) {
+    const uint64_t bps = impl_->profile_.bandwidth_bps;
+    if (bps == 0 || bytes == 0) {
+        return;
+    }
+
+    // One link shared by every wrapped transport: transmissions queue behind each other
+    const auto now = std::chrono::steady_clock::now();
+    const auto serialization = std::chrono::nanoseconds(static_cast<int64_t>(bytes * 8 * 1e9 / bps));
+    std::chrono::steady_clock::time_point done;
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex_);
+        impl_->link_free_ = std::max(impl_->link_free_, now) + serialization;
+        done = impl_->link_free_;
+        impl_->stats_.throttle_ns += static_cast<uint64_t>(std::chrono::nanoseconds(done - now).count());
+    }
+    std::this_thread::sleep_until(done);
+}
+
+void FaultInjector::count(uint64_t FaultStats::*counter, uint64_t amount) {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    impl_->stats_.*counter += amount;
+}
+
+FaultInjectingTransport::FaultInjectingTransport(std::unique_ptr<ITransport> inner,
+                                                 std::shared_ptr<FaultInjector> injector)
+    : inner_(std::move(inner)), injector_(std::move(injector)) {}
+
+tl::expected<size_t, TransportError> FaultInjectingTransport::send(const std::vector<uint8_t>& data) {
+    if (!inner_) {
+        return tl::unexpected(TransportError::SocketCreationFailed);
+    }
+    injector_->count(&FaultStats::requests);
+    injector_->throttle(data.size());
+
+    if (injector_->roll(injector_->profile().loss_rate)) {
+        injector_->count(&FaultStats::dropped_requests);
+        outstanding_.push_back(false);
+        return data.size();
+    }
+
+    auto sent = inner_->send(data);
+    if (sent) {
+        outstanding_.push_back(true);
+    }
+    return sent;
+}
+
+tl::expected<std::vector<uint8_t>, TransportError> FaultInjectingTransport::receive() {
+    if (!held_.empty()) {
+        auto response = std::move(held_.front());
+        held_.pop_front();
+        return response;
+    }
+    if (!duplicates_.empty()) {
+        // The copy arrives first and is taken as the answer to the next pending
+        // request; that request's own response, if any, is then discarded
+        auto response = std::move(duplicates_.front());
+        duplicates_.pop_front();
+        if (!outstanding_.empty()) {
+            stale_ += outstanding_.front() ? 1 : 0;
+            outstanding_.pop_front();
+        }
+        return response;
+    }
+    if (!inner_) {
+        return tl::unexpected(TransportError::SocketCreationFailed);
+    }
+
+    // Responses come back in request order; a dropped request never answers
+    const bool forwarded = outstanding_.empty() || outstanding_.front();
+    if (!outstanding_.empty()) {
+        outstanding_.pop_front();
+    }
+    if (!forwarded) {
+        return time_out();
+    }
+
+    for (; stale_ > 0; --stale_) {
+        inner_->receive();
+    }
+    auto response = inner_->receive();
+    if (!response) {
+        return response;
+    }
+    injector_->count(&FaultStats::responses);
+
+    const auto& profile = injector_->profile();
+    if (injector_->roll(profile.response_loss_rate)) {
+        injector_->count(&FaultStats::dropped_responses);
+        return time_out();
+    }
+
+    const auto delay = injector_->sample_delay();
+    if (delay.count() > 0) {
+        if (delay >= timeout_) {
+            injector_->count(&FaultStats::late_responses);
+            return time_out();
+        }
+        injector_->count(&FaultStats::delay_ns, static_cast<uint64_t>(delay.count()));
+        std::this_thread::sleep_for(delay);
+    }
+    injector_->throttle(response->size());
+
+    if (!response->empty() && injector_->roll(profile.truncate_rate)) {
+        injector_->count(&FaultStats::truncated);
+        response->resize(injector_->sample_length(response->size()));
+    }
+
+    // Reordering needs a second response in flight to swap with
+    if (!outstanding_.empty() && outstanding_.front() && injector_->roll(profile.reorder_rate)) {
+        outstanding_.pop_front();
+        auto next = inner_->receive();
+        if (next) {
+            injector_->count(&FaultStats::responses);
+            injector_->count(&FaultStats::reordered);
+            held_.push_back(std::move(*response));
+            return next;
+        }
+    }
+
+    if (injector_->roll(profile.duplicate_rate)) {
+        injector_->count(&FaultStats::duplicated);
+        duplicates_.push_back(*response);
+    }
+    return response;
+}
+
+void FaultInjectingTransport::set_timeout(std::chrono::milliseconds timeout) {
+    timeout_ = timeout;
+    if (inner_) {
+        inner_->set_timeout(timeout);
+    }
+}
+
+tl::expected<std::vector<uint8_t>, TransportError> FaultInjectingTransport::time_out() {
+    std::this_thread::sleep_for(timeout_);
+    return tl::unexpected(TransportError::Timeout);
+}
+
+TransportDecorator inject_faults(std::shared_ptr<FaultInjector> injector) {
+    return [injector = std::move(injector)](std::unique_ptr<ITransport> inner) -> std::unique_ptr<ITransport> {
+        return std::make_unique<FaultInjectingTransport>(std::move(inner), injector);
+    };
+}
+
+} // namespace chimera
@@ -0,0 +1,174 @@
+#include "chimera/latency_histogram.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <iomanip>
+#include <ostream>
+
+namespace chimera {
+
+size_t LatencyHistogram::bucket_index(uint64_t value) {
+    if (value < SUB_BUCKETS) {
+        return static_cast<size_t>(value);
+    }
+    // Keep the top SUB_BUCKET_BITS - 1 bits below the leading one as the sub-bucket
+    const unsigned msb = 63 - static_cast<unsigned>(std::countl_zero(value));
+    const unsigned shift = msb - (SUB_BUCKET_BITS - 1);
+    const uint64_t mantissa = value >> shift;                     // [64, 128)
+    return SUB_BUCKETS + (shift - 1) * HALF_SUB_BUCKETS + static_cast<size_t>(mantissa - HALF_SUB_BUCKETS);
+}
+
+uint64_t LatencyHistogram::bucket_lowest(size_t index) {
+    if (index < SUB_BUCKETS) {
+        return index;
+    }
+    const size_t shift = (index - SUB_BUCKETS) / HALF_SUB_BUCKETS + 1;
+    const uint64_t mantissa = (index - SUB_BUCKETS) % HALF_SUB_BUCKETS + HALF_SUB_BUCKETS;
+    return mantissa << shift;
+}
+
+uint64_t LatencyHistogram::bucket_highest(size_t index) {
+    if (index < SUB_BUCKETS) {
+        return index;
+    }
+    const size_t shift = (index - SUB_BUCKETS) / HALF_SUB_BUCKETS + 1;
+    return bucket_lowest(index) + ((uint64_t{1} << shift) - 1);
+}
+
+void LatencyHistogram::record(uint64_t value, uint64_t count) {
+    if (count == 0) {
+        return;
+    }
+    counts_[bucket_index(value)] += count;
+    total_ += count;
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+}
+
+void LatencyHistogram::record_corrected(uint64_t value, uint64_t expected_interval) {
+    record(value);
+    if (expected_interval == 0) {
+        return;
+    }
+    for (uint64_t missing = value; missing > expected_interval;) {
+        missing -= expected_interval;
+        record(missing);
+    }
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        counts_[i] += other.counts_[i];
+    }
+    total_ += other.total_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+}
+
+void LatencyHistogram::reset() {
+    counts_.fill(0);
+    total_ = 0;
+    min_ = UINT64_MAX;
+    max_ = 0;
+}
+
+double LatencyHistogram::mean() const {
+    if (total_ == 0) {
+        return 0;
+    }
+    double sum = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        if (counts_[i]) {
+            sum += static_cast<double>(counts_[i]) * (bucket_lowest(i) + bucket_highest(i)) / 2.0;
+        }
+    }
+    return sum / static_cast<double>(total_);
+}
+
+double LatencyHistogram::stddev() const {
+    if (total_ == 0) {
+        return 0;
+    }
+    const double average = mean();
+    double sum = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        if (counts_[i]) {
+            const double deviation = (bucket_lowest(i) + bucket_highest(i)) / 2.0 - average;
+            sum += static_cast<double>(counts_[i]) * deviation * deviation;
+        }
+    }
+    return std::sqrt(sum / static_cast<double>(total_));
+}
+
+uint64_t LatencyHistogram::value_at_percentile(double percentile) const {
+    if (total_ == 0) {
+        return 0;
+    }
+    const double clamped = std::clamp(percentile, 0.0, 100.0);
+    const auto target = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(clamped / 100.0 * total_)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        seen += counts_[i];
+        if (seen >= target) {
+            return std::min(bucket_highest(i), max_);
+        }
+    }
+    return max_;
+}
+
+uint64_t LatencyHistogram::count_at_or_below(uint64_t value) const {
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT && bucket_highest(i) <= value; ++i) {
+        seen += counts_[i];
+    }
+    return seen;
+}
+
+void LatencyHistogram::write_percentile_distribution(std::ostream& out, double unit_scale,
+                                                     unsigned ticks_per_half_distance) const {
+    const auto flags = out.flags();
+    const auto precision = out.precision();
+
+    out << std::setw(12) << "Value" << " " << std::setw(14) << "Percentile" << " "
+        << std::setw(10) << "TotalCount" << " " << std::setw(14) << "1/(1-Percentile)" << "\n\n";
+    out << std::fixed;
+
+    // Same iteration as HdrHistogram: ticks get denser as the percentile approaches 100
+    uint64_t seen = 0;
+    size_t bucket = 0;
+    double level = 0;
+    while (total_ > 0) {
+        const auto target = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(level / 100.0 * total_)));
+        while (seen < target && bucket < BUCKET_COUNT) {
+            seen += counts_[bucket++];
+        }
+        const uint64_t value = bucket ? std::min(bucket_highest(bucket - 1), max_) : 0;
+        const double fraction = static_cast<double>(seen) / static_cast<double>(total_);
+
+        out << std::setprecision(3) << std::setw(12) << value / unit_scale << " "
+            << std::setprecision(12) << std::setw(14) << fraction << " "
+            << std::setw(10) << seen << " ";
+        if (seen < total_) {
+            out << std::setprecision(2) << std::setw(14) << 1.0 / (1.0 - fraction) << "\n";
+        } else {
+            out << std::setw(14) << "" << "\n";
+            break;
+        }
+
+        const double half_distance = std::pow(2.0, std::floor(std::log2(100.0 / (100.0 - fraction * 100.0))) + 1);
+        level = std::max(level, fraction * 100.0) + 100.0 / (ticks_per_half_distance * half_distance);
+    }
+
+    out << std::setprecision(3)
+        << "#[Mean    = " << std::setw(12) << mean() / unit_scale
+        << ", StdDeviation   = " << std::setw(12) << stddev() / unit_scale << "]\n"
+        << "#[Max     = " << std::setw(12) << max_ / unit_scale
+        << ", Total count    = " << std::setw(12) << total_ << "]\n"
+        << "#[Buckets = " << std::setw(12) << (64 - SUB_BUCKET_BITS + 1)
+        << ", SubBuckets     = " << std::setw(12) << SUB_BUCKETS << "]\n";
+
+    out.flags(flags);
+    out.precision(precision);
+}
+
+} // namespace chimera
@@ -0,0 +1,253 @@
+#include "chimera/logging.hpp"
+#include "chimera/spsc_ring.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace chimera {
+
+namespace {
+
+constexpr auto DRAIN_INTERVAL = std::chrono::milliseconds(20);
+
+struct ThreadBuffer {
+    explicit ThreadBuffer(size_t capacity) : ring(capacity) {}
+
+    SpscRing<LogRecord> ring;             // Producer: owning thread; consumer: collect() under the state mutex
+    std::atomic<size_t> dropped{0};
+    std::atomic<bool> retired{false};     // Owning thread has exited
+};
+
+struct LogState {
+    std::mutex mutex;                     // Guards the buffers and settings below
+    std::mutex output_mutex;              // Guards sink; keeps concurrent drains in order
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    LogSink sink;
+    size_t ring_capacity = 256;
+    size_t retired_dropped = 0;
+    std::once_flag started;
+
+    // Caller holds output_mutex. The state mutex is released before the sink
+    // runs, so a sink that logs does not deadlock in local_buffer()
+    void drain() {
+        std::vector<LogRecord> records;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            collect(records);
+        }
+        for (const auto& entry : records) {
+            const std::string line = entry.format_line();
+            if (sink) {
+                sink(entry.level, line);
+            } else {
+                std::cerr << line << '\n';
+            }
+        }
+        if (!sink && !records.empty()) {
+            std::cerr.flush();
+        }
+    }
+
+    // Caller holds the mutex; moves every buffered record into records, oldest first
+    void collect(std::vector<LogRecord>& records) {
+        LogRecord record;
+        size_t retired_count = 0;
+        for (auto& buffer : buffers) {
+            // Load before popping: a retired thread pushes nothing more
+            const bool retired = buffer->retired.load(std::memory_order_acquire);
+            while (buffer->ring.try_pop(record)) {
+                records.push_back(record);
+            }
+            if (retired) {
+                retired_dropped += buffer->dropped.load(std::memory_order_relaxed);
+                buffer.reset();
+                ++retired_count;
+            }
+        }
+        if (retired_count > 0) {
+            buffers.erase(std::remove(buffers.begin(), buffers.end(), nullptr), buffers.end());
+        }
+        std::stable_sort(records.begin(), records.end(),
+                         [](const LogRecord& a, const LogRecord& b) { return a.wall_ns < b.wall_ns; });
+    }
+};
+
+// Never destroyed: threads may still log during static destruction
+LogState& state() {
+    static LogState* instance = new LogState();
+    return *instance;
+}
+
+void start_drain_thread() {
+    std::call_once(state().started, [] {
+        std::thread([] {
+            for (;;) {
+                std::this_thread::sleep_for(DRAIN_INTERVAL);
+                auto& log = state();
+                std::lock_guard<std::mutex> output(log.output_mutex);
+                log.drain();
+            }
+        }).detach();
+        std::atexit([] { Logger::flush(); });
+    });
+}
+
+struct LocalBuffer {
+    std::shared_ptr<ThreadBuffer> buffer;
+
+    ~LocalBuffer() {
+        if (buffer) {
+            buffer->retired.store(true, std::memory_order_release);
+        }
+    }
+};
+
+ThreadBuffer& local_buffer() {
+    thread_local LocalBuffer local;
+    if (!local.buffer) {
+        auto& log = state();
+        std::lock_guard<std::mutex> lock(log.mutex);
+        local.buffer = std::make_shared<ThreadBuffer>(log.ring_capacity);
+        log.buffers.push_back(local.buffer);
+    }
+    return *local.buffer;
+}
+
+bool parse_level(const char* text, LogLevel& level) {
+    static constexpr std::pair<const char*, LogLevel> names[] = {
+        {"trace", LogLevel::Trace}, {"debug", LogLevel::Debug}, {"info", LogLevel::Info},
+        {"warn", LogLevel::Warn},   {"error", LogLevel::Error}, {"off", LogLevel::Off},
+    };
+    for (const auto& [name, value] : names) {
+        if (std::string_view(text) == name) {
+            level = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+[[maybe_unused]] const bool env_level_applied = [] {
+    LogLevel level;
+    const char* text = std::getenv("CHIMERA_LOG_LEVEL");
+    if (text && parse_level(text, level)) {
+        Logger::set_level(level);
+        return true;
+    }
+    return false;
+}();
+
+void append_arg(std::string& out, const LogRecord& record, const LogArg& arg, bool hex) {
+    char number[32];
+    int length = 0;
+    switch (arg.kind) {
+        case LogArg::Kind::Signed:
+            length = hex ? std::snprintf(number, sizeof(number), "%llx", static_cast<unsigned long long>(arg.i))
+                         : std::snprintf(number, sizeof(number), "%lld", static_cast<long long>(arg.i));
+            break;
+        case LogArg::Kind::Unsigned:
+            length = std::snprintf(number, sizeof(number), hex ? "%llx" : "%llu",
+                                   static_cast<unsigned long long>(arg.u));
+            break;
+        case LogArg::Kind::Float:
+            length = std::snprintf(number, sizeof(number), "%g", arg.f);
+            break;
+        case LogArg::Kind::Text:
+            out.append(record.text + arg.text.offset, arg.text.length);
+            return;
+    }
+    if (length > 0) {
+        out.append(number, std::min(static_cast<size_t>(length), sizeof(number) - 1));
+    }
+}
+
+} // namespace
+
+const char* log_level_name(LogLevel level) {
+    switch (level) {
+        case LogLevel::Trace: return "TRACE";
+        case LogLevel::Debug: return "DEBUG";
+        case LogLevel::Info: return "INFO";
+        case LogLevel::Warn: return "WARN";
+        case LogLevel::Error: return "ERROR";
+        case LogLevel::Off: return "OFF";
+    }
+    return "?";
+}
+
+std::string LogRecord::format_line() const {
+    std::string out = "[CHIMERA ";
+    out += log_level_name(level);
+    out += "] ";
+
+    const std::string_view fmt = format ? format : "";
+    size_t next_arg = 0;
+    for (size_t i = 0; i < fmt.size(); ++i) {
+        const char c = fmt[i];
+        if ((c == '{' || c == '}') && i + 1 < fmt.size() && fmt[i + 1] == c) {
+            out += c;   // "{{" / "}}"
+            ++i;
+        } else if (c == '{' && fmt.compare(i, 2, "{}") == 0 && next_arg < arg_count) {
+            append_arg(out, *this, args[next_arg++], false);
+            ++i;
+        } else if (c == '{' && fmt.compare(i, 4, "{:x}") == 0 && next_arg < arg_count) {
+            append_arg(out, *this, args[next_arg++], true);
+            i += 3;
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+void Logger::set_level(LogLevel level) {
+    level_.store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+}
+
+LogLevel Logger::level() {
+    return static_cast<LogLevel>(level_.load(std::memory_order_relaxed));
+}
+
+void Logger::set_sink(LogSink sink) {
+    auto& log = state();
+    std::lock_guard<std::mutex> output(log.output_mutex);
+    log.drain();
+    log.sink = std::move(sink);
+}
+
+void Logger::set_ring_capacity(size_t records_per_thread) {
+    auto& log = state();
+    std::lock_guard<std::mutex> lock(log.mutex);
+    log.ring_capacity = std::max<size_t>(records_per_thread, 2);
+}
+
+void Logger::submit(const LogRecord& record) {
+    start_drain_thread();
+    auto& buffer = local_buffer();
+    if (!buffer.ring.try_push(record)) {
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void Logger::flush() {
+    auto& log = state();
+    std::lock_guard<std::mutex> output(log.output_mutex);
+    log.drain();
+}
+
+size_t Logger::dropped() {
+    auto& log = state();
+    std::lock_guard<std::mutex> lock(log.mutex);
+    size_t total = log.retired_dropped;
+    for (const auto& buffer : log.buffers) {
+        total += buffer->dropped.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+} // namespace chimera
@@ -0,0 +1,408 @@
+#include "chimera/metrics.hpp"
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <poll.h>
+#include <sstream>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace chimera {
+
+namespace {
+
+enum class MetricType { Counter, Gauge, Histogram };
+
+const char* type_name(MetricType type) {
+    switch (type) {
+        case MetricType::Counter: return "counter";
+        case MetricType::Gauge: return "gauge";
+        case MetricType::Histogram: return "histogram";
+    }
+    return "untyped";
+}
+
+// Histogram `le` bounds in seconds, spanning a cached encode to a DoH timeout
+struct BucketBound {
+    uint64_t nanoseconds;
+    const char* label;
+};
+
+constexpr BucketBound BUCKET_BOUNDS[] = {
+    {1'000, "1e-06"}, {5'000, "5e-06"}, {10'000, "1e-05"}, {50'000, "5e-05"},
+    {100'000, "0.0001"}, {500'000, "0.0005"}, {1'000'000, "0.001"}, {5'000'000, "0.005"},
+    {10'000'000, "0.01"}, {50'000'000, "0.05"}, {100'000'000, "0.1"}, {500'000'000, "0.5"},
+    {1'000'000'000, "1"}, {5'000'000'000, "5"}, {10'000'000'000, "10"},
+};
+
+std::atomic<size_t> next_shard{0};
+
+std::string series(const std::string& name, const std::string& labels, const std::string& extra = "") {
+    if (labels.empty() && extra.empty()) {
+        return name;
+    }
+    std::string out = name + "{" + labels;
+    if (!labels.empty() && !extra.empty()) {
+        out += ",";
+    }
+    return out + extra + "}";
+}
+
+} // namespace
+
+size_t metric_shard() {
+    thread_local const size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % METRIC_SHARDS;
+    return shard;
+}
+
+uint64_t Counter::value() const {
+    uint64_t total = 0;
+    for (const auto& shard : shards_) {
+        total += shard.value.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void Counter::reset() {
+    for (auto& shard : shards_) {
+        shard.value.store(0, std::memory_order_relaxed);
+    }
+}
+
+void Histogram::record(uint64_t nanoseconds) {
+    auto& shard = shards_[metric_shard()];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (!shard.histogram) {
+        shard.histogram = std::make_unique<LatencyHistogram>();
+    }
+    shard.histogram->record(nanoseconds);
+    shard.sum += nanoseconds;
+}
+
+LatencyHistogram Histogram::snapshot() const {
+    LatencyHistogram merged;
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (shard.histogram) {
+            merged.merge(*shard.histogram);
+        }
+    }
+    return merged;
+}
+
+uint64_t Histogram::sum() const {
+    uint64_t total = 0;
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        total += shard.sum;
+    }
+    return total;
+}
+
+void Histogram::reset() {
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (shard.histogram) {
+            shard.histogram->reset();
+        }
+        shard.sum = 0;
+    }
+}
+
+class MetricsRegistry::Impl {
+public:
+    struct Series {
+        std::string labels;
+        std::unique_ptr<Counter> counter;
+        std::unique_ptr<Gauge> gauge;
+        std::unique_ptr<Histogram> histogram;
+    };
+
+    struct Family {
+        std::string name;
+        std::string help;
+        MetricType type;
+        std::deque<Series> series;
+    };
+
+    Series& find(const std::string& name, const std::string& help, const std::string& labels, MetricType type) {
+        Family* family = nullptr;
+        for (auto& candidate : families_) {
+            if (candidate.name == name) {
+                family = &candidate;
+                break;
+            }
+        }
+        if (!family) {
+            family = &families_.emplace_back(Family{name, help, type, {}});
+        } else if (family->type != type) {
+            throw std::runtime_error("Metric " + name + " already registered as " + type_name(family->type));
+        }
+
+        for (auto& existing : family->series) {
+            if (existing.labels == labels) {
+                return existing;
+            }
+        }
+        auto& created = family->series.emplace_back();
+        created.labels = labels;
+        switch (type) {
+            case MetricType::Counter: created.counter = std::make_unique<Counter>(); break;
+            case MetricType::Gauge: created.gauge = std::make_unique<Gauge>(); break;
+            case MetricType::Histogram: created.histogram = std::make_unique<Histogram>(); break;
+        }
+        return created;
+    }
+
+    mutable std::mutex mutex_;
+    std::deque<Family> families_;   // Registration order, which is also export order
+};
+
+MetricsRegistry& MetricsRegistry::global() {
+    static MetricsRegistry* registry = new MetricsRegistry();
+    return *registry;
+}
+
+MetricsRegistry::MetricsRegistry() : impl_(std::make_unique<Impl>()) {}
+
+MetricsRegistry::~MetricsRegistry() = default;
+
+Counter& MetricsRegistry::counter(const std::string& name, const std::string& help, const std::string& labels) {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    return *impl_->find(name, help, labels, MetricType::Counter).counter;
+}
+
+Gauge& MetricsRegistry::gauge(const std::string& name, const std::string& help, const std::string& labels) {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    return *impl_->find(name, help, labels, MetricType::Gauge).gauge;
+}
+
+Histogram& MetricsRegistry::histogram(const std::string& name, const std::string& help, const std::string& labels) {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    return *impl_->find(name, help, labels, MetricType::Histogram).histogram;
+}
+
+std::string MetricsRegistry::prometheus_text() const {
+    std::ostringstream out;
+    out.precision(9);
+
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    for (const auto& family : impl_->families_) {
+        out << "# HELP " << family.name << " " << family.help << "\n";
+        out << "# TYPE " << family.name << " " << type_name(family.type) << "\n";
+
+        for (const auto& entry : family.series) {
+            switch (family.type) {
+                case MetricType::Counter:
+                    out << series(family.name, entry.labels) << " " << entry.counter->value() << "\n";
+                    break;
+                case MetricType::Gauge:
+                    out << series(family.name, entry.labels) << " " << entry.gauge->value() << "\n";
+                    break;
+                case MetricType::Histogram: {
+                    const auto snapshot = entry.histogram->snapshot();
+                    for (const auto& bound : BUCKET_BOUNDS) {
+                        out << series(family.name + "_bucket", entry.labels, std::string("le=\"") + bound.label + "\"")
+                            << " " << snapshot.count_at_or_below(bound.nanoseconds) << "\n";
+                    }
+                    out << series(family.name + "_bucket", entry.labels, "le=\"+Inf\"") << " "
+                        << snapshot.count() << "\n";
+                    out << series(family.name + "_sum", entry.labels) << " "
+                        << static_cast<double>(entry.histogram->sum()) / 1e9 << "\n";
+                    out << series(family.name + "_count", entry.labels) << " " << snapshot.count() << "\n";
+                    break;
+                }
+            }
+        }
+    }
+    return out.str();
+}
+
+bool MetricsRegistry::write_prometheus(const std::string& path) const {
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+        file << prometheus_text();
+        if (!file.flush()) {
+            return false;
+        }
+    }
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+void MetricsRegistry::reset() {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    for (auto& family : impl_->families_) {
+        for (auto& entry : family.series) {
+            if (entry.counter) {
+                entry.counter->reset();
+            }
+            if (entry.gauge) {
+                entry.gauge->set(0);
+            }
+            if (entry.histogram) {
+                entry.histogram->reset();
+            }
+        }
+    }
+}
+
+PipelineMetrics& PipelineMetrics::get() {
+    static PipelineMetrics* metrics = [] {
+        auto& registry = MetricsRegistry::global();
+        return new PipelineMetrics{
+            registry.histogram("chimera_encode_duration_seconds", "Steganographic encoding time per payload"),
+            registry.histogram("chimera_compress_duration_seconds", "Payload compression time"),
+            registry.histogram("chimera_crypto_duration_seconds", "Session encryption time per payload"),
+            registry.histogram("chimera_queue_wait_seconds", "Async request wait between submit and processing"),
+            registry.histogram("chimera_transport_send_duration_seconds", "Transport send time per query"),
+            registry.histogram("chimera_rtt_seconds", "Query round-trip time"),
+            registry.counter("chimera_retries_total", "Reconnects and re-routed sends"),
+            registry.counter("chimera_timeouts_total", "Queries that timed out waiting for a response"),
+            registry.counter("chimera_send_errors_total", "Failed transport sends"),
+            registry.counter("chimera_sent_bytes_total", "Query bytes handed to the transport"),
+            registry.counter("chimera_fragments_sent_total", "Payload fragments sent"),
+            registry.gauge("chimera_async_pending", "Async requests submitted and not yet completed"),
+        };
+    }();
+    return *metrics;
+}
+
+class MetricsExporter::Impl {
+public:
+    Impl(MetricsRegistry& registry, MetricsExportOptions options)
+        : registry_(registry), options_(std::move(options)) {}
+
+    ~Impl() {
+        stop();
+        if (listen_fd_ >= 0) {
+            close(listen_fd_);
+            unlink(options_.socket_path.c_str());
+        }
+    }
+
+    void bind_socket() {
+        if (options_.socket_path.empty()) {
+            return;
+        }
+        sockaddr_un address{};
+        if (options_.socket_path.size() >= sizeof(address.sun_path)) {
+            throw std::runtime_error("Metrics socket path too long: " + options_.socket_path);
+        }
+        address.sun_family = AF_UNIX;
+        options_.socket_path.copy(address.sun_path, sizeof(address.sun_path) - 1);
+
+        // A socket left behind by a crashed process would make bind() fail
+        struct stat info{};
+        if (lstat(options_.socket_path.c_str(), &info) == 0 && S_ISSOCK(info.st_mode)) {
+            unlink(options_.socket_path.c_str());
+        }
+
+        listen_fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (listen_fd_ < 0) {
+            throw std::runtime_error("Metrics socket creation failed");
+        }
+        if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+            listen(listen_fd_, 8) != 0) {
+            close(listen_fd_);
+            listen_fd_ = -1;
+            throw std::runtime_error("Metrics socket bind failed: " + options_.socket_path);
+        }
+    }
+
+    void start() {
+        if (running_.exchange(true)) {
+            return;
+        }
+        thread_ = std::thread([this] { run(); });
+    }
+
+    void stop() {
+        if (!running_.exchange(false)) {
+            return;
+        }
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+        if (!options_.file_path.empty()) {
+            registry_.write_prometheus(options_.file_path);
+        }
+    }
+
+private:
+    void run() {
+        // Short poll so stop() is noticed promptly without a wakeup pipe
+        constexpr auto tick = std::chrono::milliseconds(100);
+        auto next_write = std::chrono::steady_clock::now();
+
+        while (running_.load()) {
+            const auto now = std::chrono::steady_clock::now();
+            if (!options_.file_path.empty() && now >= next_write) {
+                registry_.write_prometheus(options_.file_path);
+                next_write = now + options_.file_interval;
+            }
+
+            if (listen_fd_ < 0) {
+                std::this_thread::sleep_for(tick);
+                continue;
+            }
+            pollfd entry{listen_fd_, POLLIN, 0};
+            if (poll(&entry, 1, static_cast<int>(tick.count())) > 0 && (entry.revents & POLLIN)) {
+                serve();
+            }
+        }
+    }
+
+    void serve() {
+        const int client = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client < 0) {
+            return;
+        }
+        const std::string text = registry_.prometheus_text();
+        size_t offset = 0;
+        while (offset < text.size()) {
+            const ssize_t written = send(client, text.data() + offset, text.size() - offset, MSG_NOSIGNAL);
+            if (written < 0 && errno == EINTR) {
+                continue;
+            }
+            if (written <= 0) {
+                break;
+            }
+            offset += static_cast<size_t>(written);
+        }
+        close(client);
+    }
+
+    MetricsRegistry& registry_;
+    MetricsExportOptions options_;
+    int listen_fd_ = -1;
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+};
+
+MetricsExporter::MetricsExporter(MetricsRegistry& registry, MetricsExportOptions options)
+    : impl_(std::make_unique<Impl>(registry, std::move(options))) {
+    impl_->bind_socket();
+}
+
+MetricsExporter::~MetricsExporter() = default;
+
+void MetricsExporter::start() {
+    impl_->start();
+}
+
+void MetricsExporter::stop() {
+    impl_->stop();
+}
+
+} // namespace chimera
@@ -0,0 +1,268 @@
+#include "chimera/rekeying.hpp"
+#include <sodium.h>
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <iterator>
+#include <thread>
+
+namespace chimera {
+
+class RekeyingSession::Impl {
+    using Clock = std::chrono::steady_clock;
+
+    // How far ahead of the current epoch a peer's fragment may be; covers a
+    // peer that switched twice before its first new-epoch fragment arrived
+    static constexpr uint32_t MAX_EPOCH_LOOKAHEAD = 2;
+
+    struct Epoch {
+        std::shared_ptr<AEADSession> session;
+        Clock::time_point retire_at;     // max() while current or prepared
+    };
+
+    const SessionRole role_;
+    const CipherSuite suite_;
+    const RekeyPolicy policy_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::map<uint32_t, Epoch> epochs_;
+    uint32_t current_ = 0;
+    Clock::time_point epoch_started_;
+    std::atomic<uint64_t> epoch_bytes_{0};
+    bool rekey_requested_ = false;
+    bool running_ = false;
+    std::thread worker_;
+
+    // Key chain; only the newest chain key is kept so old epochs cannot be rederived
+    std::mutex chain_mutex_;
+    CryptoKey chain_key_;
+    uint32_t chain_epoch_ = 0;
+
+public:
+    Impl(const CryptoKey& session_key, SessionRole role, CipherSuite suite, RekeyPolicy policy)
+        : role_(role), suite_(suite), policy_(policy),
+          epoch_started_(Clock::now()), chain_key_(session_key) {
+        epochs_.emplace(0, Epoch{std::make_shared<AEADSession>(session_key, role, suite), Clock::time_point::max()});
+    }
+
+    ~Impl() {
+        stop();
+    }
+
+    void start() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (running_) {
+            return;
+        }
+        running_ = true;
+        worker_ = std::thread([this]() { worker_loop(); });
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!running_) {
+                return;
+            }
+            running_ = false;
+        }
+        cv_.notify_all();
+        if (worker_.joinable()) {
+            worker_.join();
+        }
+    }
+
+    tl::expected<FragmentKeyId, CryptoError> seal(std::vector<uint8_t>& fragment, const AssociatedData& ad) {
+        std::shared_ptr<AEADSession> session;
+        uint32_t epoch;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (switch_due_locked() && !activate_locked(current_ + 1)) {
+                if (running_) {
+                    // Keep sealing under the current epoch until the worker catches up
+                    cv_.notify_one();
+                } else {
+                    const uint32_t next = current_ + 1;
+                    lock.unlock();
+                    prepare_through(next);
+                    lock.lock();
+                    activate_locked(next);
+                }
+            }
+            session = epochs_.at(current_).session;
+            epoch = current_;
+        }
+
+        const size_t length = fragment.size();
+        auto sequence = session->seal_next(fragment, ad);
+        if (!sequence) {
+            return tl::unexpected(sequence.error());
+        }
+        epoch_bytes_.fetch_add(length, std::memory_order_relaxed);
+        return FragmentKeyId{.epoch = epoch, .sequence = sequence.value()};
+    }
+
+    tl::expected<void, CryptoError> open(std::vector<uint8_t>& fragment, const FragmentKeyId& id,
+                                         const AssociatedData& ad) {
+        std::shared_ptr<AEADSession> session;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            auto it = epochs_.find(id.epoch);
+            if (it == epochs_.end() && id.epoch > current_ && id.epoch - current_ <= MAX_EPOCH_LOOKAHEAD) {
+                // Peer switched before the epoch was prepared here
+                lock.unlock();
+                prepare_through(id.epoch);
+                lock.lock();
+                it = epochs_.find(id.epoch);
+            }
+            if (it == epochs_.end() || Clock::now() >= it->second.retire_at) {
+                return tl::unexpected(CryptoError::KeyExpired);
+            }
+            session = it->second.session;
+        }
+
+        auto opened = session->open(fragment, id.sequence, ad);
+        if (!opened) {
+            return opened;
+        }
+
+        // Only an authenticated fragment may move this side forward
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (id.epoch > current_) {
+            activate_locked(id.epoch);
+        }
+        return {};
+    }
+
+    void request_rekey() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        rekey_requested_ = true;
+    }
+
+    uint32_t current_epoch() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return current_;
+    }
+
+    size_t live_epochs() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto now = Clock::now();
+        size_t live = 0;
+        for (const auto& [number, epoch] : epochs_) {
+            if (now < epoch.retire_at) {
+                ++live;
+            }
+        }
+        return live;
+    }
+
+private:
+    bool switch_due_locked() const {
+        return rekey_requested_ ||
+               epoch_bytes_.load(std::memory_order_relaxed) >= policy_.max_bytes ||
+               Clock::now() - epoch_started_ >= policy_.max_age;
+    }
+
+    // Make a prepared epoch current; older epochs enter the overlap window
+    bool activate_locked(uint32_t next) {
+        if (epochs_.find(next) == epochs_.end()) {
+            return false;
+        }
+
+        const auto now = Clock::now();
+        for (auto& [number, epoch] : epochs_) {
+            if (number < next && epoch.retire_at == Clock::time_point::max()) {
+                epoch.retire_at = now + policy_.overlap;
+            }
+        }
+        purge_locked(now);
+
+        current_ = next;
+        epoch_started_ = now;
+        epoch_bytes_.store(0, std::memory_order_relaxed);
+        rekey_requested_ = false;
+        cv_.notify_one();
+        return true;
+    }
+
+    void purge_locked(Clock::time_point now) {
+        for (auto it = epochs_.begin(); it != epochs_.end();) {
+            it = now >= it->second.retire_at ? epochs_.erase(it) : std::next(it);
+        }
+    }
+
+    // Advance the key chain until `target` has been derived
+    void prepare_through(uint32_t target) {
+        std::lock_guard<std::mutex> chain_lock(chain_mutex_);
+        while (chain_epoch_ < target) {
+            CryptoKey next_key(crypto_kdf_blake2b_KEYBYTES);
+            if (crypto_kdf_blake2b_derive_from_key(next_key.data(), next_key.size(), chain_epoch_ + 1,
+                                                   "CHMREKEY", chain_key_.data()) != 0) {
+                return;
+            }
+            auto session = std::make_shared<AEADSession>(next_key, role_, suite_);
+            chain_key_ = std::move(next_key);
+            ++chain_epoch_;
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            epochs_.emplace(chain_epoch_, Epoch{std::move(session), Clock::time_point::max()});
+        }
+    }
+
+    void worker_loop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (running_) {
+            if (epochs_.find(current_ + 1) == epochs_.end()) {
+                const uint32_t next = current_ + 1;
+                lock.unlock();
+                prepare_through(next);
+                lock.lock();
+                continue;
+            }
+            purge_locked(Clock::now());
+            cv_.wait_for(lock, policy_.overlap, [this]() {
+                return !running_ || epochs_.find(current_ + 1) == epochs_.end();
+            });
+        }
+    }
+};
+
+RekeyingSession::RekeyingSession(const CryptoKey& session_key, SessionRole role,
+                                 CipherSuite suite, RekeyPolicy policy)
+    : impl_(std::make_unique<Impl>(session_key, role, suite, policy)) {}
+
+RekeyingSession::~RekeyingSession() = default;
+
+void RekeyingSession::start() {
+    impl_->start();
+}
+
+void RekeyingSession::stop() {
+    impl_->stop();
+}
+
+tl::expected<FragmentKeyId, CryptoError> RekeyingSession::seal(std::vector<uint8_t>& fragment,
+                                                               const AssociatedData& ad) {
+    return impl_->seal(fragment, ad);
+}
+
+tl::expected<void, CryptoError> RekeyingSession::open(std::vector<uint8_t>& fragment, const FragmentKeyId& id,
+                                                      const AssociatedData& ad) {
+    return impl_->open(fragment, id, ad);
+}
+
+void RekeyingSession::request_rekey() {
+    impl_->request_rekey();
+}
+
+uint32_t RekeyingSession::current_epoch() const {
+    return impl_->current_epoch();
+}
+
+size_t RekeyingSession::live_epochs() const {
+    return impl_->live_epochs();
+}
+
+} // namespace chimera
@@ -0,0 +1,137 @@
+#include "chimera/secure_memory.hpp"
+#include <sodium.h>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+
+namespace chimera {
+
+class SecureArena::Impl {
+    // Free list of fixed-size slots for one size class
+    struct SizeClass {
+        size_t slot_bytes = 0;
+        std::vector<uint8_t*> free_slots;
+        std::mutex mutex;
+    };
+
+    SizeClass classes_[std::size(SIZE_CLASSES)];
+    std::vector<void*> slabs_;
+    mutable std::mutex slabs_mutex_;
+    size_t slots_in_use_ = 0;
+    size_t large_in_use_ = 0;
+
+public:
+    Impl() {
+        if (sodium_init() < 0) {
+            throw std::runtime_error("Sodium initialization failed");
+        }
+        for (size_t i = 0; i < std::size(SIZE_CLASSES); ++i) {
+            classes_[i].slot_bytes = SIZE_CLASSES[i];
+        }
+    }
+
+    void* allocate(size_t bytes) {
+        SizeClass* size_class = class_for(bytes);
+        if (!size_class) {
+            void* ptr = sodium_malloc(bytes);
+            if (!ptr) {
+                throw std::bad_alloc();
+            }
+            std::lock_guard<std::mutex> lock(slabs_mutex_);
+            ++large_in_use_;
+            return ptr;
+        }
+
+        std::lock_guard<std::mutex> lock(size_class->mutex);
+        if (size_class->free_slots.empty()) {
+            refill(*size_class);
+        }
+        uint8_t* slot = size_class->free_slots.back();
+        size_class->free_slots.pop_back();
+
+        std::lock_guard<std::mutex> stats_lock(slabs_mutex_);
+        ++slots_in_use_;
+        return slot;
+    }
+
+    void deallocate(void* ptr, size_t bytes) noexcept {
+        if (!ptr) {
+            return;
+        }
+
+        SizeClass* size_class = class_for(bytes);
+        if (!size_class) {
+            // sodium_free wipes the region before unmapping it
+            sodium_free(ptr);
+            std::lock_guard<std::mutex> lock(slabs_mutex_);
+            --large_in_use_;
+            return;
+        }
+
+        sodium_memzero(ptr, size_class->slot_bytes);
+        std::lock_guard<std::mutex> lock(size_class->mutex);
+        size_class->free_slots.push_back(static_cast<uint8_t*>(ptr));
+
+        std::lock_guard<std::mutex> stats_lock(slabs_mutex_);
+        --slots_in_use_;
+    }
+
+    Stats stats() const {
+        std::lock_guard<std::mutex> lock(slabs_mutex_);
+        return Stats{
+            .slabs = slabs_.size(),
+            .slots_in_use = slots_in_use_,
+            .large_in_use = large_in_use_
+        };
+    }
+
+private:
+    SizeClass* class_for(size_t bytes) {
+        for (auto& size_class : classes_) {
+            if (bytes <= size_class.slot_bytes) {
+                return &size_class;
+            }
+        }
+        return nullptr;
+    }
+
+    // Caller holds size_class.mutex
+    void refill(SizeClass& size_class) {
+        // One guard-paged, mlock'ed slab is split into slots for this class
+        auto* slab = static_cast<uint8_t*>(sodium_malloc(SLAB_BYTES));
+        if (!slab) {
+            throw std::bad_alloc();
+        }
+        sodium_memzero(slab, SLAB_BYTES);
+
+        const size_t slots = SLAB_BYTES / size_class.slot_bytes;
+        size_class.free_slots.reserve(size_class.free_slots.size() + slots);
+        for (size_t i = slots; i > 0; --i) {
+            size_class.free_slots.push_back(slab + (i - 1) * size_class.slot_bytes);
+        }
+
+        std::lock_guard<std::mutex> lock(slabs_mutex_);
+        slabs_.push_back(slab);
+    }
+};
+
+SecureArena::SecureArena() : impl_(new Impl()) {}
+
+SecureArena& SecureArena::instance() {
+    static SecureArena* arena = new SecureArena();
+    return *arena;
+}
+
+void* SecureArena::allocate(size_t bytes) {
+    return impl_->allocate(bytes);
+}
+
+void SecureArena::deallocate(void* ptr, size_t bytes) noexcept {
+    impl_->deallocate(ptr, bytes);
+}
+
+SecureArena::Stats SecureArena::stats() const {
+    return impl_->stats();
+}
+
+} // namespace chimera
@@ -0,0 +1,240 @@
+#include "chimera/session_resumption.hpp"
+#include <sodium.h>
+#include <stdexcept>
+
+namespace chimera {
+
+namespace {
+
+constexpr uint8_t TICKET_VERSION = 1;
+constexpr size_t SECRET_BYTES = 32;
+constexpr char SESSION_LABEL[] = "CHIMERA resumed session";
+
+AssociatedData ticket_ad() {
+    const std::string label = "CHIMERA ticket";
+    AssociatedData ad(label.begin(), label.end());
+    ad.push_back(TICKET_VERSION);
+    return ad;
+}
+
+void write_uint64(std::vector<uint8_t>& out, uint64_t value) {
+    for (int shift = 56; shift >= 0; shift -= 8) {
+        out.push_back(static_cast<uint8_t>((value >> shift) & 0xFF));
+    }
+}
+
+uint64_t read_uint64(const uint8_t* data) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value = (value << 8) | data[i];
+    }
+    return value;
+}
+
+uint64_t unix_seconds(std::chrono::system_clock::time_point tp) {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::seconds>(tp.time_since_epoch()).count());
+}
+
+std::vector<uint8_t> random_nonce() {
+    std::vector<uint8_t> nonce(SessionResumption::NONCE_BYTES);
+    randombytes_buf(nonce.data(), nonce.size());
+    return nonce;
+}
+
+} // namespace
+
+// Key derivation
+tl::expected<SharedSecret, CryptoError> SessionResumption::derive_resumption_secret(
+    const SharedSecret& handshake_secret) {
+
+    if (handshake_secret.empty()) {
+        return tl::unexpected(CryptoError::InvalidKeyOrNonce);
+    }
+
+    // Hash the full hybrid secret so both the X25519 and ML-KEM halves contribute
+    unsigned char prk[crypto_generichash_BYTES];
+    if (crypto_generichash(prk, sizeof(prk), handshake_secret.data(), handshake_secret.size(),
+                           nullptr, 0) != 0) {
+        return tl::unexpected(CryptoError::KeyGenerationFailed);
+    }
+
+    SharedSecret resumption_secret(SECRET_BYTES);
+    const int result = crypto_kdf_blake2b_derive_from_key(
+        resumption_secret.data(), resumption_secret.size(), 1, "CHMRESUM", prk);
+    sodium_memzero(prk, sizeof(prk));
+
+    if (result != 0) {
+        return tl::unexpected(CryptoError::KeyGenerationFailed);
+    }
+    return resumption_secret;
+}
+
+tl::expected<CryptoKey, CryptoError> SessionResumption::derive_session_key(
+    const SharedSecret& resumption_secret,
+    const std::vector<uint8_t>& client_nonce,
+    const std::vector<uint8_t>& server_nonce) {
+
+    if (resumption_secret.size() != SECRET_BYTES ||
+        client_nonce.size() != NONCE_BYTES ||
+        server_nonce.size() != NONCE_BYTES) {
+        return tl::unexpected(CryptoError::InvalidKeyOrNonce);
+    }
+
+    std::vector<uint8_t> transcript(SESSION_LABEL, SESSION_LABEL + sizeof(SESSION_LABEL) - 1);
+    transcript.insert(transcript.end(), client_nonce.begin(), client_nonce.end());
+    transcript.insert(transcript.end(), server_nonce.begin(), server_nonce.end());
+
+    CryptoKey session_key(crypto_aead_chacha20poly1305_ietf_KEYBYTES);
+    if (crypto_generichash(session_key.data(), session_key.size(),
+                           transcript.data(), transcript.size(),
+                           resumption_secret.data(), resumption_secret.size()) != 0) {
+        return tl::unexpected(CryptoError::KeyGenerationFailed);
+    }
+    return session_key;
+}
+
+tl::expected<CryptoKey, CryptoError> PendingResumption::complete(const ResumptionResponse& response) const {
+    return SessionResumption::derive_session_key(resumption_secret, request.client_nonce, response.server_nonce);
+}
+
+// Ticket issuer implementation
+SessionTicketIssuer::SessionTicketIssuer(std::chrono::seconds lifetime) : lifetime_(lifetime) {
+    if (sodium_init() < 0) {
+        throw std::runtime_error("Sodium initialization failed");
+    }
+    auto key = AEAD::generate_key();
+    if (!key) {
+        throw std::runtime_error("Ticket key generation failed");
+    }
+    ticket_key_ = std::move(key.value());
+}
+
+tl::expected<std::vector<uint8_t>, CryptoError> SessionTicketIssuer::issue(
+    const SharedSecret& handshake_secret) const {
+
+    auto resumption_secret = SessionResumption::derive_resumption_secret(handshake_secret);
+    if (!resumption_secret) {
+        return tl::unexpected(resumption_secret.error());
+    }
+
+    // Sealed contents: resumption secret || expiry (unix seconds)
+    Plaintext contents(resumption_secret->begin(), resumption_secret->end());
+    write_uint64(contents, unix_seconds(std::chrono::system_clock::now() + lifetime_));
+
+    auto sealed = AEAD::encrypt(contents, ticket_key_, ticket_ad());
+    sodium_memzero(contents.data(), contents.size());
+    if (!sealed) {
+        return tl::unexpected(sealed.error());
+    }
+
+    // Ticket layout: version || nonce || ciphertext
+    std::vector<uint8_t> ticket;
+    ticket.reserve(1 + sealed->nonce.size() + sealed->data.size());
+    ticket.push_back(TICKET_VERSION);
+    ticket.insert(ticket.end(), sealed->nonce.begin(), sealed->nonce.end());
+    ticket.insert(ticket.end(), sealed->data.begin(), sealed->data.end());
+    return ticket;
+}
+
+tl::expected<std::pair<ResumptionResponse, CryptoKey>, CryptoError> SessionTicketIssuer::accept(
+    const ResumptionRequest& request) const {
+
+    constexpr size_t nonce_bytes = crypto_aead_chacha20poly1305_ietf_NPUBBYTES;
+    const auto& ticket = request.ticket;
+    if (ticket.size() <= 1 + nonce_bytes || ticket[0] != TICKET_VERSION) {
+        return tl::unexpected(CryptoError::InvalidTicket);
+    }
+
+    EncryptedPacket sealed{
+        .data = Ciphertext(ticket.begin() + 1 + nonce_bytes, ticket.end()),
+        .nonce = Nonce(ticket.begin() + 1, ticket.begin() + 1 + nonce_bytes)
+    };
+
+    auto contents = AEAD::decrypt(sealed, ticket_key_, ticket_ad());
+    if (!contents || contents->size() != SECRET_BYTES + 8) {
+        return tl::unexpected(CryptoError::InvalidTicket);
+    }
+
+    const uint64_t expiry = read_uint64(contents->data() + SECRET_BYTES);
+    SharedSecret resumption_secret(contents->begin(), contents->begin() + SECRET_BYTES);
+    sodium_memzero(contents->data(), contents->size());
+
+    if (unix_seconds(std::chrono::system_clock::now()) >= expiry) {
+        return tl::unexpected(CryptoError::TicketExpired);
+    }
+
+    ResumptionResponse response{.server_nonce = random_nonce()};
+    auto session_key = SessionResumption::derive_session_key(
+        resumption_secret, request.client_nonce, response.server_nonce);
+    sodium_memzero(resumption_secret.data(), resumption_secret.size());
+
+    if (!session_key) {
+        return tl::unexpected(session_key.error());
+    }
+    return std::make_pair(std::move(response), std::move(session_key.value()));
+}
+
+// Client cache implementation
+tl::expected<void, CryptoError> ResumptionCache::store(
+    const std::string& server_id,
+    const SharedSecret& handshake_secret,
+    std::vector<uint8_t> ticket,
+    std::chrono::seconds lifetime) {
+
+    auto resumption_secret = SessionResumption::derive_resumption_secret(handshake_secret);
+    if (!resumption_secret) {
+        return tl::unexpected(resumption_secret.error());
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_[server_id] = Entry{
+        .ticket = std::move(ticket),
+        .resumption_secret = std::move(resumption_secret.value()),
+        .expiry = std::chrono::steady_clock::now() + lifetime
+    };
+    return {};
+}
+
+std::optional<PendingResumption> ResumptionCache::resume(const std::string& server_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(server_id);
+    if (it == entries_.end()) {
+        return std::nullopt;
+    }
+
+    Entry entry = std::move(it->second);
+    entries_.erase(it);
+    if (std::chrono::steady_clock::now() >= entry.expiry) {
+        sodium_memzero(entry.resumption_secret.data(), entry.resumption_secret.size());
+        return std::nullopt;
+    }
+
+    return PendingResumption{
+        .request = ResumptionRequest{
+            .ticket = std::move(entry.ticket),
+            .client_nonce = random_nonce()
+        },
+        .resumption_secret = std::move(entry.resumption_secret)
+    };
+}
+
+void ResumptionCache::purge_expired() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto now = std::chrono::steady_clock::now();
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        if (now >= it->second.expiry) {
+            sodium_memzero(it->second.resumption_secret.data(), it->second.resumption_secret.size());
+            it = entries_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+size_t ResumptionCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+} // namespace chimera
@@ -1,14 +1,30 @@
 #include "chimera/steganography.hpp"
 #include "chimera/base64.hpp"
+#include "chimera/metrics.hpp"
+#include "chimera/probes.hpp"
 #include <algorithm>
+#include <charconv>
+#include <string_view>
 #include <random>
 #include <chrono>
 #include <sstream>
 #include <iomanip>
+#include <cstring>
 #include <zlib.h>
 
 namespace chimera {
 
+    namespace {
+
+        // Lower-case hex, as std::hex printed it; avoids a stream per fragment
+        void append_hex(std::string& out, uint32_t value) {
+            char digits[8];
+            const auto result = std::to_chars(digits, digits + sizeof(digits), value, 16);
+            out.append(digits, result.ptr);
+        }
+
+    } // namespace
+
     // IPv4 encoding implementation
     std::vector<uint8_t> IPv4Encoding::encode_to_ipv4(const std::vector<uint8_t>& payload, size_t offset) {
         std::vector<uint8_t> ipv4(4, 0);
@@ -78,32 +94,47 @@ namespace chimera {
     }
 
     // TXT encoding implementation
-    std::vector<std::string> TXTEncoding::encode_to_txt_fragments(const std::vector<uint8_t>& payload) {
+    size_t TXTEncoding::chunk_size_for(size_t max_txt_length) {
+        // Leave room for the "v=spf1 ...; frag=<id>=" metadata prefix
+        constexpr size_t metadata_reserve = 55;
+        constexpr size_t single_string_chunk = 200;
+        // Header, a maximum-length question and a compressed answer RR header
+        constexpr size_t message_overhead = 12 + (255 + 4) + (2 + 10);
+        if (max_txt_length <= single_string_chunk + metadata_reserve) {
+            return single_string_chunk;
+        }
+        // One record must still fit a TCP message, or write_txt_data throws at send time
+        const size_t txt_limit = DnsPacketBuilder::txt_capacity(DNS_TCP_MESSAGE_LIMIT - message_overhead);
+        // Ensure chunks are multiples of 4 for valid base64
+        return ((std::min(max_txt_length, txt_limit) - metadata_reserve) / 4) * 4;
+    }
+
+    std::vector<std::string> TXTEncoding::encode_to_txt_fragments(const std::vector<uint8_t>& payload,
+                                                                  size_t max_txt_length) {
         std::vector<std::string> fragments;
         
         // Base64 encode the payload
         std::string encoded = Base64::encode(std::string(payload.begin(), payload.end()));
         
-        // Split into TXT-record sized chunks (max 255 bytes per TXT record)
-        // Ensure chunks are multiples of 4 for valid base64
-        const size_t max_chunk_size = 200; // Leave room for fragment metadata
-        const size_t chunk_size = (max_chunk_size / 4) * 4; // Round down to multiple of 4
+        // Split into TXT-record sized chunks; each record may hold several character-strings
+        const size_t chunk_size = chunk_size_for(max_txt_length);
+        fragments.reserve((encoded.length() + chunk_size - 1) / chunk_size);
         
+        std::vector<uint8_t> chunk;   // Reused for every fragment
         for (size_t i = 0; i < encoded.length(); i += chunk_size) {
             size_t actual_chunk_size = std::min(chunk_size, encoded.length() - i);
-            std::string chunk = encoded.substr(i, actual_chunk_size);
+            chunk.assign(encoded.begin() + i, encoded.begin() + i + actual_chunk_size);
             
             // Pad the chunk if it's the last one and not a multiple of 4
-            if (i + actual_chunk_size >= encoded.length() && chunk.length() % 4 != 0) {
-                while (chunk.length() % 4 != 0) {
-                    chunk += '=';
+            if (i + actual_chunk_size >= encoded.length() && chunk.size() % 4 != 0) {
+                while (chunk.size() % 4 != 0) {
+                    chunk.push_back('=');
                 }
             }
             
             // Add fragment metadata
             uint32_t fragment_id = static_cast<uint32_t>(fragments.size());
-            fragments.push_back(create_steganographic_txt(
-                std::vector<uint8_t>(chunk.begin(), chunk.end()), fragment_id));
+            fragments.push_back(create_steganographic_txt(chunk, fragment_id));
         }
         
         return fragments;
@@ -139,11 +170,15 @@ namespace chimera {
     }
 
     std::string TXTEncoding::create_steganographic_txt(const std::vector<uint8_t>& chunk, uint32_t fragment_id) {
-        std::ostringstream oss;
-        oss << "v=spf1 include:_spf.google.com ~all; frag=" << std::hex << fragment_id << "=";
-        // The chunk is already base64-encoded data, so convert it back to string
-        oss << std::string(chunk.begin(), chunk.end());
-        return oss.str();
+        static constexpr std::string_view prefix = "v=spf1 include:_spf.google.com ~all; frag=";
+        std::string txt;
+        txt.reserve(prefix.size() + 9 + chunk.size());
+        txt.append(prefix);
+        append_hex(txt, fragment_id);
+        txt += '=';
+        // The chunk is already base64-encoded data
+        txt.append(chunk.begin(), chunk.end());
+        return txt;
     }
 
     // HTTP/2 encoding implementation
@@ -196,42 +231,56 @@ namespace chimera {
 
     // Main encoder implementation
     tl::expected<std::vector<EncodedFragment>, SteganographyError> 
-    SteganographicEncoder::encode_payload(const std::vector<uint8_t>& payload, const std::string& base_domain) const {
+    SteganographicEncoder::encode_payload(const std::vector<uint8_t>& payload, const std::string& base_domain,
+                                          std::chrono::nanoseconds* compress_time) const {
         
         if (payload.empty()) {
             return tl::unexpected(SteganographyError::PayloadTooLarge);
         }
+        CHIMERA_PROBE1(encode_start, payload.size());
 
         // Compress payload if enabled
+        const auto compress_start = std::chrono::steady_clock::now();
         std::vector<uint8_t> processed_payload = config_.use_compression ? 
             compress_payload(payload) : payload;
+        if (compress_time) {
+            *compress_time = config_.use_compression ? std::chrono::steady_clock::now() - compress_start
+                                                     : std::chrono::nanoseconds(0);
+        }
 
         // Route to appropriate encoding strategy
+        tl::expected<std::vector<EncodedFragment>, SteganographyError> fragments =
+            tl::unexpected(SteganographyError::EncodingError);
         switch (config_.strategy) {
             case EncodingStrategy::TXT_ONLY:
-                return encode_txt_only(processed_payload, base_domain);
+                fragments = encode_txt_only(processed_payload, base_domain);
+                break;
             case EncodingStrategy::MULTI_RECORD:
-                return encode_multi_record(processed_payload, base_domain);
+                fragments = encode_multi_record(processed_payload, base_domain);
+                break;
             case EncodingStrategy::DISTRIBUTED:
-                return encode_distributed(processed_payload, base_domain);
+                fragments = encode_distributed(processed_payload, base_domain);
+                break;
             case EncodingStrategy::HTTP2_BODY:
                 // HTTP2 encoding returns different format, handle separately
                 break;
         }
 
-        return tl::unexpected(SteganographyError::EncodingError);
+        CHIMERA_PROBE3(encode_done, payload.size(), fragments ? fragments->size() : 0, fragments.has_value());
+        return fragments;
     }
 
     tl::expected<std::vector<EncodedFragment>, SteganographyError>
     SteganographicEncoder::encode_txt_only(const std::vector<uint8_t>& payload, const std::string& base_domain) const {
         
         std::vector<EncodedFragment> fragments;
-        auto txt_fragments = TXTEncoding::encode_to_txt_fragments(payload);
+        auto txt_fragments = TXTEncoding::encode_to_txt_fragments(payload, config_.max_txt_length);
+        fragments.reserve(txt_fragments.size());
         
         for (size_t i = 0; i < txt_fragments.size(); ++i) {
             EncodedFragment fragment;
             fragment.record_type = DnsType::TXT;
-            fragment.domain = generate_steganographic_subdomain(static_cast<uint32_t>(i), DnsType::TXT) + "." + base_domain;
+            fragment.domain = fragment_domain(static_cast<uint32_t>(i), DnsType::TXT, base_domain);
             fragment.encoded_data = std::vector<uint8_t>(txt_fragments[i].begin(), txt_fragments[i].end());
             fragment.fragment_id = static_cast<uint32_t>(i);
             fragment.total_fragments = static_cast<uint32_t>(txt_fragments.size());
@@ -247,6 +296,9 @@ namespace chimera {
     SteganographicEncoder::encode_multi_record(const std::vector<uint8_t>& payload, const std::string& base_domain) const {
         
         std::vector<EncodedFragment> fragments;
+        // One A, AAAA and TXT fragment per cycle
+        const size_t cycles = payload.size() / (4 + 16 + txt_chunk_bytes()) + 1;
+        fragments.reserve(std::min(config_.max_fragments, cycles * 3));
         size_t offset = 0;
         uint32_t fragment_id = 0;
         
@@ -267,11 +319,11 @@ namespace chimera {
                     break;
                 case 2: // TXT record - larger chunks
                     record_type = DnsType::TXT;
-                    chunk_size = std::min(static_cast<size_t>(200), payload.size() - offset);
+                    chunk_size = std::min(txt_chunk_bytes(), payload.size() - offset);
                     break;
                 default:
                     record_type = DnsType::TXT;
-                    chunk_size = 200;
+                    chunk_size = txt_chunk_bytes();
                     break;
             }
             
@@ -279,12 +331,10 @@ namespace chimera {
             
             EncodedFragment fragment;
             fragment.record_type = record_type;
-            fragment.domain = generate_steganographic_subdomain(fragment_id, record_type) + "." + base_domain;
+            fragment.domain = fragment_domain(fragment_id, record_type, base_domain);
             fragment.fragment_id = fragment_id;
             
             // Encode based on record type
-            std::vector<uint8_t> chunk(payload.begin() + offset, payload.begin() + offset + chunk_size);
-            
             switch (record_type) {
                 case DnsType::A:
                     fragment.encoded_data = IPv4Encoding::encode_to_ipv4(payload, offset);
@@ -295,7 +345,8 @@ namespace chimera {
                 case DnsType::TXT:
                     {
                         // Base64 encode the raw chunk first
-                        std::string encoded_chunk = Base64::encode(std::string(chunk.begin(), chunk.end()));
+                        std::string encoded_chunk = Base64::encode(
+                            std::string(payload.begin() + offset, payload.begin() + offset + chunk_size));
                         std::string txt = TXTEncoding::create_steganographic_txt(
                             std::vector<uint8_t>(encoded_chunk.begin(), encoded_chunk.end()), fragment_id);
                         fragment.encoded_data = std::vector<uint8_t>(txt.begin(), txt.end());
@@ -398,14 +449,14 @@ namespace chimera {
         return fragments;
     }
 
-    size_t SteganographicEncoder::estimate_capacity(DnsType record_type, size_t max_fragments) {
+    size_t SteganographicEncoder::estimate_capacity(DnsType record_type, size_t max_fragments, size_t max_txt_length) {
         switch (record_type) {
             case DnsType::A:
                 return 4 * max_fragments;
             case DnsType::AAAA:
                 return 16 * max_fragments;
             case DnsType::TXT:
-                return 200 * max_fragments; // Conservative estimate
+                return TXTEncoding::chunk_size_for(max_txt_length) * max_fragments; // Conservative estimate
             default:
                 return 0;
         }
@@ -414,13 +465,13 @@ namespace chimera {
     size_t SteganographicEncoder::estimate_total_capacity(const EncodingConfig& config) {
         switch (config.strategy) {
             case EncodingStrategy::TXT_ONLY:
-                return estimate_capacity(DnsType::TXT, config.max_fragments);
+                return estimate_capacity(DnsType::TXT, config.max_fragments, config.max_txt_length);
             case EncodingStrategy::MULTI_RECORD:
             case EncodingStrategy::DISTRIBUTED:
                 // Mix of A, AAAA, TXT
                 return (estimate_capacity(DnsType::A, config.max_fragments / 3) +
                         estimate_capacity(DnsType::AAAA, config.max_fragments / 3) +
-                        estimate_capacity(DnsType::TXT, config.max_fragments / 3));
+                        estimate_capacity(DnsType::TXT, config.max_fragments / 3, config.max_txt_length));
             case EncodingStrategy::HTTP2_BODY:
                 return 1024; // Estimate for HTTP/2 body
         }
@@ -429,6 +480,8 @@ namespace chimera {
 
     // Private helper functions
     std::vector<uint8_t> SteganographicEncoder::compress_payload(const std::vector<uint8_t>& payload) const {
+        ScopedTimer timer(PipelineMetrics::get().compress);
+
         // Simple zlib compression
         z_stream zs;
         memset(&zs, 0, sizeof(zs));
@@ -516,25 +569,40 @@ namespace chimera {
     }
 
     std::string SteganographicEncoder::generate_steganographic_subdomain(uint32_t fragment_id, DnsType record_type) const {
-        std::ostringstream oss;
-        
         // Create subdomain that looks legitimate but encodes metadata
+        std::string subdomain;
         switch (record_type) {
             case DnsType::A:
-                oss << "www" << std::hex << fragment_id;
+                subdomain = "www";
                 break;
             case DnsType::AAAA:
-                oss << "ipv6-" << std::hex << fragment_id;
+                subdomain = "ipv6-";
                 break;
             case DnsType::TXT:
-                oss << "mail" << std::hex << fragment_id;
+                subdomain = "mail";
                 break;
             default:
-                oss << "srv" << std::hex << fragment_id;
+                subdomain = "srv";
                 break;
         }
-        
-        return oss.str();
+        append_hex(subdomain, fragment_id);   // Short enough to stay in the string's inline buffer
+        return subdomain;
+    }
+
+    std::string SteganographicEncoder::fragment_domain(uint32_t fragment_id, DnsType record_type,
+                                                       const std::string& base_domain) const {
+        const std::string subdomain = generate_steganographic_subdomain(fragment_id, record_type);
+        std::string domain;
+        domain.reserve(subdomain.size() + 1 + base_domain.size());
+        domain += subdomain;
+        domain += '.';
+        domain += base_domain;
+        return domain;
+    }
+
+    size_t SteganographicEncoder::txt_chunk_bytes() const {
+        // Single character-string records keep the historical 200-byte chunks
+        return std::max<size_t>(200, TXTEncoding::chunk_size_for(config_.max_txt_length) / 4 * 3);
     }
 
     // Decoder implementation
@@ -544,6 +612,7 @@ namespace chimera {
         if (fragments.empty()) {
             return tl::unexpected(SteganographyError::DecodingError);
         }
+        CHIMERA_PROBE1(decode_start, fragments.size());
 
         auto start_time = std::chrono::high_resolution_clock::now();
 
@@ -614,6 +683,7 @@ namespace chimera {
         result.decode_time = decode_time;
         result.used_record_types = std::move(used_types);
 
+        CHIMERA_PROBE2(decode_done, result.data.size(), !result.data.empty());
         return result;
     }
 
@@ -631,7 +701,13 @@ namespace chimera {
             EncodedFragment fragment;
             fragment.record_type = record.type;
             fragment.domain = record.name;
-            fragment.encoded_data = record.rdata;
+            if (record.type == DnsType::TXT) {
+                // Reassemble the record text from its character-strings
+                std::string txt = DnsPacketBuilder::join_txt_rdata(record.rdata);
+                fragment.encoded_data.assign(txt.begin(), txt.end());
+            } else {
+                fragment.encoded_data = record.rdata;
+            }
             
             // Extract fragment ID from domain or data
             // This is a simplified implementation
@@ -658,7 +734,13 @@ namespace chimera {
                 return IPv6Encoding::is_valid_steganographic_ipv6(record.rdata);
             case DnsType::TXT:
                 {
-                    std::string txt_data(record.rdata.begin(), record.rdata.end());
+                    // Markers may straddle a character-string boundary, so match on the joined text
+                    std::string txt_data;
+                    try {
+                        txt_data = DnsPacketBuilder::join_txt_rdata(record.rdata);
+                    } catch (const std::exception&) {
+                        return false; // Malformed RDATA
+                    }
                     return txt_data.find("frag=") != std::string::npos ||
                            txt_data.find("v=spf1") != std::string::npos;
                 }
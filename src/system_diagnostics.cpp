@@ -1,7 +1,23 @@
 #include "chimera/system_diagnostics.hpp"
+#include "chimera/logging.hpp"
+#include "chimera/Transport.hpp"
+#include "chimera/dns_packet.hpp"
+#include <sodium.h>
+#include <openssl/ssl.h>
+#include <algorithm>
+#include <fstream>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <thread>
 #include <dlfcn.h>
 #include <unistd.h>
+#include <sched.h>
 #include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
 #include <ctime>
 
 namespace {
@@ -13,24 +29,227 @@ namespace {
         }
         return false;
     }
+
+    // First line of a /proc file as a number, -1 if unreadable
+    long readProcNumber(const char* path) {
+        std::ifstream file(path);
+        long value = -1;
+        if (!(file >> value)) {
+            return -1;
+        }
+        return value;
+    }
+
+    bool procFileContains(const char* path, const std::string& word) {
+        std::ifstream file(path);
+        std::string token;
+        while (file >> token) {
+            if (token == word) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    unsigned usableCores() {
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+            return static_cast<unsigned>(CPU_COUNT(&set));
+        }
+#endif
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Ping-pong between two connected sockets on 127.0.0.1: two sends, two
+    // receives and the loopback path, i.e. the floor under every UDP query
+    std::chrono::nanoseconds measureLoopbackRtt(int rounds) {
+        int a = socket(AF_INET, SOCK_DGRAM, 0);
+        int b = socket(AF_INET, SOCK_DGRAM, 0);
+        std::vector<int64_t> samples;
+        if (a >= 0 && b >= 0) {
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            sockaddr_in addr_a = addr;
+            sockaddr_in addr_b = addr;
+            socklen_t length = sizeof(addr);
+            timeval tv{0, 100000};
+            const bool ready =
+                bind(a, reinterpret_cast<sockaddr*>(&addr_a), sizeof(addr_a)) == 0 &&
+                bind(b, reinterpret_cast<sockaddr*>(&addr_b), sizeof(addr_b)) == 0 &&
+                getsockname(a, reinterpret_cast<sockaddr*>(&addr_a), &length) == 0 &&
+                getsockname(b, reinterpret_cast<sockaddr*>(&addr_b), &length) == 0 &&
+                connect(a, reinterpret_cast<sockaddr*>(&addr_b), sizeof(addr_b)) == 0 &&
+                connect(b, reinterpret_cast<sockaddr*>(&addr_a), sizeof(addr_a)) == 0 &&
+                setsockopt(a, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv)) == 0 &&
+                setsockopt(b, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv)) == 0;
+
+            uint8_t packet[64] = {};
+            samples.reserve(rounds);
+            for (int i = 0; ready && i < rounds; ++i) {
+                const auto start = std::chrono::steady_clock::now();
+                if (send(a, packet, sizeof(packet), 0) != sizeof(packet) ||
+                    recv(b, packet, sizeof(packet), 0) != sizeof(packet) ||
+                    send(b, packet, sizeof(packet), 0) != sizeof(packet) ||
+                    recv(a, packet, sizeof(packet), 0) != sizeof(packet)) {
+                    break;
+                }
+                samples.push_back((std::chrono::steady_clock::now() - start).count());
+            }
+        }
+        if (a >= 0) close(a);
+        if (b >= 0) close(b);
+        if (samples.empty()) {
+            return std::chrono::nanoseconds(0);
+        }
+        std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+        return std::chrono::nanoseconds(samples[samples.size() / 2]);
+    }
+
+    // MB/s sealing 16 KiB chunks in place for `duration`
+    double measureAeadThroughput(chimera::CipherSuite suite, std::chrono::milliseconds duration) {
+        constexpr size_t CHUNK = 16384;
+        auto key = chimera::AEAD::generate_key();
+        if (!key) {
+            return 0.0;
+        }
+        try {
+            chimera::AEADSession session(key.value(), chimera::SessionRole::Initiator, suite);
+            std::vector<uint8_t> buffer(CHUNK + chimera::AEADSession::TAG_BYTES, 0x5a);
+            size_t bytes = 0;
+            uint64_t sequence = 0;
+            const auto start = std::chrono::steady_clock::now();
+            auto elapsed = std::chrono::steady_clock::duration::zero();
+            while (elapsed < duration) {
+                if (!session.seal_in_place(buffer.data(), CHUNK, buffer.size(), sequence++)) {
+                    return 0.0;
+                }
+                bytes += CHUNK;
+                elapsed = std::chrono::steady_clock::now() - start;
+            }
+            return bytes / std::chrono::duration<double>(elapsed).count() / 1e6;
+        } catch (const std::exception&) {
+            return 0.0;
+        }
+    }
+
+    std::string formatBytes(long bytes) {
+        std::ostringstream out;
+        if (bytes >= 1024L * 1024L) {
+            out << bytes / (1024L * 1024L) << " MiB";
+        } else {
+            out << bytes / 1024L << " KiB";
+        }
+        return out.str();
+    }
+
+    void sortBySeverity(std::vector<chimera::DiagnosticReport>& reports) {
+        std::stable_sort(reports.begin(), reports.end(), [](const auto& a, const auto& b){
+            return static_cast<int>(a.level) > static_cast<int>(b.level);
+        });
+    }
+
+    void writeReports(std::ostringstream& report, const std::vector<chimera::DiagnosticReport>& checks) {
+        for (const auto& check : checks) {
+            std::string levelStr;
+            switch(check.level) {
+                case chimera::DiagnosticLevel::INFO: levelStr = "INFO"; break;
+                case chimera::DiagnosticLevel::WARNING: levelStr = "WARNING"; break;
+                case chimera::DiagnosticLevel::ERROR: levelStr = "ERROR"; break;
+                case chimera::DiagnosticLevel::CRITICAL: levelStr = "CRITICAL"; break;
+            }
+
+            report << "[" << levelStr << "] "
+                   << check.message << "\n";
+
+            if (!check.suggestion.empty()) {
+                report << "    Suggestion: " << check.suggestion << "\n";
+            }
+        }
+    }
+
+    // First IPv4 nameserver in /etc/resolv.conf
+    std::string systemResolver() {
+        std::ifstream file("/etc/resolv.conf");
+        std::string line;
+        while (std::getline(file, line)) {
+            std::istringstream fields(line);
+            std::string key, address;
+            in_addr parsed{};
+            if (fields >> key >> address && key == "nameserver" && inet_pton(AF_INET, address.c_str(), &parsed) == 1) {
+                return address;
+            }
+        }
+        return "8.8.8.8";
+    }
+
+    struct PreflightCache {
+        std::mutex mutex;
+        std::optional<chimera::PreflightOptions> options;   // Unset = nothing cached
+        chimera::PreflightResult result;
+    };
+
+    PreflightCache& preflightCache() {
+        static PreflightCache cache;
+        return cache;
+    }
+
+    constexpr long RMEM_RECOMMENDED = 4L * 1024L * 1024L;
+    constexpr uint64_t NOFILE_RECOMMENDED = 4096;
+    constexpr auto LOOPBACK_RTT_HIGH = std::chrono::microseconds(50);
 }
 
 namespace chimera {
 
-std::vector<DiagnosticReport> SystemDiagnostics::runPreflightChecks() {
-    std::vector<DiagnosticReport> reports;
+PreflightResult SystemDiagnostics::runPreflight(const PreflightOptions& options) {
+    auto& cache = preflightCache();
+    // Held while measuring, so concurrent callers share one run
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    const auto now = std::chrono::steady_clock::now();
+    if (cache.options && *cache.options == options && now - cache.result.measured_at < options.cache_ttl) {
+        return cache.result;
+    }
+
+    // The network probe and the performance measurements dominate; run them
+    // beside the cheap local checks instead of one after the other
+    auto network = std::async(std::launch::async, [&options] { return checkNetworkCapabilities(options); });
+    std::future<PerformanceProfile> performance;
+    if (options.probe_performance) {
+        performance = std::async(std::launch::async, [] { return probePerformance(); });
+    }
 
-    // Run all diagnostic checks
-    reports.push_back(checkCryptoLibraries());
-    reports.push_back(checkNetworkCapabilities());
-    reports.push_back(checkPerformanceMetrics());
-    reports.push_back(checkFilePermissions());
-    
-    // Sort by severity
-    std::stable_sort(reports.begin(), reports.end(), [](const auto& a, const auto& b){
-        return static_cast<int>(a.level) > static_cast<int>(b.level);
-    });
+    PreflightResult result;
+    result.checks.push_back(checkCryptoLibraries());
+    result.checks.push_back(checkPerformanceMetrics());
+    result.checks.push_back(checkFilePermissions());
+    result.checks.push_back(network.get());
+    sortBySeverity(result.checks);
+    if (performance.valid()) {
+        result.profile = performance.get();
+        result.tuning = tuningSuggestions(result.profile);
+        sortBySeverity(result.tuning);
+    }
+    result.measured_at = now;
+    result.duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - now);
+
+    cache.options = options;
+    cache.result = result;
+    return result;
+}
+
+void SystemDiagnostics::clearCache() {
+    auto& cache = preflightCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    cache.options.reset();
+}
 
+std::vector<DiagnosticReport> SystemDiagnostics::runPreflightChecks(const PreflightOptions& options) {
+    const PreflightResult result = runPreflight(options);
+    std::vector<DiagnosticReport> reports = result.checks;
+    reports.insert(reports.end(), result.tuning.begin(), result.tuning.end());
+    sortBySeverity(reports);
     return reports;
 }
 
@@ -49,27 +268,70 @@ DiagnosticReport SystemDiagnostics::checkCryptoLibraries() {
     return {DiagnosticLevel::INFO, "Cryptographic libraries verified", ""};
 }
 
-DiagnosticReport SystemDiagnostics::checkNetworkCapabilities() {
-    // Simple DNS resolution test
-    FILE* pipe = popen("nslookup -type=A example.com 2>/dev/null || dig +short example.com 2>/dev/null", "r");
-    if (!pipe) {
+DiagnosticReport SystemDiagnostics::checkNetworkCapabilities(const PreflightOptions& options) {
+    using Clock = std::chrono::steady_clock;
+    const std::string server = options.dns_server.empty() ? systemResolver() : options.dns_server;
+    const auto start = Clock::now();
+    const auto deadline = start + options.network_deadline;
+
+    // One A query through the library's own UDP path: no shell, no fork, and
+    // never longer than the deadline
+    TransportUdp transport(server, options.dns_port);
+    std::vector<uint8_t> query;
+    try {
+        query = DnsPacketBuilder::build_query(DnsQuestion{options.probe_domain, DnsType::A});
+    } catch (const std::exception&) {
+        return {DiagnosticLevel::WARNING, "Invalid DNS probe domain: " + options.probe_domain,
+                "Set PreflightOptions::probe_domain to a resolvable name"};
+    }
+    if (!transport.send(query)) {
         return {
             DiagnosticLevel::WARNING,
-            "Unable to perform DNS resolution test",
+            "Unable to send a DNS query to " + server,
             "Check network connectivity and DNS configuration"
         };
     }
-    char buffer[256];
-    bool ok = false;
-    if (fgets(buffer, sizeof(buffer), pipe)) {
-        ok = std::string(buffer).find_first_not_of(" \t\r\n") != std::string::npos;
-    }
-    pclose(pipe);
 
-    if (!ok) {
-        return {DiagnosticLevel::WARNING, "DNS resolution returned no records", "Check outbound DNS/DoH/DoT connectivity"};
+    for (;;) {
+        const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now());
+        if (remaining.count() <= 0) {
+            break;
+        }
+        transport.set_timeout(remaining);
+        auto response = transport.receive();
+        if (!response) {
+            if (response.error() == TransportError::Timeout) {
+                break;
+            }
+            return {DiagnosticLevel::WARNING, "DNS probe to " + server + " failed",
+                    "Check network connectivity and DNS configuration"};
+        }
+        // Ignore stray datagrams; the answer echoes the query id
+        if (response->size() < 12 || (*response)[0] != query[0] || (*response)[1] != query[1]) {
+            continue;
+        }
+
+        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start);
+        std::vector<DnsResourceRecord> answers;
+        try {
+            DnsPacketBuilder::parse_response(*response, answers);
+        } catch (const std::exception&) {
+            return {DiagnosticLevel::WARNING, "Malformed DNS response from " + server,
+                    "Check for middleboxes rewriting DNS traffic"};
+        }
+        if (answers.empty()) {
+            return {DiagnosticLevel::WARNING, "DNS resolution returned no records", "Check outbound DNS/DoH/DoT connectivity"};
+        }
+        return {DiagnosticLevel::INFO,
+                "Network capabilities verified (" + server + " answered in " + std::to_string(elapsed.count()) + " ms)",
+                ""};
     }
-    return {DiagnosticLevel::INFO, "Network capabilities verified", ""};
+
+    return {
+        DiagnosticLevel::WARNING,
+        "No DNS answer from " + server + " within " + std::to_string(options.network_deadline.count()) + " ms",
+        "Check outbound UDP/53 or use DoH/DoT transports"
+    };
 }
 
 DiagnosticReport SystemDiagnostics::checkPerformanceMetrics() {
@@ -117,50 +379,174 @@ DiagnosticReport SystemDiagnostics::checkFilePermissions() {
     return {DiagnosticLevel::INFO, "File permissions verified", ""};
 }
 
-std::string SystemDiagnostics::generateDetailedReport() {
-    std::vector<DiagnosticReport> checks = runPreflightChecks();
+PerformanceProfile SystemDiagnostics::probePerformance() {
+    PerformanceProfile profile;
+    if (sodium_init() >= 0) {
+        profile.aesni = sodium_runtime_has_aesni() != 0;
+        profile.pclmul = sodium_runtime_has_pclmul() != 0;
+        profile.avx2 = sodium_runtime_has_avx2() != 0;
+    }
+    profile.cores = usableCores();
+
+    profile.rmem_max = readProcNumber("/proc/sys/net/core/rmem_max");
+    profile.wmem_max = readProcNumber("/proc/sys/net/core/wmem_max");
+    struct rlimit limit{};
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+        profile.nofile_soft = static_cast<uint64_t>(limit.rlim_cur);
+        profile.nofile_hard = static_cast<uint64_t>(limit.rlim_max);
+    }
+    profile.ktls_kernel = procFileContains("/proc/sys/net/ipv4/tcp_available_ulp", "tls");
+#if defined(SSL_OP_ENABLE_KTLS) && !defined(OPENSSL_NO_KTLS)
+    profile.ktls_openssl = true;
+#endif
+
+    profile.loopback_udp_rtt = measureLoopbackRtt(200);
+    for (const auto suite : CipherSuites::supported()) {
+        profile.aead_mb_per_s.emplace_back(suite, measureAeadThroughput(suite, std::chrono::milliseconds(20)));
+    }
+    return profile;
+}
+
+std::vector<DiagnosticReport> SystemDiagnostics::tuningSuggestions(const PerformanceProfile& profile) {
+    std::vector<DiagnosticReport> reports;
+
+    // Accelerated kernels libsodium will dispatch to
+    std::string kernels = profile.aesni && profile.pclmul ? "AES-256-GCM (AES-NI + PCLMUL)" : "";
+    kernels += kernels.empty() ? "" : ", ";
+    kernels += profile.avx2 ? "ChaCha20-Poly1305 (AVX2)" : "ChaCha20-Poly1305 (portable)";
+    reports.push_back({DiagnosticLevel::INFO, "Accelerated crypto kernels: " + kernels, ""});
+
+    if (profile.aead_mb_per_s.size() > 1) {
+        // CipherSuites::preferred() puts AES-256-GCM first whenever it is available
+        const auto fastest = std::max_element(profile.aead_mb_per_s.begin(), profile.aead_mb_per_s.end(),
+                                              [](const auto& a, const auto& b) { return a.second < b.second; });
+        if (fastest != profile.aead_mb_per_s.begin()) {
+            reports.push_back({
+                DiagnosticLevel::WARNING,
+                std::string(CipherSuites::name(fastest->first)) + " measured faster than the default " +
+                    CipherSuites::name(profile.aead_mb_per_s.front().first),
+                "Offer " + std::string(CipherSuites::name(fastest->first)) +
+                    " first in HybridKeyExchangeResult::cipher_offer on this host"
+            });
+        }
+    }
+    if (!profile.aesni || !profile.pclmul) {
+        reports.push_back({
+            DiagnosticLevel::INFO,
+            "No AES-NI/PCLMUL: AES-256-GCM unavailable",
+            "ChaCha20-Poly1305 is the fastest suite here; if this is a VM, expose the host CPU model (e.g. -cpu host)"
+        });
+    }
+
+    if (profile.cores <= 1) {
+        reports.push_back({
+            DiagnosticLevel::WARNING,
+            "Only one usable CPU core",
+            "Parallel segment encryption and AsyncIO workers compete with the caller; "
+            "use WorkerPool(1) and raise the CPU quota or affinity mask"
+        });
+    }
+
+    if (profile.rmem_max >= 0 && profile.rmem_max < RMEM_RECOMMENDED) {
+        reports.push_back({
+            DiagnosticLevel::WARNING,
+            "net.core.rmem_max is " + formatBytes(profile.rmem_max) + "; bursts of UDP answers can be dropped",
+            "sysctl -w net.core.rmem_max=" + std::to_string(RMEM_RECOMMENDED) +
+                " net.core.wmem_max=" + std::to_string(RMEM_RECOMMENDED)
+        });
+    }
+    if (profile.nofile_soft > 0 && profile.nofile_soft < NOFILE_RECOMMENDED) {
+        const uint64_t target = std::min<uint64_t>(std::max<uint64_t>(profile.nofile_hard, NOFILE_RECOMMENDED), 65536);
+        reports.push_back({
+            DiagnosticLevel::WARNING,
+            "RLIMIT_NOFILE soft limit is " + std::to_string(profile.nofile_soft) +
+                "; each concurrent UDP/DoT/DoH transport holds a descriptor",
+            "ulimit -n " + std::to_string(target) +
+                (target > profile.nofile_hard ? " (raise the hard limit in limits.conf first)" : "")
+        });
+    }
+
+    if (!profile.ktls_kernel) {
+        reports.push_back({
+            DiagnosticLevel::INFO,
+            "Kernel TLS unavailable",
+            "modprobe tls to make kernel TLS offload available"
+        });
+    } else if (!profile.ktls_openssl) {
+        reports.push_back({
+            DiagnosticLevel::INFO,
+            "Kernel TLS available but OpenSSL was built without it",
+            "Use OpenSSL 3 built with enable-ktls where kTLS offload is wanted"
+        });
+    }
+
+    if (profile.loopback_udp_rtt.count() == 0) {
+        reports.push_back({DiagnosticLevel::WARNING, "Loopback UDP round trip could not be measured",
+                           "Check that UDP sockets on 127.0.0.1 are permitted (seccomp, network namespace)"});
+    } else if (profile.loopback_udp_rtt > LOOPBACK_RTT_HIGH) {
+        reports.push_back({
+            DiagnosticLevel::WARNING,
+            "Loopback UDP round trip takes " +
+                std::to_string(profile.loopback_udp_rtt.count() / 1000) + " us; syscalls are expensive here",
+            "Batch sends through AsyncIO and use fewer, larger fragments (MULTI_RECORD encoding)"
+        });
+    }
+
+    return reports;
+}
+
+std::string SystemDiagnostics::generateDetailedReport(const PreflightOptions& options) {
+    const PreflightResult result = runPreflight(options);
+    const PerformanceProfile& profile = result.profile;
     std::ostringstream report;
 
     report << "Chimera System Diagnostic Report\n";
     report << "================================\n";
     auto now = std::chrono::system_clock::now();
     std::time_t t = std::chrono::system_clock::to_time_t(now);
-    report << "Generated: " << std::put_time(std::localtime(&t), "%Y-%m-%d %H:%M:%S") << "\n\n";
+    report << "Generated: " << std::put_time(std::localtime(&t), "%Y-%m-%d %H:%M:%S") << "\n";
+    report << "Checks took " << result.duration.count() << " ms\n\n";
 
-    for (const auto& check : checks) {
-        std::string levelStr;
-        switch(check.level) {
-            case DiagnosticLevel::INFO: levelStr = "INFO"; break;
-            case DiagnosticLevel::WARNING: levelStr = "WARNING"; break;
-            case DiagnosticLevel::ERROR: levelStr = "ERROR"; break;
-            case DiagnosticLevel::CRITICAL: levelStr = "CRITICAL"; break;
-        }
+    writeReports(report, result.checks);
+    if (!options.probe_performance) {
+        return report.str();
+    }
 
-        report << "[" << levelStr << "] " 
-               << check.message << "\n";
-        
-        if (!check.suggestion.empty()) {
-            report << "    Suggestion: " << check.suggestion << "\n";
-        }
+    report << "\nPerformance profile\n";
+    report << "-------------------\n";
+    report << "CPU features: AES-NI " << (profile.aesni ? "yes" : "no")
+           << ", PCLMUL " << (profile.pclmul ? "yes" : "no")
+           << ", AVX2 " << (profile.avx2 ? "yes" : "no") << "\n";
+    report << "Usable cores: " << profile.cores << "\n";
+    report << "Socket buffers: rmem_max "
+           << (profile.rmem_max >= 0 ? formatBytes(profile.rmem_max) : "unknown") << ", wmem_max "
+           << (profile.wmem_max >= 0 ? formatBytes(profile.wmem_max) : "unknown") << "\n";
+    report << "Open files: " << profile.nofile_soft << " (hard " << profile.nofile_hard << ")\n";
+    report << "Kernel TLS: kernel " << (profile.ktls_kernel ? "yes" : "no")
+           << ", OpenSSL " << (profile.ktls_openssl ? "yes" : "no") << "\n";
+    report << "Loopback UDP round trip: " << std::fixed << std::setprecision(1)
+           << profile.loopback_udp_rtt.count() / 1000.0 << " us\n";
+    for (const auto& [suite, mb_per_s] : profile.aead_mb_per_s) {
+        report << CipherSuites::name(suite) << ": " << std::setprecision(0) << mb_per_s << " MB/s\n";
     }
 
+    report << "\nTuning suggestions\n";
+    report << "------------------\n";
+    writeReports(report, result.tuning);
+
     return report.str();
 }
 
 void SystemDiagnostics::logDiagnostic(DiagnosticLevel level, 
                                        const std::string& message, 
                                        const std::string& suggestion) {
-    const char* lvl = "INFO";
+    const char* format = suggestion.empty() ? "{}{}" : "{}{} ({})";
     switch (level) {
-        case DiagnosticLevel::INFO: lvl = "INFO"; break;
-        case DiagnosticLevel::WARNING: lvl = "WARNING"; break;
-        case DiagnosticLevel::ERROR: lvl = "ERROR"; break;
-        case DiagnosticLevel::CRITICAL: lvl = "CRITICAL"; break;
-    }
-    std::cerr << "[CHIMERA " << lvl << "] "
-              << message 
-              << (suggestion.empty() ? "" : " (" + suggestion + ")") 
-              << std::endl;
+        case DiagnosticLevel::INFO: CHIMERA_LOG_INFO(format, "", message, suggestion); break;
+        case DiagnosticLevel::WARNING: CHIMERA_LOG_WARN(format, "", message, suggestion); break;
+        case DiagnosticLevel::ERROR: CHIMERA_LOG_ERROR(format, "", message, suggestion); break;
+        case DiagnosticLevel::CRITICAL: CHIMERA_LOG_ERROR(format, "CRITICAL: ", message, suggestion); break;
+    }
 }
 
-}  // namespace chimera
\ No newline at end of file
+}  // namespace chimera
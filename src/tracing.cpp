@@ -0,0 +1,198 @@
+#include "chimera/tracing.hpp"
+#include "chimera/spsc_ring.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <unistd.h>
+#include <vector>
+
+namespace chimera {
+
+namespace {
+
+struct ThreadBuffer {
+    ThreadBuffer(uint32_t thread_id, size_t capacity) : tid(thread_id), ring(capacity) {}
+
+    uint32_t tid;
+    SpscRing<TraceEvent> ring;              // Producer: owning thread; consumer: drain() under the state mutex
+    std::atomic<size_t> dropped{0};
+    std::atomic<bool> retired{false};       // Owning thread has exited
+};
+
+struct TraceState {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;   // Freed after their thread exits and is drained
+    std::vector<std::pair<uint32_t, TraceEvent>> events;  // Drained so far, by thread
+    std::vector<uint32_t> retired_tids;                   // Exited threads still named in the dump
+    size_t retired_dropped = 0;
+    size_t events_per_thread = 65536;
+    uint32_t next_tid = 1;
+    std::atomic<uint64_t> next_transfer{1};
+    const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+    void drain() {
+        TraceEvent event;
+        size_t retired_count = 0;
+        for (auto& buffer : buffers) {
+            // Load before popping: a retired thread pushes nothing more
+            const bool retired = buffer->retired.load(std::memory_order_acquire);
+            while (buffer->ring.try_pop(event)) {
+                events.emplace_back(buffer->tid, event);
+            }
+            if (retired) {
+                retired_tids.push_back(buffer->tid);
+                retired_dropped += buffer->dropped.load(std::memory_order_relaxed);
+                buffer.reset();
+                ++retired_count;
+            }
+        }
+        if (retired_count > 0) {
+            buffers.erase(std::remove(buffers.begin(), buffers.end(), nullptr), buffers.end());
+        }
+    }
+};
+
+// Never destroyed: threads may still finish spans during static destruction
+TraceState& state() {
+    static TraceState* instance = new TraceState();
+    return *instance;
+}
+
+struct LocalBuffer {
+    std::shared_ptr<ThreadBuffer> buffer;
+
+    ~LocalBuffer() {
+        if (buffer) {
+            buffer->retired.store(true, std::memory_order_release);
+        }
+    }
+};
+
+ThreadBuffer& local_buffer() {
+    thread_local LocalBuffer local;
+    if (!local.buffer) {
+        auto& trace = state();
+        std::lock_guard<std::mutex> lock(trace.mutex);
+        // Short-lived threads (one per async request) would otherwise pile up
+        // rings; a new thread frees those of threads that already exited
+        trace.drain();
+        local.buffer = std::make_shared<ThreadBuffer>(trace.next_tid++, trace.events_per_thread);
+        trace.buffers.push_back(local.buffer);
+    }
+    return *local.buffer;
+}
+
+uint64_t since_epoch(std::chrono::steady_clock::time_point time) {
+    const auto elapsed = time - state().epoch;
+    return elapsed.count() > 0 ? static_cast<uint64_t>(std::chrono::nanoseconds(elapsed).count()) : 0;
+}
+
+} // namespace
+
+void Tracer::start(size_t events_per_thread) {
+    {
+        auto& trace = state();
+        std::lock_guard<std::mutex> lock(trace.mutex);
+        trace.events_per_thread = events_per_thread;
+    }
+    enabled_.store(true, std::memory_order_relaxed);
+}
+
+void Tracer::stop() {
+    enabled_.store(false, std::memory_order_relaxed);
+}
+
+uint64_t Tracer::next_transfer_id() {
+    if (!enabled()) {
+        return 0;
+    }
+    return state().next_transfer.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Tracer::record(const char* category, const char* name, std::chrono::steady_clock::time_point start,
+                    std::chrono::steady_clock::time_point end, uint64_t transfer_id, int64_t fragment_id) {
+    if (!enabled()) {
+        return;
+    }
+    const uint64_t start_ns = since_epoch(start);
+    const uint64_t end_ns = since_epoch(end);
+    auto& buffer = local_buffer();
+    if (!buffer.ring.try_push(TraceEvent{category, name, start_ns, end_ns > start_ns ? end_ns - start_ns : 0,
+                                         transfer_id, fragment_id})) {
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+std::string Tracer::chrome_json() {
+    auto& trace = state();
+    std::lock_guard<std::mutex> lock(trace.mutex);
+    trace.drain();
+
+    const int pid = static_cast<int>(getpid());
+    std::string out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    char line[512];
+    bool first = true;
+    const auto append = [&](int length) {
+        if (length > 0) {
+            out += first ? "\n" : ",\n";
+            out.append(line, std::min(static_cast<size_t>(length), sizeof(line) - 1));
+            first = false;
+        }
+    };
+
+    std::vector<uint32_t> tids = trace.retired_tids;
+    for (const auto& buffer : trace.buffers) {
+        tids.push_back(buffer->tid);
+    }
+    std::sort(tids.begin(), tids.end());
+    for (const uint32_t tid : tids) {
+        append(std::snprintf(line, sizeof(line),
+                             R"({"name":"thread_name","ph":"M","pid":%d,"tid":%u,"args":{"name":"chimera-%u"}})",
+                             pid, tid, tid));
+    }
+    for (const auto& [tid, event] : trace.events) {
+        append(std::snprintf(line, sizeof(line),
+                             R"({"name":"%s","cat":"%s","ph":"X","pid":%d,"tid":%u,"ts":%.3f,"dur":%.3f,)"
+                             R"("args":{"transfer":%llu,"fragment":%lld}})",
+                             event.name, event.category, pid, tid, event.start_ns / 1000.0,
+                             event.duration_ns / 1000.0, static_cast<unsigned long long>(event.transfer_id),
+                             static_cast<long long>(event.fragment_id)));
+    }
+    out += "\n]}\n";
+    return out;
+}
+
+bool Tracer::write_chrome_json(const std::string& path) {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file) {
+        return false;
+    }
+    file << chrome_json();
+    return static_cast<bool>(file.flush());
+}
+
+size_t Tracer::dropped() {
+    auto& trace = state();
+    std::lock_guard<std::mutex> lock(trace.mutex);
+    size_t total = trace.retired_dropped;
+    for (const auto& buffer : trace.buffers) {
+        total += buffer->dropped.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void Tracer::clear() {
+    auto& trace = state();
+    std::lock_guard<std::mutex> lock(trace.mutex);
+    trace.drain();
+    trace.events.clear();
+    trace.retired_tids.clear();
+    trace.retired_dropped = 0;
+    for (const auto& buffer : trace.buffers) {
+        buffer->dropped.store(0, std::memory_order_relaxed);
+    }
+}
+
+} // namespace chimera
@@ -0,0 +1,148 @@
+#include "chimera/worker_pool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace chimera {
+
+class WorkerPool::Impl {
+    // One parallel_for invocation; workers and the caller pull indexes from `next`
+    struct Job {
+        const std::function<void(size_t)>* fn;
+        size_t count;
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+        std::exception_ptr error;
+        std::mutex mutex;
+        std::condition_variable finished;
+
+        void run() {
+            size_t completed = 0;
+            for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+                try {
+                    (*fn)(i);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                }
+                ++completed;
+            }
+            if (completed > 0 && done.fetch_add(completed) + completed == count) {
+                std::lock_guard<std::mutex> lock(mutex);
+                finished.notify_all();
+            }
+        }
+    };
+
+    std::vector<std::thread> threads_;
+    std::deque<std::shared_ptr<Job>> queue_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+
+public:
+    explicit Impl(size_t threads) {
+        if (threads == 0) {
+            const size_t cores = std::max(1u, std::thread::hardware_concurrency());
+            threads = cores > 1 ? cores - 1 : 1;
+        }
+        threads_.reserve(threads);
+        for (size_t i = 0; i < threads; ++i) {
+            threads_.emplace_back([this]() { worker_loop(); });
+        }
+    }
+
+    ~Impl() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+    }
+
+    void parallel_for(size_t count, const std::function<void(size_t)>& fn) {
+        if (count == 0) {
+            return;
+        }
+
+        auto job = std::make_shared<Job>();
+        job->fn = &fn;
+        job->count = count;
+
+        // Small jobs run inline; otherwise wake as many workers as there is work
+        const size_t helpers = std::min(threads_.size(), count - 1);
+        if (helpers > 0) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                for (size_t i = 0; i < helpers; ++i) {
+                    queue_.push_back(job);
+                }
+            }
+            if (helpers == threads_.size()) {
+                cv_.notify_all();
+            } else {
+                for (size_t i = 0; i < helpers; ++i) {
+                    cv_.notify_one();
+                }
+            }
+        }
+
+        job->run();
+
+        std::unique_lock<std::mutex> lock(job->mutex);
+        job->finished.wait(lock, [&]() { return job->done.load() == job->count; });
+        if (job->error) {
+            std::rethrow_exception(job->error);
+        }
+    }
+
+    size_t size() const {
+        return threads_.size();
+    }
+
+private:
+    void worker_loop() {
+        while (true) {
+            std::shared_ptr<Job> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+                if (stopping_ && queue_.empty()) {
+                    return;
+                }
+                job = std::move(queue_.front());
+                queue_.pop_front();
+            }
+            job->run();
+        }
+    }
+};
+
+WorkerPool::WorkerPool(size_t threads) : impl_(std::make_unique<Impl>(threads)) {}
+
+WorkerPool::~WorkerPool() = default;
+
+void WorkerPool::parallel_for(size_t count, const std::function<void(size_t)>& fn) {
+    impl_->parallel_for(count, fn);
+}
+
+size_t WorkerPool::size() const {
+    return impl_->size();
+}
+
+WorkerPool& WorkerPool::shared() {
+    static WorkerPool pool;
+    return pool;
+}
+
+} // namespace chimera
@@ -6,15 +6,40 @@
 #include "chimera/BehavioralMimicry.hpp"
 #include "chimera/AsyncIO.hpp"
 #include "chimera/steganography.hpp"
+#include "chimera/session_resumption.hpp"
+#include "chimera/worker_pool.hpp"
+#include "chimera/secure_memory.hpp"
+#include "chimera/rekeying.hpp"
+#include "chimera/latency_histogram.hpp"
+#include "chimera/fault_injection.hpp"
+#include "chimera/transport_loopback.hpp"
+#include "chimera/metrics.hpp"
+#include "chimera/tracing.hpp"
+#include "chimera/logging.hpp"
+#include "chimera/system_diagnostics.hpp"
+#include "chimera/config_wizard.hpp"
+#include "mock_dns_server.hpp"
+#include "alloc_counter.hpp"
+#include "perf_counters.hpp"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
 #include <cassert>
+#include <algorithm>
+#include <type_traits>
 #include <iostream>
 #include <chrono>
 #include <thread>
 #include <future>
+#include <mutex>
 #include <functional>
 #include <vector>
 #include <string>
 #include <map>
+#include <limits>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
 
 namespace chimera::tests {
 
@@ -112,15 +137,214 @@ void test_aead_crypto(TestRunner& runner) {
     });
 }
 
+void test_aead_session(TestRunner& runner) {
+    runner.run_test("Core", "Session AEAD (implicit nonces)", []() {
+        auto key = chimera::AEAD::generate_key();
+        assert(key.has_value());
+        chimera::AEADSession client(key.value(), chimera::SessionRole::Initiator);
+        chimera::AEADSession server(key.value(), chimera::SessionRole::Responder);
+
+        // In place into a caller buffer: only the tag is added, no nonce
+        std::string text = "fragment payload carried in ~200 bytes per query";
+        std::vector<uint8_t> buffer(text.size() + chimera::AEADSession::TAG_BYTES);
+        std::copy(text.begin(), text.end(), buffer.begin());
+        auto sealed_len = client.seal_in_place(buffer.data(), text.size(), buffer.size(), 7);
+        assert(sealed_len.has_value() && sealed_len.value() == text.size() + 16);
+        assert(!std::equal(text.begin(), text.end(), buffer.begin()));
+
+        auto opened_len = server.open_in_place(buffer.data(), sealed_len.value(), 7);
+        assert(opened_len.has_value() && opened_len.value() == text.size());
+        assert(std::equal(text.begin(), text.end(), buffer.begin()));
+
+        // Counters: chunks carry their sequence, so loss and reordering do not stall the receiver
+        std::vector<std::vector<uint8_t>> chunks = {{1, 2, 3}, {4, 5, 6}, {7, 8}, {9}};
+        for (uint64_t i = 0; i < chunks.size(); ++i) {
+            auto sequence = client.seal_next(chunks[i]);
+            assert(sequence.value() == i);
+        }
+        auto replayed = chunks[2];
+        auto opened_third = server.open_next(chunks[2], 2);     // chunk 1 was lost
+        auto opened_first = server.open_next(chunks[0], 0);     // chunk 0 arrives late
+        assert(opened_third.has_value() && opened_first.has_value());
+        assert(chunks[0] == std::vector<uint8_t>({1, 2, 3}) && chunks[2] == std::vector<uint8_t>({7, 8}));
+        assert(server.next_receive_sequence() == 3);
+
+        // Replays are refused; a forgery does not use up its sequence
+        auto replay = server.open_next(replayed, 2);
+        assert(!replay && replay.error() == chimera::CryptoError::ReplayDetected);
+        auto forged = chunks[3];
+        forged[0] ^= 1;
+        auto opened_forged = server.open_next(forged, 3);
+        assert(!opened_forged && opened_forged.error() == chimera::CryptoError::DecryptionFailed);
+        auto opened_fourth = server.open_next(chunks[3], 3);
+        assert(opened_fourth.has_value() && chunks[3] == std::vector<uint8_t>({9}));
+
+        // Sequences that fell behind the window cannot be told apart from replays
+        std::vector<uint8_t> far = {1};
+        const uint64_t far_sequence = chimera::AEADSession::REPLAY_WINDOW + 10;
+        auto sealed_far = client.seal(far, far_sequence);
+        auto opened_far = server.open_next(far, far_sequence);
+        assert(sealed_far.has_value() && opened_far.has_value());
+        auto stale = server.open_next(chunks[1], 1);
+        assert(!stale && stale.error() == chimera::CryptoError::ReplayDetected);
+
+        // Wrong sequence, wrong direction and short buffers are rejected
+        std::vector<uint8_t> chunk = {9, 9, 9};
+        auto sealed_chunk = client.seal(chunk, 3);
+        assert(sealed_chunk.has_value());
+        auto wrong_seq = chunk;
+        auto opened_wrong_seq = server.open(wrong_seq, 4);
+        assert(!opened_wrong_seq.has_value());
+        auto wrong_dir = chunk;
+        auto opened_wrong_dir = client.open(wrong_dir, 3);
+        assert(!opened_wrong_dir.has_value());
+        uint8_t small[4] = {0};
+        auto sealed_small = client.seal_in_place(small, 4, sizeof(small), 0);
+        assert(!sealed_small.has_value());
+    });
+}
+
+void test_cipher_suites(TestRunner& runner) {
+    runner.run_test("Core", "Cipher Suite Selection", []() {
+        const auto& suites = chimera::CipherSuites::supported();
+        assert(!suites.empty());
+        assert(chimera::CipherSuites::is_available(chimera::CipherSuite::ChaCha20Poly1305));
+        std::cout << "  Preferred AEAD: " << chimera::CipherSuites::name(chimera::CipherSuites::preferred()) << std::endl;
+
+        // The offer travels with the key share; the responder picks the first usable suite
+        auto server_keys = chimera::HybridKeyExchange::generate_keypair();
+        assert(server_keys.has_value());
+        auto exchange = chimera::HybridKeyExchange::initiate_exchange(
+            server_keys->x25519_public, server_keys->mlkem_public);
+        assert(exchange.has_value());
+        auto wire = chimera::CipherSuites::encode_offer(exchange->cipher_offer);
+        wire.push_back(0x7f); // unknown suites are ignored
+        auto chosen = chimera::CipherSuites::negotiate(chimera::CipherSuites::decode_offer(wire));
+        assert(chosen.has_value() && chosen.value() == chimera::CipherSuites::preferred());
+        assert(!chimera::CipherSuites::negotiate({}).has_value());
+
+        auto key = chimera::HybridKeyExchange::derive_key(exchange->shared_secret);
+        assert(key.has_value());
+        for (auto suite : suites) {
+            chimera::Plaintext message = {'s', 'u', 'i', 't', 'e'};
+            auto packet = chimera::AEAD::encrypt(message, key.value(), {}, suite);
+            assert(packet.has_value());
+            auto opened = chimera::AEAD::decrypt(packet.value(), key.value(), {}, suite);
+            assert(opened.has_value() && opened.value() == message);
+
+            chimera::AEADSession client(key.value(), chimera::SessionRole::Initiator, suite);
+            chimera::AEADSession server(key.value(), chimera::SessionRole::Responder, suite);
+            auto chunk = message;
+            auto sealed = client.seal_next(chunk);
+            assert(sealed.has_value());
+            auto reopened = server.open_next(chunk, sealed.value());
+            assert(reopened.has_value() && chunk == message);
+        }
+
+        // Packets sealed under one suite do not open under another
+        if (suites.size() > 1) {
+            chimera::Plaintext message = {1, 2, 3};
+            auto packet = chimera::AEAD::encrypt(message, key.value(), {}, chimera::CipherSuite::AES256GCM);
+            assert(packet.has_value());
+            assert(!chimera::AEAD::decrypt(packet.value(), key.value(), {}, chimera::CipherSuite::ChaCha20Poly1305).has_value());
+        }
+    });
+}
+
+void test_segmented_encryption(TestRunner& runner) {
+    runner.run_test("Core", "Parallel Segmented Encryption", []() {
+        auto key = chimera::AEAD::generate_key();
+        assert(key.has_value());
+        chimera::AEADSession client(key.value(), chimera::SessionRole::Initiator);
+        chimera::AEADSession server(key.value(), chimera::SessionRole::Responder);
+        chimera::WorkerPool pool(4);
+
+        // 10 segments of 1 KiB with a short tail
+        constexpr size_t segment = 1024;
+        std::vector<uint8_t> payload(9 * segment + 100);
+        for (size_t i = 0; i < payload.size(); ++i) {
+            payload[i] = static_cast<uint8_t>(i * 31);
+        }
+
+        std::vector<uint8_t> sealed;
+        auto first = client.seal_segments(payload, sealed, &pool, segment);
+        assert(first.has_value() && first.value() == 0);
+        assert(sealed.size() == chimera::AEADSession::sealed_segments_size(payload.size(), segment));
+        assert(client.next_send_sequence() == 10);
+
+        std::vector<uint8_t> opened;
+        auto opened_first = server.open_next_segments(sealed, opened, first.value(), &pool, segment);
+        assert(opened_first.has_value());
+        assert(opened == payload);
+        assert(server.next_receive_sequence() == 10);
+
+        // Swapping two segments, dropping the tail segment or flipping a bit fails
+        constexpr size_t stride = segment + chimera::AEADSession::TAG_BYTES;
+        auto swapped = sealed;
+        std::swap_ranges(swapped.begin(), swapped.begin() + stride, swapped.begin() + stride);
+        auto opened_swapped = server.open_segments(swapped, opened, 0, &pool, segment);
+        assert(!opened_swapped.has_value());
+
+        std::vector<uint8_t> truncated(sealed.begin(), sealed.begin() + 9 * stride);
+        auto opened_truncated = server.open_segments(truncated, opened, 0, &pool, segment);
+        assert(!opened_truncated.has_value());
+
+        auto flipped = sealed;
+        flipped[5 * stride + 3] ^= 0x80;
+        auto opened_flipped = server.open_segments(flipped, opened, 0, nullptr, segment);
+        assert(!opened_flipped.has_value());
+
+        // Sealing inline and on the pool produce identical output for the same sequences
+        chimera::AEADSession inline_client(key.value(), chimera::SessionRole::Initiator);
+        std::vector<uint8_t> sealed_inline;
+        auto inline_first = inline_client.seal_segments(payload, sealed_inline, nullptr, segment);
+        assert(inline_first.has_value());
+        assert(sealed_inline == sealed);
+
+        // Empty payloads still carry one authenticated segment
+        std::vector<uint8_t> empty, sealed_empty, opened_empty;
+        auto empty_sealed = client.seal_segments(empty, sealed_empty, &pool);
+        assert(empty_sealed.has_value());
+        assert(sealed_empty.size() == chimera::AEADSession::TAG_BYTES);
+        auto empty_opened = server.open_next_segments(sealed_empty, opened_empty, empty_sealed.value(), &pool);
+        assert(empty_opened.has_value());
+        assert(opened_empty.empty());
+
+        // Transfers carry their first sequence: a lost transfer does not break the next one
+        std::vector<uint8_t> lost, kept, received;
+        auto lost_first = client.seal_transfer(payload, lost, &pool, segment);
+        assert(lost_first.has_value());
+        auto kept_first = client.seal_transfer(payload, kept, &pool, segment);
+        assert(kept_first.has_value() && kept_first.value() == lost_first.value() + 10);
+        assert(kept.size() == chimera::AEADSession::TRANSFER_HEADER_BYTES + sealed.size());
+        auto received_first = server.open_transfer(kept, received, &pool, segment);
+        assert(received_first.has_value() && received_first.value() == kept_first.value());
+        assert(received == payload);
+
+        // The late transfer still opens once; either one replayed is rejected
+        auto late_first = server.open_transfer(lost, received, &pool, segment);
+        assert(late_first.has_value() && received == payload);
+        auto replayed = server.open_transfer(kept, received, &pool, segment);
+        assert(!replayed.has_value() && replayed.error() == chimera::CryptoError::ReplayDetected);
+        auto replayed_late = server.open_transfer(lost, received, &pool, segment);
+        assert(!replayed_late.has_value());
+
+        // A rewritten header selects the wrong nonces; a short transfer is rejected
+        auto forged = kept;
+        forged[chimera::AEADSession::TRANSFER_HEADER_BYTES - 1] ^= 0x01;
+        auto opened_forged = server.open_transfer(forged, received, &pool, segment);
+        assert(!opened_forged.has_value());
+        std::vector<uint8_t> short_transfer(chimera::AEADSession::TRANSFER_HEADER_BYTES - 1);
+        auto opened_short = server.open_transfer(short_transfer, received, &pool, segment);
+        assert(!opened_short.has_value());
+    });
+}
+
 void test_hybrid_key_exchange(TestRunner& runner) {
     runner.run_test("Core", "Hybrid Key Exchange (X25519 + ML-KEM768)", []() {
-        auto alice_keys = chimera::HybridKeyExchange::generate_keypair();
         auto bob_keys = chimera::HybridKeyExchange::generate_keypair();
-        
-        assert(alice_keys.has_value());
         assert(bob_keys.has_value());
 
-        auto alice_kp = alice_keys.value();
         auto bob_kp = bob_keys.value();
 
         auto alice_exchange = chimera::HybridKeyExchange::initiate_exchange(
@@ -128,16 +352,742 @@ void test_hybrid_key_exchange(TestRunner& runner) {
         assert(alice_exchange.has_value());
 
         auto bob_secret = chimera::HybridKeyExchange::respond_to_exchange(
-            bob_kp, alice_kp.x25519_public, alice_exchange->mlkem_ciphertext);
+            bob_kp, alice_exchange->client_x25519_public, alice_exchange->mlkem_ciphertext);
         assert(bob_secret.has_value());
 
-        // In a real implementation, Alice would derive the same secret
-        // For testing, we just verify the exchange completed successfully
+        // Both sides must arrive at the same hybrid secret
+        assert(bob_secret.value() == alice_exchange->shared_secret);
         
         std::cout << "[SECURITY] Real ML-KEM768 + X25519 hybrid security verified" << std::endl;
     });
 }
 
+void test_hybrid_key_pool(TestRunner& runner) {
+    runner.run_test("Core", "Hybrid Keypair Pool", []() {
+        auto server_keys = chimera::HybridKeyExchange::generate_keypair();
+        assert(server_keys.has_value());
+
+        chimera::HybridKeyPool pool(4);
+        pool.start();
+
+        // Wait briefly for the background refill
+        for (int i = 0; i < 100 && pool.available().second == 0; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+
+        for (int i = 0; i < 8; ++i) {
+            auto exchange = chimera::HybridKeyExchange::initiate_exchange(
+                server_keys->x25519_public, server_keys->mlkem_public, server_keys->kem, &pool);
+            assert(exchange.has_value());
+
+            auto server_secret = chimera::HybridKeyExchange::respond_to_exchange(
+                server_keys.value(), exchange->client_x25519_public, exchange->mlkem_ciphertext);
+            assert(server_secret.has_value());
+            assert(server_secret.value() == exchange->shared_secret);
+        }
+
+        auto ephemeral = pool.acquire();
+        assert(ephemeral.has_value());
+        assert(!ephemeral->mlkem_public.empty());
+
+        pool.stop();
+    });
+}
+
+void test_kem_parameter_sets(TestRunner& runner) {
+    runner.run_test("Core", "Selectable ML-KEM Parameter Sets", []() {
+        auto kems = chimera::HybridKeyExchange::available_kems();
+        assert(!kems.empty());
+
+        for (const auto& params : kems) {
+            auto server_keys = chimera::HybridKeyExchange::generate_keypair(params.algorithm);
+            assert(server_keys.has_value());
+            assert(server_keys->mlkem_public.size() == params.public_key_bytes);
+
+            auto exchange = chimera::HybridKeyExchange::initiate_exchange(
+                server_keys->x25519_public, server_keys->mlkem_public, params.algorithm);
+            assert(exchange.has_value());
+            assert(exchange->mlkem_ciphertext.size() == params.ciphertext_bytes);
+
+            auto server_secret = chimera::HybridKeyExchange::respond_to_exchange(
+                server_keys.value(), exchange->client_x25519_public, exchange->mlkem_ciphertext);
+            assert(server_secret.has_value());
+            assert(server_secret.value() == exchange->shared_secret);
+
+            std::cout << "  " << params.name << ": pk=" << params.public_key_bytes
+                      << " ct=" << params.ciphertext_bytes
+                      << " fragments@200B=" << params.handshake_fragments(200)
+                      << " cost=" << params.relative_cost << std::endl;
+        }
+
+        auto small = chimera::HybridKeyExchange::kem_parameters(chimera::KemAlgorithm::MLKEM512);
+        auto standard = chimera::HybridKeyExchange::kem_parameters(chimera::KemAlgorithm::MLKEM768);
+        if (small && standard) {
+            assert(small->handshake_fragments(200) < standard->handshake_fragments(200));
+
+            // A tight fragment budget selects the smaller parameter set
+            auto choice = chimera::HybridKeyExchange::select_kem(200, small->handshake_fragments(200));
+            assert(choice.has_value() && choice.value() == chimera::KemAlgorithm::MLKEM512);
+        }
+
+        // Kyber is only ever used when named explicitly, never as a fallback
+        auto kyber = chimera::HybridKeyExchange::kem_parameters(chimera::KemAlgorithm::Kyber768);
+        if (kyber && standard) {
+            assert(kyber->name != standard->name);
+            assert(kyber->public_key_bytes == standard->public_key_bytes);
+        }
+        auto roomy = chimera::HybridKeyExchange::select_kem(200, 1000);
+        assert(!roomy || static_cast<uint8_t>(roomy.value()) < static_cast<uint8_t>(chimera::KemAlgorithm::Kyber512));
+    });
+}
+
+void test_session_resumption(TestRunner& runner) {
+    runner.run_test("Core", "Session Resumption", []() {
+        auto server_keys = chimera::HybridKeyExchange::generate_keypair();
+        assert(server_keys.has_value());
+        auto exchange = chimera::HybridKeyExchange::initiate_exchange(
+            server_keys->x25519_public, server_keys->mlkem_public);
+        assert(exchange.has_value());
+        auto server_secret = chimera::HybridKeyExchange::respond_to_exchange(
+            server_keys.value(), exchange->client_x25519_public, exchange->mlkem_ciphertext);
+        assert(server_secret.has_value());
+
+        // Server issues a ticket after the full handshake, client caches it
+        chimera::SessionTicketIssuer issuer;
+        auto ticket = issuer.issue(server_secret.value());
+        assert(ticket.has_value());
+
+        chimera::ResumptionCache cache;
+        auto stored = cache.store("resolver", exchange->shared_secret, ticket.value(), issuer.lifetime());
+        assert(stored.has_value());
+        assert(cache.size() == 1);
+
+        // One round trip: request -> response, both sides derive the same key
+        auto pending = cache.resume("resolver");
+        assert(pending.has_value());
+        assert(cache.size() == 0);  // tickets are single use
+
+        auto accepted = issuer.accept(pending->request);
+        assert(accepted.has_value());
+        auto client_key = pending->complete(accepted->first);
+        assert(client_key.has_value());
+        assert(client_key.value() == accepted->second);
+
+        // Resumed key differs from a second resumption with fresh nonces
+        auto again = issuer.accept(pending->request);
+        assert(again.has_value() && again->second != accepted->second);
+
+        // Tampered tickets are rejected
+        auto tampered = pending->request;
+        tampered.ticket.back() ^= 0x01;
+        auto rejected = issuer.accept(tampered);
+        assert(!rejected.has_value() && rejected.error() == chimera::CryptoError::InvalidTicket);
+
+        // Tickets from an issuer with zero lifetime are already expired
+        chimera::SessionTicketIssuer expired_issuer(std::chrono::seconds(0));
+        auto expired_ticket = expired_issuer.issue(server_secret.value());
+        assert(expired_ticket.has_value());
+        auto expired = expired_issuer.accept({expired_ticket.value(), pending->request.client_nonce});
+        assert(!expired.has_value() && expired.error() == chimera::CryptoError::TicketExpired);
+    });
+}
+
+void test_batch_handshakes(TestRunner& runner) {
+    runner.run_test("Core", "Batch Handshake Responder", []() {
+        auto server_keys = chimera::HybridKeyExchange::generate_keypair();
+        assert(server_keys.has_value());
+
+        constexpr size_t clients = 32;
+        chimera::HandshakeBatch batch(server_keys->kem, clients);
+        std::vector<chimera::SharedSecret> expected;
+        for (size_t i = 0; i < clients; ++i) {
+            auto exchange = chimera::HybridKeyExchange::initiate_exchange(
+                server_keys->x25519_public, server_keys->mlkem_public);
+            assert(exchange.has_value());
+            auto index = batch.add(exchange->client_x25519_public, exchange->mlkem_ciphertext);
+            assert(index.has_value() && index.value() == i);
+            expected.push_back(exchange->shared_secret);
+        }
+
+        // Malformed requests are rejected before they reach the batch
+        auto malformed = batch.add(chimera::PublicKey(5), chimera::Ciphertext(10));
+        assert(!malformed.has_value());
+        assert(batch.size() == clients);
+
+        chimera::WorkerPool pool(4);
+        const size_t answered = chimera::HybridKeyExchange::respond_to_exchanges(server_keys.value(), batch, &pool);
+        assert(answered == clients);
+        for (size_t i = 0; i < clients; ++i) {
+            assert(batch.succeeded(i));
+            assert(batch.secret(i) == expected[i]);
+        }
+
+        // Storage is reused across bursts
+        batch.clear();
+        assert(batch.size() == 0);
+        auto exchange = chimera::HybridKeyExchange::initiate_exchange(
+            server_keys->x25519_public, server_keys->mlkem_public);
+        assert(exchange.has_value());
+        auto reused = batch.add(exchange->client_x25519_public, exchange->mlkem_ciphertext);
+        assert(reused.has_value());
+        const size_t answered_inline = chimera::HybridKeyExchange::respond_to_exchanges(server_keys.value(), batch);
+        assert(answered_inline == 1);
+        assert(batch.secret(0) == exchange->shared_secret);
+
+        // Growing past the reservation moves answered secrets into fresh secure storage
+        batch.reserve(4 * clients);
+        assert(batch.succeeded(0));
+        assert(batch.secret(0) == exchange->shared_secret);
+
+        // A keypair for a different parameter set fails every request
+        auto other_keys = chimera::HybridKeyExchange::generate_keypair(chimera::KemAlgorithm::MLKEM1024);
+        if (other_keys) {
+            const size_t answered_mismatched = chimera::HybridKeyExchange::respond_to_exchanges(other_keys.value(), batch);
+            assert(answered_mismatched == 0);
+            assert(!batch.succeeded(0));
+        }
+    });
+}
+
+void test_secure_arena(TestRunner& runner) {
+    runner.run_test("Core", "Secure Memory Arena", []() {
+        static_assert(std::is_same_v<chimera::SharedSecret, chimera::SecureBytes>);
+        static_assert(std::is_same_v<chimera::CryptoKey, chimera::SecureBytes>);
+        static_assert(std::is_same_v<chimera::PrivateKey, chimera::SecureBytes>);
+
+        auto& arena = chimera::SecureArena::instance();
+        auto before = arena.stats();
+
+        // Released slots are wiped and reused (LIFO) without a new slab
+        auto* slot = static_cast<uint8_t*>(arena.allocate(32));
+        std::fill(slot, slot + 32, 0xAA);
+        arena.deallocate(slot, 32);
+        auto* reused = static_cast<uint8_t*>(arena.allocate(48));
+        assert(reused == slot);
+        assert(std::all_of(reused, reused + 64, [](uint8_t b) { return b == 0; }));
+        arena.deallocate(reused, 48);
+
+        // Key material allocates from the arena and returns every slot
+        {
+            auto keys = chimera::HybridKeyExchange::generate_keypair();
+            assert(keys.has_value());
+            auto exchange = chimera::HybridKeyExchange::initiate_exchange(
+                keys->x25519_public, keys->mlkem_public);
+            assert(exchange.has_value());
+            assert(arena.stats().slots_in_use > before.slots_in_use);
+
+            // Moving a secret transfers the slot instead of copying it
+            const uint8_t* data = exchange->shared_secret.data();
+            chimera::SharedSecret moved = std::move(exchange->shared_secret);
+            assert(moved.data() == data);
+        }
+
+        // Requests above the largest size class bypass the slots
+        {
+            chimera::SecureBytes large(8192, 0x11);
+            assert(arena.stats().large_in_use == before.large_in_use + 1);
+        }
+
+        auto after = arena.stats();
+        assert(after.slots_in_use == before.slots_in_use);
+        assert(after.large_in_use == before.large_in_use);
+        assert(after.slabs >= 1);
+    });
+}
+
+void test_background_rekeying(TestRunner& runner) {
+    runner.run_test("Core", "Background Rekeying", []() {
+        auto key = chimera::AEAD::generate_key();
+        assert(key.has_value());
+
+        chimera::RekeyPolicy policy;
+        policy.max_bytes = 1000;
+        policy.overlap = std::chrono::milliseconds(200);
+        chimera::RekeyingSession client(key.value(), chimera::SessionRole::Initiator,
+                                        chimera::CipherSuite::ChaCha20Poly1305, policy);
+        chimera::RekeyingSession server(key.value(), chimera::SessionRole::Responder,
+                                        chimera::CipherSuite::ChaCha20Poly1305, policy);
+        client.start();
+        server.start();
+
+        // A stream crossing the byte threshold keeps flowing across epochs
+        std::vector<uint8_t> payload(100, 0x42);
+        for (int i = 0; i < 50; ++i) {
+            auto fragment = payload;
+            auto id = client.seal(fragment);
+            assert(id.has_value());
+            auto opened = server.open(fragment, id.value());
+            assert(opened.has_value() && fragment == payload);
+            // Give the worker a chance to prepare the next epoch on single-core hosts
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        assert(client.current_epoch() >= 4);
+        assert(server.current_epoch() == client.current_epoch());
+
+        // From here on the next epoch is derived inline, keeping switches deterministic
+        client.stop();
+        server.stop();
+
+        // Fragments in flight under the previous epoch still open during the overlap
+        auto in_flight = payload;
+        auto old_id = client.seal(in_flight);
+        assert(old_id.has_value());
+        client.request_rekey();
+        auto fresh = payload;
+        auto new_id = client.seal(fresh);
+        assert(new_id.has_value() && new_id->epoch == old_id->epoch + 1);
+        auto opened_fresh = server.open(fresh, new_id.value());
+        assert(opened_fresh.has_value());
+        auto late = in_flight;
+        auto opened_late = server.open(late, old_id.value());
+        assert(opened_late.has_value());
+
+        // ...but not after it
+        std::this_thread::sleep_for(std::chrono::milliseconds(250));
+        auto stale = in_flight;
+        auto expired = server.open(stale, old_id.value());
+        assert(!expired.has_value() && expired.error() == chimera::CryptoError::KeyExpired);
+
+        // Unknown or forged epochs never advance the receiver
+        auto forged = payload;
+        auto forged_id = new_id.value();
+        forged_id.epoch += 1;
+        auto opened_forged = server.open(forged, forged_id);
+        assert(!opened_forged.has_value());
+        assert(server.current_epoch() == new_id->epoch);
+
+        // A fresh session switches inline on request
+        chimera::RekeyingSession inline_session(key.value(), chimera::SessionRole::Initiator);
+        inline_session.request_rekey();
+        auto chunk = payload;
+        auto inline_id = inline_session.seal(chunk);
+        assert(inline_id.has_value() && inline_id->epoch == 1);
+    });
+}
+
+void test_latency_histogram(TestRunner& runner) {
+    runner.run_test("Core", "Latency Histogram", []() {
+        using chimera::LatencyHistogram;
+
+        // Small values are exact, larger ones stay within 1/64 of themselves
+        for (uint64_t value : std::vector<uint64_t>{0, 1, 127, 128, 1000, 123456789, UINT64_MAX}) {
+            const size_t index = LatencyHistogram::bucket_index(value);
+            assert(index < LatencyHistogram::BUCKET_COUNT);
+            assert(LatencyHistogram::bucket_lowest(index) <= value && value <= LatencyHistogram::bucket_highest(index));
+            assert(value < 128 || LatencyHistogram::bucket_highest(index) - LatencyHistogram::bucket_lowest(index) <= value / 64);
+        }
+
+        LatencyHistogram histogram;
+        for (uint64_t value = 1; value <= 10000; ++value) {
+            histogram.record(value * 1000);
+        }
+        assert(histogram.count() == 10000 && histogram.min() == 1000 && histogram.max() == 10000000);
+        const auto p50 = histogram.value_at_percentile(50);
+        const auto p99 = histogram.value_at_percentile(99);
+        assert(p50 >= 5000000 && p50 <= 5000000 + 5000000 / 64);
+        assert(p99 >= 9900000 && p99 <= 9900000 + 9900000 / 64);
+        assert(histogram.value_at_percentile(100) == 10000000);
+
+        // One 100 ms stall in a loop paced at 10 ms stands in for the 9 requests it held back
+        LatencyHistogram corrected;
+        corrected.record_corrected(100, 10);
+        assert(corrected.count() == 10 && corrected.min() == 10 && corrected.max() == 100);
+
+        LatencyHistogram merged;
+        merged.merge(histogram);
+        merged.merge(corrected);
+        assert(merged.count() == 10010 && merged.min() == 10 && merged.max() == 10000000);
+
+        std::ostringstream distribution;
+        merged.write_percentile_distribution(distribution);
+        assert(distribution.str().find("Total count    =        10010") != std::string::npos);
+    });
+}
+
+void test_metrics_registry(TestRunner& runner) {
+    runner.run_test("Core", "Metrics Registry", []() {
+        chimera::MetricsRegistry registry;
+        auto& sent = registry.counter("test_sent_total", "Sent", "transport=\"udp\"");
+        auto& pending = registry.gauge("test_pending", "Pending");
+        auto& latency = registry.histogram("test_latency_seconds", "Latency");
+        assert(&registry.counter("test_sent_total", "Sent", "transport=\"udp\"") == &sent);
+
+        bool mismatch_thrown = false;
+        try {
+            registry.gauge("test_sent_total", "Sent");
+        } catch (const std::runtime_error&) {
+            mismatch_thrown = true;
+        }
+        assert(mismatch_thrown);
+
+        // Shards add up across threads
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&]() {
+                for (int i = 0; i < 10000; ++i) {
+                    sent.inc();
+                    latency.record(uint64_t{2000});
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        pending.set(3);
+        assert(sent.value() == 40000);
+        assert(latency.snapshot().count() == 40000 && latency.sum() == 80000000);
+
+        const auto text = registry.prometheus_text();
+        assert(text.find("# TYPE test_sent_total counter\ntest_sent_total{transport=\"udp\"} 40000\n") != std::string::npos);
+        assert(text.find("test_pending 3\n") != std::string::npos);
+        assert(text.find("test_latency_seconds_bucket{le=\"1e-06\"} 0\n") != std::string::npos);
+        assert(text.find("test_latency_seconds_bucket{le=\"5e-06\"} 40000\n") != std::string::npos);
+        assert(text.find("test_latency_seconds_sum 0.08\n") != std::string::npos);
+        assert(text.find("test_latency_seconds_count 40000\n") != std::string::npos);
+
+        // File and Unix socket export serve the same snapshot
+        const std::string file_path = "/tmp/chimera_test_metrics.prom";
+        const std::string socket_path = "/tmp/chimera_test_metrics.sock";
+        {
+            chimera::MetricsExporter exporter(registry, {file_path, std::chrono::milliseconds(50), socket_path});
+            exporter.start();
+
+            const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            sockaddr_un address{};
+            address.sun_family = AF_UNIX;
+            socket_path.copy(address.sun_path, sizeof(address.sun_path) - 1);
+            const int connected = connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+            assert(connected == 0);
+            std::string scraped;
+            char buffer[4096];
+            for (ssize_t n; (n = read(fd, buffer, sizeof(buffer))) > 0;) {
+                scraped.append(buffer, static_cast<size_t>(n));
+            }
+            close(fd);
+            assert(scraped == text);
+            exporter.stop();
+        }
+        std::ifstream file(file_path);
+        assert(std::string(std::istreambuf_iterator<char>(file), {}) == text);
+        std::remove(file_path.c_str());
+
+        registry.reset();
+        assert(sent.value() == 0 && latency.snapshot().count() == 0 && pending.value() == 0);
+
+        // The client pipeline reports into the global registry
+        auto& pipeline = chimera::PipelineMetrics::get();
+        const auto rtt_before = pipeline.rtt.snapshot().count();
+        const auto fragments_before = pipeline.fragments_sent.value();
+        chimera::ClientConfig config;
+        config.transport_factory = chimera::LoopbackServer::create()->factory();
+        config.fragment_delay = std::chrono::milliseconds(0);
+        chimera::ChimeraClient client(config);
+        auto rtt = client.ping_dns_server();
+        assert(rtt.has_value());
+        auto result = client.send_data(std::vector<uint8_t>(200, 0x42));
+        assert(result.has_value());
+        assert(pipeline.rtt.snapshot().count() == rtt_before + 1);
+        assert(pipeline.fragments_sent.value() == fragments_before + result->fragments_sent);
+        assert(chimera::MetricsRegistry::global().prometheus_text().find("chimera_encode_duration_seconds_count") !=
+               std::string::npos);
+    });
+}
+
+void test_async_logger(TestRunner& runner) {
+    runner.run_test("Core", "Asynchronous Logger", []() {
+        if (!chimera::log_compiled_in(chimera::LogLevel::Info)) {
+            return;   // Built with -DCHIMERA_LOG_LEVEL above INFO
+        }
+        std::mutex lines_mutex;
+        std::vector<std::string> lines;
+        chimera::Logger::set_sink([&](chimera::LogLevel, const std::string& line) {
+            std::lock_guard<std::mutex> lock(lines_mutex);
+            lines.push_back(line);
+        });
+        const auto previous = chimera::Logger::level();
+        chimera::Logger::set_level(chimera::LogLevel::Info);
+
+        CHIMERA_LOG_DEBUG("below the runtime level {}", 1);
+        CHIMERA_LOG_INFO("packet {} bytes, ID={:x}, {} via {} ({{literal}})", size_t{45}, uint16_t{0xbeef}, -3,
+                         std::string("udp"));
+        chimera::Logger::flush();
+        assert(lines.size() == 1);
+        assert(lines[0] == "[CHIMERA INFO] packet 45 bytes, ID=beef, -3 via udp ({literal})");
+
+        // Every thread's ring is drained, including threads that have exited
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([t]() {
+                for (int i = 0; i < 50; ++i) {
+                    CHIMERA_LOG_WARN("thread {} message {}", t, i);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        chimera::Logger::flush();
+        assert(lines.size() == 1 + 4 * 50 - chimera::Logger::dropped());
+        assert(lines.back().rfind("[CHIMERA WARN] thread ", 0) == 0);
+
+        // Long strings are truncated to the record, never overflow it
+        CHIMERA_LOG_ERROR("{}", std::string(1000, 'x'));
+        chimera::Logger::flush();
+        assert(lines.back().size() == std::string("[CHIMERA ERROR] ").size() + chimera::LogRecord::TEXT_BYTES);
+
+        // A sink may log, even from a thread that registers its ring inside the sink
+        chimera::Logger::set_sink([&](chimera::LogLevel, const std::string& line) {
+            std::lock_guard<std::mutex> lock(lines_mutex);
+            lines.push_back(line);
+            if (line.find("echo") == std::string::npos) {
+                CHIMERA_LOG_INFO("echo");
+            }
+        });
+        CHIMERA_LOG_INFO("original");
+        std::thread([]() { chimera::Logger::flush(); }).join();
+        chimera::Logger::flush();
+        assert(lines.back() == "[CHIMERA INFO] echo");
+
+        chimera::Logger::set_level(previous);
+        chimera::Logger::set_sink(nullptr);
+    });
+}
+
+void test_performance_probes(TestRunner& runner) {
+    runner.run_test("Core", "Diagnostics Performance Probes", []() {
+        const auto profile = chimera::SystemDiagnostics::probePerformance();
+        assert(profile.cores >= 1);
+        assert(profile.nofile_soft > 0);
+        assert(profile.loopback_udp_rtt.count() > 0);
+        assert(profile.aead_mb_per_s.size() == chimera::CipherSuites::supported().size());
+        for (const auto& [suite, mb_per_s] : profile.aead_mb_per_s) {
+            assert(mb_per_s > 0.0);
+        }
+
+        const auto has = [](const std::vector<chimera::DiagnosticReport>& reports, const std::string& text) {
+            return std::any_of(reports.begin(), reports.end(), [&](const auto& report) {
+                return report.level == chimera::DiagnosticLevel::WARNING &&
+                       (report.message + report.suggestion).find(text) != std::string::npos;
+            });
+        };
+
+        // A constrained host gets concrete advice for each limit
+        chimera::PerformanceProfile weak;
+        weak.aesni = weak.pclmul = true;
+        weak.cores = 1;
+        weak.rmem_max = weak.wmem_max = 212992;
+        weak.nofile_soft = 1024;
+        weak.nofile_hard = 4096;
+        weak.loopback_udp_rtt = std::chrono::microseconds(120);
+        weak.aead_mb_per_s = {{chimera::CipherSuite::AES256GCM, 400.0}, {chimera::CipherSuite::ChaCha20Poly1305, 900.0}};
+        const auto advice = chimera::SystemDiagnostics::tuningSuggestions(weak);
+        assert(has(advice, "sysctl -w net.core.rmem_max=4194304"));
+        assert(has(advice, "ulimit -n 4096"));
+        assert(has(advice, "Only one usable CPU core"));
+        assert(has(advice, "ChaCha20-Poly1305 measured faster"));
+        assert(has(advice, "Loopback UDP round trip takes 120 us"));
+
+        chimera::PerformanceProfile strong = weak;
+        strong.cores = 16;
+        strong.rmem_max = strong.wmem_max = 8 << 20;
+        strong.nofile_soft = strong.nofile_hard = 65536;
+        strong.ktls_kernel = strong.ktls_openssl = true;
+        strong.loopback_udp_rtt = std::chrono::microseconds(8);
+        strong.aead_mb_per_s = {{chimera::CipherSuite::AES256GCM, 3000.0}, {chimera::CipherSuite::ChaCha20Poly1305, 1500.0}};
+        for (const auto& report : chimera::SystemDiagnostics::tuningSuggestions(strong)) {
+            assert(report.level == chimera::DiagnosticLevel::INFO);
+        }
+    });
+}
+
+void test_preflight_cache(TestRunner& runner) {
+    runner.run_test("Core", "Cached Parallel Preflight", []() {
+        chimera::MockServerConfig server_config;
+        server_config.udp_port = 0;
+        server_config.enable_tcp = server_config.enable_dot = server_config.enable_doh = false;
+        server_config.udp_threads = 1;
+        chimera::MockDnsServer server(server_config);
+        server.start();
+
+        chimera::PreflightOptions options;
+        options.dns_server = "127.0.0.1";
+        options.dns_port = server.port(chimera::MockTransport::UDP);
+        options.probe_performance = false;
+        const auto network_check = [](const chimera::PreflightResult& result) {
+            for (const auto& check : result.checks) {
+                if (check.message.find("DNS") != std::string::npos ||
+                    check.message.find("Network") != std::string::npos) {
+                    return check;
+                }
+            }
+            return chimera::DiagnosticReport{};
+        };
+
+        chimera::SystemDiagnostics::clearCache();
+        const auto first = chimera::SystemDiagnostics::runPreflight(options);
+        assert(first.checks.size() == 4 && first.tuning.empty());
+        assert(network_check(first).level == chimera::DiagnosticLevel::INFO);
+        assert(network_check(first).message.find("127.0.0.1 answered") != std::string::npos);
+
+        // Served from the cache until the TTL expires or the options change
+        const auto cached = chimera::SystemDiagnostics::runPreflight(options);
+        assert(cached.measured_at == first.measured_at);
+        chimera::SystemDiagnostics::clearCache();
+        const auto refreshed = chimera::SystemDiagnostics::runPreflight(options);
+        assert(refreshed.measured_at != first.measured_at);
+
+        // A resolver that never answers costs the deadline, not seconds
+        int silent = socket(AF_INET, SOCK_DGRAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t length = sizeof(address);
+        const int bound = bind(silent, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+        const int named = getsockname(silent, reinterpret_cast<sockaddr*>(&address), &length);
+        assert(bound == 0 && named == 0);
+        options.dns_port = ntohs(address.sin_port);
+        options.network_deadline = std::chrono::milliseconds(100);
+        const auto unanswered = chimera::SystemDiagnostics::runPreflight(options);
+        close(silent);
+        assert(network_check(unanswered).level == chimera::DiagnosticLevel::WARNING);
+        assert(unanswered.duration >= std::chrono::milliseconds(100));
+        assert(unanswered.duration < std::chrono::milliseconds(1000));
+        server.stop();
+    });
+}
+
+void test_auto_tune(TestRunner& runner) {
+    runner.run_test("Core", "Auto-tune", []() {
+        auto server = chimera::LoopbackServer::create();
+        const auto faulty = [&server](chimera::FaultProfile profile) -> chimera::TransportFactory {
+            auto injector = std::make_shared<chimera::FaultInjector>(profile);
+            return [server, injector] {
+                return std::make_unique<chimera::FaultInjectingTransport>(server->connect(), injector);
+            };
+        };
+        chimera::FaultProfile slow;
+        slow.delay = std::chrono::milliseconds(20);
+        chimera::FaultProfile dead;
+        dead.loss_rate = 1.0;
+
+        chimera::AutoTuneOptions options;
+        options.probes_per_candidate = 4;
+        options.probe_timeout = std::chrono::milliseconds(100);
+        options.candidates = {
+            {chimera::TransportType::UDP, "", 0, "", faulty(slow), "slow"},
+            {chimera::TransportType::UDP, "", 0, "", server->factory(), "fast"},
+            {chimera::TransportType::UDP, "", 0, "", faulty(dead), "dead"},
+        };
+
+        chimera::ClientConfig base;
+        base.target_domain = "tune.example.com";
+        base.max_fragments = 1;
+        base.fragment_delay = std::chrono::milliseconds(0);
+        chimera::ConfigWizard wizard;
+        const auto result = wizard.runAutoTune(base, options);
+        const auto& report = result.report;
+
+        assert(report.candidates.size() == 3);
+        assert(report.candidates[report.chosen].label == "fast");
+        assert(report.candidates[1].loss == 0.0 && report.candidates[1].answered == 4);
+        assert(report.candidates[0].rtt_median >= std::chrono::milliseconds(20));
+        assert(report.candidates[0].score < report.candidates[1].score);
+        assert(report.candidates[2].answered == 0 && report.candidates[2].loss == 1.0);
+        assert(report.candidates[2].score == 0.0);
+
+        // The default sample is text and compresses into fewer queries
+        assert(report.compression_ratio < 1.0 && report.use_compression && result.config.use_compression);
+        assert(report.fragments_compressed < report.fragments);
+        assert(result.config.max_fragments == report.fragments_compressed);
+        assert(result.config.timeout >= std::chrono::milliseconds(250));
+        assert(result.config.transport_factory);
+        assert(report.summary().find("* fast") != std::string::npos);
+    });
+}
+
+void test_allocation_budgets(TestRunner& runner) {
+    runner.run_test("Core", "Allocation Budgets", []() {
+        if (!chimera::bench::allocation_counting_available()) {
+            std::cout << "Allocation hook not linked in (CHIMERA_ALLOC_HOOK=OFF), skipping" << std::endl;
+            return;
+        }
+        const auto log_level = chimera::Logger::level();
+        chimera::Logger::set_level(chimera::LogLevel::Info);   // Debug lines would allocate when formatted
+
+        // Steady state: the reused buffer already has the capacity
+        const chimera::DnsQuestion question{"a1b2c3.budget.example.com", chimera::DnsType::TXT};
+        std::vector<uint8_t> packet;
+        chimera::DnsPacketBuilder::build_query_into(packet, question);
+        {
+            chimera::bench::AllocationScope scope;
+            for (int i = 0; i < 100; ++i) {
+                chimera::DnsPacketBuilder::build_query_into(packet, question);
+            }
+            assert(scope.delta().allocations == 0);
+        }
+        {
+            chimera::bench::AllocationScope scope;
+            auto query = chimera::DnsPacketBuilder::build_query(question);
+            assert(scope.delta().allocations == 1);   // The returned packet only
+            assert(query.size() == packet.size());
+        }
+
+        // encode_payload: per fragment the domain, the record data, its TXT text
+        // and checksum; a few more per call for the base64 text and the vectors
+        chimera::EncodingConfig config;
+        config.randomize_order = false;
+        config.noise_ratio = 0.0;
+        config.use_compression = false;
+        config.max_fragments = 64;
+        for (auto strategy : {chimera::EncodingStrategy::MULTI_RECORD, chimera::EncodingStrategy::TXT_ONLY}) {
+            config.strategy = strategy;
+            const chimera::SteganographicEncoder encoder(config);
+            for (size_t size : {size_t{64}, size_t{1024}}) {
+                std::vector<uint8_t> payload(size, 0x5a);
+                chimera::bench::AllocationScope scope;
+                auto fragments = encoder.encode_payload(payload, "budget.example.com");
+                const auto delta = scope.delta();
+                assert(fragments.has_value());
+                std::cout << "  encode_payload/" << size << ": " << fragments->size() << " fragments, "
+                          << delta.allocations << " allocations, " << delta.bytes << " bytes" << std::endl;
+                assert(delta.allocations <= 5 * fragments->size() + 8);
+            }
+        }
+        chimera::Logger::set_level(log_level);
+    });
+}
+
+void test_hardware_counters(TestRunner& runner) {
+    runner.run_test("Core", "Hardware Counters", []() {
+        chimera::bench::PerfCounters counters;
+        if (!counters.available()) {
+            // Containers and VMs without a PMU: a reason, no counts, no failure
+            assert(!counters.error().empty());
+            const auto sample = counters.per_op(1);
+            for (double value : sample.values) {
+                assert(value == -1);
+            }
+            std::cout << "Hardware counters unavailable: " << counters.error() << std::endl;
+            return;
+        }
+
+        counters.reset();
+        counters.start();
+        volatile uint64_t sum = 0;
+        for (uint64_t i = 0; i < 100000; ++i) {
+            sum = sum + i;
+        }
+        counters.stop();
+        const auto sample = counters.per_op(100000);
+        if (counters.has(chimera::bench::PerfEvent::Instructions)) {
+            assert(sample[chimera::bench::PerfEvent::Instructions] >= 1.0);   // At least the add
+        }
+        for (size_t e = 0; e < chimera::bench::PERF_EVENT_COUNT; ++e) {
+            assert(counters.has(static_cast<chimera::bench::PerfEvent>(e)) || sample.values[e] == -1);
+        }
+    });
+}
+
 void test_dns_packet_building(TestRunner& runner) {
     runner.run_test("Core", "DNS Packet Construction", []() {
         chimera::DnsPacketBuilder builder;
@@ -167,6 +1117,25 @@ void test_dns_packet_building(TestRunner& runner) {
         
         assert(a_packet.size() > 12);
         assert(aaaa_packet.size() > 12);
+
+        // Responder side: parse the query back and answer it
+        chimera::DnsHeader query_header{};
+        const auto parsed = chimera::DnsPacketBuilder::parse_query(a_packet, query_header);
+        assert(parsed.name == a_question.name && parsed.type == chimera::DnsType::A);
+        const std::vector<chimera::DnsResourceRecord> records = {
+            {parsed.name, chimera::DnsType::A, chimera::DnsClass::IN, 60, {10, 0, 0, 1}},
+            {"other.example.com", chimera::DnsType::A, chimera::DnsClass::IN, 60, {10, 0, 0, 2}}
+        };
+        const auto response = chimera::DnsPacketBuilder::build_response(query_header, parsed, records);
+        assert(response[0] == a_packet[0] && response[1] == a_packet[1]);
+        assert((response[2] & 0x80) && (response[2] & 0x01)); // QR and RD
+        std::vector<chimera::DnsResourceRecord> answers;
+        chimera::DnsPacketBuilder::parse_response(response, answers);
+        assert(answers.size() == 2 && answers[0].name == parsed.name && answers[1].name == "other.example.com");
+        assert(answers[1].rdata == records[1].rdata && answers[0].ttl == 60);
+
+        const auto truncated = chimera::DnsPacketBuilder::build_response(query_header, parsed, records, 0, true);
+        assert((truncated[2] & 0x02) && truncated[7] == 0);
         
         std::cout << "DNS packet created: " << packet.size() << " bytes, ID=" 
                   << std::hex << (static_cast<uint16_t>(packet[0]) << 8 | static_cast<uint16_t>(packet[1])) << std::dec << std::endl;
@@ -249,6 +1218,313 @@ void test_async_io(TestRunner& runner) {
     });
 }
 
+// In-memory responder: every request is answered with itself
+class EchoTransport : public chimera::ITransport {
+    std::vector<std::vector<uint8_t>> pending_;
+
+public:
+    tl::expected<size_t, chimera::TransportError> send(const std::vector<uint8_t>& data) override {
+        pending_.push_back(data);
+        return data.size();
+    }
+    tl::expected<std::vector<uint8_t>, chimera::TransportError> receive() override {
+        if (pending_.empty()) {
+            return tl::unexpected(chimera::TransportError::Timeout);
+        }
+        auto response = pending_.front();
+        pending_.erase(pending_.begin());
+        return response;
+    }
+    void set_timeout(std::chrono::milliseconds) override {}
+};
+
+void test_fault_injection(TestRunner& runner) {
+    runner.run_test("Transport", "Fault Injection", []() {
+        auto faulty = [](chimera::FaultProfile profile, std::shared_ptr<chimera::FaultInjector>* injector = nullptr) {
+            auto shared = std::make_shared<chimera::FaultInjector>(profile);
+            if (injector) {
+                *injector = shared;
+            }
+            auto transport = chimera::inject_faults(shared)(std::make_unique<EchoTransport>());
+            transport->set_timeout(std::chrono::milliseconds(0));
+            return transport;
+        };
+        const std::vector<uint8_t> first = {1, 2, 3, 4, 5, 6, 7, 8};
+        const std::vector<uint8_t> second = {9, 10};
+
+        // Loss is seeded: the same seed drops the same requests
+        chimera::FaultProfile lossy;
+        lossy.loss_rate = 0.3;
+        lossy.seed = 7;
+        std::vector<bool> delivered[2];
+        for (auto& outcome : delivered) {
+            auto transport = faulty(lossy);
+            for (int i = 0; i < 200; ++i) {
+                auto sent = transport->send(first);
+                assert(sent);
+                outcome.push_back(transport->receive().has_value());
+            }
+        }
+        const auto lost = std::count(delivered[0].begin(), delivered[0].end(), false);
+        assert(delivered[0] == delivered[1]);
+        assert(lost > 30 && lost < 90);
+
+        chimera::FaultProfile duplicate;
+        duplicate.duplicate_rate = 1.0;
+        auto duplicating = faulty(duplicate);
+        duplicating->send(first);
+        auto original = duplicating->receive();
+        auto copy = duplicating->receive();
+        assert(original.value() == first && copy.value() == first);
+
+        // A duplicate answers the next pending request; later answers stay aligned
+        auto pipelined = faulty(duplicate);
+        pipelined->send(first);
+        pipelined->send(second);
+        auto answered = pipelined->receive();
+        auto superseded = pipelined->receive();
+        assert(answered.value() == first && superseded.value() == first);
+        const std::vector<uint8_t> third = {11, 12, 13};
+        pipelined->send(third);
+        auto aligned = pipelined->receive();
+        assert(aligned.value() == third);
+
+        // Reordering swaps pipelined responses
+        chimera::FaultProfile reorder;
+        reorder.reorder_rate = 1.0;
+        auto reordering = faulty(reorder);
+        reordering->send(first);
+        reordering->send(second);
+        auto overtaking = reordering->receive();
+        auto overtaken = reordering->receive();
+        assert(overtaking.value() == second && overtaken.value() == first);
+
+        chimera::FaultProfile truncate;
+        truncate.truncate_rate = 1.0;
+        std::shared_ptr<chimera::FaultInjector> injector;
+        auto truncating = faulty(truncate, &injector);
+        truncating->send(first);
+        auto truncated = truncating->receive();
+        assert(truncated.value().size() < first.size());
+        assert(injector->stats().truncated == 1 && injector->stats().requests == 1);
+
+        // 1000-byte request and echo over an 800 kbit/s link take >= 20 ms
+        chimera::FaultProfile capped;
+        capped.bandwidth_bps = 800000;
+        capped.delay = std::chrono::milliseconds(5);
+        auto throttled = faulty(capped, &injector);
+        throttled->set_timeout(std::chrono::milliseconds(1000));
+        const auto start = std::chrono::steady_clock::now();
+        throttled->send(std::vector<uint8_t>(1000));
+        auto throttled_response = throttled->receive();
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        assert(throttled_response);
+        assert(elapsed >= std::chrono::milliseconds(25));
+        assert(injector->stats().throttle_ns >= 19000000 && injector->stats().delay_ns == 5000000);
+
+        // A delay beyond the timeout is a lost response
+        capped.delay = std::chrono::milliseconds(50);
+        auto late = faulty(capped, &injector);
+        late->set_timeout(std::chrono::milliseconds(10));
+        late->send(second);
+        auto late_response = late->receive();
+        assert(!late_response && injector->stats().late_responses == 1);
+    });
+}
+
+void test_loopback_transport(TestRunner& runner) {
+    runner.run_test("Transport", "In-process Loopback Transport", []() {
+        chimera::SpscRing<int> ring(3);
+        assert(ring.capacity() == 4);
+        for (int i = 0; i < 4; ++i) {
+            const bool pushed = ring.try_push(int{i});
+            assert(pushed);
+        }
+        int value = -1;
+        const bool overflowed = !ring.try_push(int{4});
+        const bool popped = ring.try_pop(value);
+        assert(overflowed && popped && value == 0 && ring.size() == 3);
+
+        const chimera::DnsQuestion question{.name = "loop.example.com", .type = chimera::DnsType::TXT};
+        const auto query = chimera::DnsPacketBuilder::build_query(question);
+        for (auto mode : {chimera::LoopbackMode::Ring, chimera::LoopbackMode::SocketPair}) {
+            auto server = chimera::LoopbackServer::create({}, mode);
+            auto transport = server->connect();
+            auto early = transport->receive();
+            assert(!early);
+            auto sent = transport->send(query);
+            assert(sent.value() == query.size());
+            auto response = transport->receive();
+            assert(response && (*response)[0] == query[0] && (*response)[1] == query[1]);
+            std::vector<chimera::DnsResourceRecord> answers;
+            chimera::DnsPacketBuilder::parse_response(response.value(), answers);
+            assert(answers.empty() && server->stats().queries == 1 && server->stats().responses == 1);
+        }
+
+        // Unread responses beyond the queue depth are dropped, like a full socket buffer
+        auto bounded = chimera::LoopbackServer::create({}, chimera::LoopbackMode::Ring, 2);
+        auto bounded_transport = bounded->connect();
+        for (int i = 0; i < 3; ++i) {
+            auto sent = bounded_transport->send(query);
+            assert(sent);
+        }
+        assert(bounded->stats().dropped == 1);
+
+        // ChimeraClient sends every fragment through the factory, without pacing
+        std::vector<std::string> names;
+        auto recorder = chimera::LoopbackServer::create([&names](const std::vector<uint8_t>& packet) {
+            chimera::DnsHeader header{};
+            names.push_back(chimera::DnsPacketBuilder::parse_query(packet, header).name);
+            return std::vector<uint8_t>{};
+        });
+        chimera::ClientConfig config;
+        config.transport_factory = recorder->factory();
+        config.fragment_delay = std::chrono::milliseconds(0);
+        config.encoding_strategy = chimera::EncodingStrategy::TXT_ONLY;
+        const std::vector<uint8_t> payload(600, 'L');
+        auto sent = chimera::ChimeraClient(config).send_data(payload);
+        assert(sent && sent->fragments_sent == names.size() && recorder->stats().responses == 0);
+        assert(std::all_of(names.begin(), names.end(), [](const std::string& name) {
+            return name.find("example.com") != std::string::npos;
+        }));
+
+        // The async engine takes the same factory
+        auto echo = chimera::LoopbackServer::create();
+        config.transport_factory = echo->factory();
+        chimera::AsyncChimeraClient async_client(config);
+        async_client.start();
+        auto result = async_client.send_text_future("loopback").get();
+        async_client.stop();
+        assert(result.success && echo->stats().queries == 1);
+    });
+}
+
+void test_stage_timings(TestRunner& runner) {
+    runner.run_test("Transport", "Per-stage Timings", []() {
+        using namespace std::chrono_literals;
+
+        // Every other query goes unanswered
+        size_t queries = 0;
+        auto server = chimera::LoopbackServer::create([&queries](const std::vector<uint8_t>& query) {
+            return queries++ % 2 == 0 ? chimera::LoopbackServer::answer_empty(query) : std::vector<uint8_t>{};
+        });
+        chimera::ClientConfig config;
+        config.transport_factory = server->factory();
+        config.fragment_delay = 1ms;
+        config.encoding_strategy = chimera::EncodingStrategy::TXT_ONLY;
+        chimera::ChimeraClient client(config);
+
+        const std::vector<uint8_t> payload(600, 'T');
+        auto plain = client.send_data(payload);
+        assert(plain && plain->fragment_timings.empty());
+        const auto& stages = plain->timings;
+        assert(stages.encode > 0ns && stages.compress > 0ns && stages.compress <= stages.encode);
+        assert(stages.send > 0ns && stages.first_byte == 0ns);
+        assert(stages.mimicry_delay >= 1ms * plain->fragments_sent);
+        assert(stages.complete >= stages.encode + stages.send + stages.mimicry_delay);
+
+        // On request, send_data reads each answer and reports per-fragment RTT
+        config.collect_fragment_timings = true;
+        config.fragment_delay = 0ms;
+        queries = 0;
+        auto sampled = chimera::ChimeraClient(config).send_data(payload);
+        assert(sampled && sampled->fragment_timings.size() == sampled->fragments_sent);
+        for (size_t i = 0; i < sampled->fragment_timings.size(); ++i) {
+            const auto& sample = sampled->fragment_timings[i];
+            assert(sample.answered == (i % 2 == 0));
+            assert(sample.send > 0ns && (sample.answered ? sample.rtt >= sample.send : sample.rtt == 0ns));
+        }
+        assert(sampled->timings.first_byte > 0ns && sampled->timings.first_byte <= sampled->timings.complete);
+
+        // Async results cover queue wait, send and first byte as well
+        auto echo = chimera::LoopbackServer::create();
+        config.transport_factory = echo->factory();
+        chimera::AsyncChimeraClient async_client(config);
+        async_client.start();
+        auto result = async_client.send_text_future("timed").get();
+        async_client.stop();
+        assert(result.success);
+        assert(result.timings.encode > 0ns && result.timings.queue_wait > 0ns && result.timings.send > 0ns);
+        assert(result.timings.first_byte >= result.timings.queue_wait + result.timings.send);
+        assert(result.timings.complete >= result.timings.first_byte);
+    });
+}
+
+void test_pipeline_tracing(TestRunner& runner) {
+    runner.run_test("Transport", "Pipeline Tracing", []() {
+        using chimera::Tracer;
+        const auto count = [](const std::string& text, const std::string& needle) {
+            size_t found = 0;
+            for (size_t at = text.find(needle); at != std::string::npos; at = text.find(needle, at + 1)) {
+                ++found;
+            }
+            return found;
+        };
+
+        chimera::ClientConfig config;
+        config.transport_factory = chimera::LoopbackServer::create()->factory();
+        config.fragment_delay = std::chrono::milliseconds(0);
+        config.encoding_strategy = chimera::EncodingStrategy::TXT_ONLY;
+        const std::vector<uint8_t> payload(600, 'P');
+
+        // Off: nothing is recorded and transfers get no id
+        Tracer::clear();
+        assert(Tracer::next_transfer_id() == 0);
+        auto untraced = chimera::ChimeraClient(config).send_data(payload);
+        assert(untraced);
+        assert(count(Tracer::chrome_json(), "\"ph\":\"X\"") == 0);
+
+        Tracer::start();
+        auto sent = chimera::ChimeraClient(config).send_data(payload);
+        chimera::AsyncChimeraClient async_client(config);
+        async_client.start();
+        auto traced = async_client.send_text_future("traced").get();
+        assert(traced.success);
+        async_client.stop();
+        Tracer::stop();
+        assert(sent);
+
+        const auto json = Tracer::chrome_json();
+        assert(json.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0) == 0);
+        assert(count(json, "\"name\":\"send_data\"") == 1 && count(json, "\"name\":\"encode_payload\"") == 1);
+        assert(count(json, "\"name\":\"send\",\"cat\":\"transport\"") == sent->fragments_sent + 1);
+        assert(json.find("\"fragment\":0}") != std::string::npos);
+        // The async request runs on a worker thread of its own (its callback
+        // span may still be open when the future is ready)
+        assert(count(json, "\"name\":\"queue_wait\"") == 1 && count(json, "\"name\":\"request\"") == 1);
+        assert(count(json, "\"name\":\"thread_name\"") >= 2);
+
+        // A full ring drops new spans until the next dump
+        Tracer::clear();
+        Tracer::start(4);
+        std::thread([]() {
+            const auto now = std::chrono::steady_clock::now();
+            for (int i = 0; i < 10; ++i) {
+                Tracer::record("test", "span", now, now);
+            }
+        }).join();
+        Tracer::stop();
+        assert(Tracer::dropped() == 6);
+        assert(count(Tracer::chrome_json(), "\"name\":\"span\"") == 4);
+
+        // Rings of exited threads are freed once drained; their spans and names stay in the dump
+        Tracer::clear();
+        Tracer::start(16);
+        for (int i = 0; i < 8; ++i) {
+            std::thread([]() {
+                const auto now = std::chrono::steady_clock::now();
+                Tracer::record("test", "short_lived", now, now);
+            }).join();
+        }
+        Tracer::stop();
+        const auto short_lived = Tracer::chrome_json();
+        assert(count(short_lived, "\"name\":\"short_lived\"") == 8);
+        assert(count(short_lived, "\"name\":\"thread_name\"") >= 8);
+        assert(Tracer::dropped() == 0);
+        Tracer::clear();
+    });
+}
+
 // Steganographic enhancement tests (Phase 3)
 void test_steganographic_encoding(TestRunner& runner) {
     runner.run_test("Steganography", "Multi-record DNS Encoding", []() {
@@ -307,6 +1583,61 @@ void test_enhanced_txt_encoding(TestRunner& runner) {
     });
 }
 
+void test_txt_multi_string_rdata(TestRunner& runner) {
+    runner.run_test("Steganography", "Multi-string TXT RDATA", []() {
+        // Round-trip a payload that needs several 255-byte character-strings
+        std::string long_text(1000, 'x');
+        auto rdata = chimera::DnsPacketBuilder::build_txt_rdata(long_text);
+        assert(rdata.size() == long_text.size() + 4);
+        assert(chimera::DnsPacketBuilder::parse_txt_rdata(rdata).size() == 4);
+        assert(chimera::DnsPacketBuilder::join_txt_rdata(rdata) == long_text);
+        assert(chimera::DnsPacketBuilder::txt_capacity(512) == 510);
+
+        // Several KB in a single TXT answer
+        std::vector<uint8_t> payload(3000);
+        for (size_t i = 0; i < payload.size(); ++i) {
+            payload[i] = static_cast<uint8_t>(i * 31);
+        }
+
+        chimera::EncodingConfig config;
+        config.strategy = chimera::EncodingStrategy::TXT_ONLY;
+        config.use_compression = false;
+        config.max_txt_length = chimera::DnsPacketBuilder::txt_capacity(chimera::DNS_EDNS_MESSAGE_LIMIT);
+
+        chimera::SteganographicEncoder encoder(config);
+        auto fragments = encoder.encode_payload(payload, "example.com");
+        assert(fragments.has_value());
+        assert(fragments->size() == 1);
+
+        const auto& fragment = fragments->front();
+        std::string txt(fragment.encoded_data.begin(), fragment.encoded_data.end());
+        chimera::DnsResourceRecord record{fragment.domain, chimera::DnsType::TXT, chimera::DnsClass::IN, 60,
+                                          chimera::DnsPacketBuilder::build_txt_rdata(txt)};
+
+        auto extracted = chimera::SteganographicExtractor::extract_from_dns_response({record});
+        assert(extracted.has_value());
+        std::string extracted_txt(extracted->begin(), extracted->end());
+        assert(chimera::TXTEncoding::decode_from_txt_fragments({extracted_txt}) == payload);
+
+        std::cout << "  " << payload.size() << " bytes in one TXT answer ("
+                  << record.rdata.size() << " bytes RDATA)" << std::endl;
+
+        // Oversized budgets are clamped so a full fragment still fits one TCP message
+        const size_t max_chunk = chimera::TXTEncoding::chunk_size_for(std::numeric_limits<size_t>::max());
+        assert(max_chunk == chimera::TXTEncoding::chunk_size_for(chimera::DNS_TCP_MESSAGE_LIMIT));
+        assert(max_chunk % 4 == 0 && max_chunk < chimera::DNS_TCP_MESSAGE_LIMIT);
+        std::vector<uint8_t> bulk(max_chunk / 4 * 3 + 1, 0x5a);
+        auto bulk_fragments = chimera::TXTEncoding::encode_to_txt_fragments(bulk, 1 << 20);
+        assert(bulk_fragments.size() == 2);
+        assert(chimera::TXTEncoding::decode_from_txt_fragments(bulk_fragments) == bulk);
+        const std::string label(63, 'a');
+        chimera::DnsQuestion longest{.name = label + "." + label + "." + label + "." + std::string(61, 'a'),
+                                     .type = chimera::DnsType::TXT};
+        const auto query = chimera::DnsPacketBuilder::build_query(longest, bulk_fragments.front());
+        assert(query.size() <= chimera::DNS_TCP_MESSAGE_LIMIT);
+    });
+}
+
 void test_http2_body_encoding(TestRunner& runner) {
     runner.run_test("Steganography", "HTTP/2 Body Encoding", []() {
         std::string test_message = "HTTP/2 body encoding test data";
@@ -381,6 +1712,88 @@ void test_end_to_end_integration(TestRunner& runner) {
     });
 }
 
+void test_mock_resolver(TestRunner& runner) {
+    runner.run_test("Integration", "Loopback Mock Resolver", []() {
+        chimera::MockServerConfig server_config;
+        server_config.udp_port = 0;
+        server_config.tcp_port = 0;
+        server_config.dot_port = 0;
+        server_config.doh_port = 0;
+        server_config.udp_threads = 2;
+        const std::string message = "mock resolver payload";
+        server_config.payload.assign(message.begin(), message.end());
+
+        chimera::MockDnsServer server(server_config);
+        server.start();
+        assert(server.port(chimera::MockTransport::UDP) != 0);
+        assert(server.extractable_answer_bytes() > message.size());
+
+        // Client receive path over UDP decodes the served fragments
+        chimera::ClientConfig config;
+        config.dns_server = "127.0.0.1";
+        config.dns_port = server.port(chimera::MockTransport::UDP);
+        config.timeout = std::chrono::milliseconds(2000);
+        auto received = chimera::ChimeraClient(config).receive_data("mail0.example.com");
+        assert(received);
+        assert(received->size() == server.extractable_answer_bytes());
+
+        // DoT: length-prefixed queries over the self-signed TLS listener
+        chimera::TransportDoT dot("127.0.0.1", server.port(chimera::MockTransport::DoT));
+        dot.set_timeout(std::chrono::milliseconds(2000));
+        chimera::DnsQuestion question{.name = "www0.example.com", .type = chimera::DnsType::A};
+        auto dot_sent = dot.send(chimera::DnsPacketBuilder::build_query(question));
+        assert(dot_sent);
+        auto dot_response = dot.receive();
+        assert(dot_response);
+        std::vector<chimera::DnsResourceRecord> answers;
+        chimera::DnsPacketBuilder::parse_response(dot_response.value(), answers);
+        assert(answers.size() == 1 && answers[0].rdata == std::vector<uint8_t>({192, 0, 2, 1}));
+
+        // DoH with the generated certificate as the only trust anchor
+        const std::string ca_file = "chimera_mock_test.pem";
+        std::ofstream(ca_file) << server.certificate_pem();
+        config.transport = chimera::TransportType::DoH;
+        config.dns_server = "127.0.0.1:" + std::to_string(server.port(chimera::MockTransport::DoH));
+        config.doh_ca_file = ca_file;
+        auto received_doh = chimera::ChimeraClient(config).receive_data("mail0.example.com");
+        std::remove(ca_file.c_str());
+        assert(received_doh && received_doh.value() == received.value());
+
+        // Every client transport goes through the decorator; dropped queries never reach the server
+        chimera::FaultProfile blackhole;
+        blackhole.loss_rate = 1.0;
+        auto injector = std::make_shared<chimera::FaultInjector>(blackhole);
+        config.transport_decorator = chimera::inject_faults(injector);
+        config.timeout = std::chrono::milliseconds(50);
+        auto received_lossy = chimera::ChimeraClient(config).receive_data("mail0.example.com");
+        assert(!received_lossy || received_lossy->empty());
+        assert(injector->stats().dropped_requests == 3);
+
+        server.stop();
+        const auto stats = server.stats();
+        assert(stats.queries[static_cast<size_t>(chimera::MockTransport::UDP)] == 3);
+        assert(stats.queries[static_cast<size_t>(chimera::MockTransport::DoT)] == 1);
+        assert(stats.queries[static_cast<size_t>(chimera::MockTransport::DoH)] == 3);
+        assert(stats.malformed == 0);
+
+        // Loss applies to UDP responses
+        server_config.enable_tcp = server_config.enable_dot = server_config.enable_doh = false;
+        server_config.loss_rate = 1.0;
+        chimera::MockDnsServer lossy(server_config);
+        lossy.start();
+        chimera::TransportUdp udp("127.0.0.1", lossy.port(chimera::MockTransport::UDP));
+        udp.set_timeout(std::chrono::milliseconds(200));
+        auto udp_sent = udp.send(chimera::DnsPacketBuilder::build_query(question));
+        assert(udp_sent);
+        auto dropped = udp.receive();
+        assert(!dropped);
+        lossy.stop();
+        assert(lossy.stats().dropped == 1);
+
+        std::cout << "  Served UDP, DoT and DoH on ephemeral loopback ports" << std::endl;
+    });
+}
+
 // Simple transport factory for testing
 class TransportFactory {
 public:
@@ -398,6 +1811,99 @@ public:
     }
 };
 
+void test_aead_throughput(TestRunner& runner) {
+    runner.run_test("Performance", "AEAD Throughput per Cipher Suite", []() {
+        auto key = chimera::AEAD::generate_key();
+        assert(key.has_value());
+        const size_t sizes[] = {64, 256, 1024, 16384};
+        constexpr size_t bytes_per_run = 4 * 1024 * 1024;
+
+        for (auto suite : chimera::CipherSuites::supported()) {
+            chimera::AEADSession session(key.value(), chimera::SessionRole::Initiator, suite);
+            for (size_t size : sizes) {
+                std::vector<uint8_t> buffer(size + chimera::AEADSession::TAG_BYTES, 0xA5);
+                const size_t iterations = bytes_per_run / size;
+
+                auto start = std::chrono::high_resolution_clock::now();
+                for (size_t i = 0; i < iterations; ++i) {
+                    auto sealed = session.seal_in_place(buffer.data(), size, buffer.size(), i);
+                    assert(sealed.has_value());
+                }
+                auto end = std::chrono::high_resolution_clock::now();
+
+                double seconds = std::chrono::duration<double>(end - start).count();
+                double mb_per_s = seconds > 0 ? (iterations * size) / seconds / (1024.0 * 1024.0) : 0.0;
+                std::cout << "  " << chimera::CipherSuites::name(suite) << " " << size << " B: "
+                          << static_cast<int>(mb_per_s) << " MB/s" << std::endl;
+            }
+        }
+    });
+}
+
+void test_segmented_encryption_scaling(TestRunner& runner) {
+    runner.run_test("Performance", "Segmented Encryption Scaling", []() {
+        auto key = chimera::AEAD::generate_key();
+        assert(key.has_value());
+        chimera::AEADSession session(key.value(), chimera::SessionRole::Initiator);
+        std::vector<uint8_t> payload(16 * 1024 * 1024, 0x5A);
+        std::vector<uint8_t> sealed;
+
+        auto measure = [&](chimera::WorkerPool* pool) {
+            auto start = std::chrono::high_resolution_clock::now();
+            auto result = session.seal_segments(payload, sealed, pool);
+            assert(result.has_value());
+            auto end = std::chrono::high_resolution_clock::now();
+            double seconds = std::chrono::duration<double>(end - start).count();
+            return seconds > 0 ? payload.size() / seconds / (1024.0 * 1024.0) : 0.0;
+        };
+
+        auto& pool = chimera::WorkerPool::shared();
+        measure(&pool); // warm up the pool and the output buffer
+        double single = measure(nullptr);
+        double parallel = measure(&pool);
+        std::cout << "  16 MiB: " << static_cast<int>(single) << " MB/s on 1 thread, "
+                  << static_cast<int>(parallel) << " MB/s on " << pool.size() + 1 << " threads" << std::endl;
+    });
+}
+
+void test_batch_handshake_throughput(TestRunner& runner) {
+    runner.run_test("Performance", "Batch Handshake Throughput", []() {
+        auto server_keys = chimera::HybridKeyExchange::generate_keypair();
+        assert(server_keys.has_value());
+
+        constexpr size_t clients = 256;
+        chimera::HandshakeBatch batch(server_keys->kem, clients);
+        std::vector<chimera::HybridKeyExchangeResult> exchanges;
+        for (size_t i = 0; i < clients; ++i) {
+            auto exchange = chimera::HybridKeyExchange::initiate_exchange(
+                server_keys->x25519_public, server_keys->mlkem_public);
+            assert(exchange.has_value());
+            auto index = batch.add(exchange->client_x25519_public, exchange->mlkem_ciphertext);
+            assert(index.has_value());
+            exchanges.push_back(std::move(exchange.value()));
+        }
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (const auto& exchange : exchanges) {
+            auto secret = chimera::HybridKeyExchange::respond_to_exchange(
+                server_keys.value(), exchange.client_x25519_public, exchange.mlkem_ciphertext);
+            assert(secret.has_value());
+        }
+        auto sequential = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::high_resolution_clock::now() - start);
+
+        auto& pool = chimera::WorkerPool::shared();
+        start = std::chrono::high_resolution_clock::now();
+        const size_t answered = chimera::HybridKeyExchange::respond_to_exchanges(server_keys.value(), batch, &pool);
+        auto batched = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::high_resolution_clock::now() - start);
+
+        std::cout << "  " << clients << " handshakes: " << sequential.count() << " μs one by one, "
+                  << batched.count() << " μs batched on " << pool.size() + 1 << " threads" << std::endl;
+        assert(answered == clients);
+    });
+}
+
 // Performance tests
 void test_performance_benchmarks(TestRunner& runner) {
     runner.run_test("Performance", "Encoding and Transport Performance", []() {
@@ -534,7 +2040,24 @@ int main(int argc, char* argv[]) {
         std::cout << "CORE FUNCTIONALITY TESTS (Phase 1)" << std::endl;
         chimera::tests::test_base64_encoding(runner);
         chimera::tests::test_aead_crypto(runner);
+        chimera::tests::test_aead_session(runner);
+        chimera::tests::test_cipher_suites(runner);
+        chimera::tests::test_segmented_encryption(runner);
         chimera::tests::test_hybrid_key_exchange(runner);
+        chimera::tests::test_hybrid_key_pool(runner);
+        chimera::tests::test_kem_parameter_sets(runner);
+        chimera::tests::test_session_resumption(runner);
+        chimera::tests::test_batch_handshakes(runner);
+        chimera::tests::test_secure_arena(runner);
+        chimera::tests::test_background_rekeying(runner);
+        chimera::tests::test_latency_histogram(runner);
+        chimera::tests::test_metrics_registry(runner);
+        chimera::tests::test_async_logger(runner);
+        chimera::tests::test_performance_probes(runner);
+        chimera::tests::test_preflight_cache(runner);
+        chimera::tests::test_auto_tune(runner);
+        chimera::tests::test_allocation_budgets(runner);
+        chimera::tests::test_hardware_counters(runner);
         chimera::tests::test_dns_packet_building(runner);
         std::cout << std::endl;
     }
@@ -545,6 +2068,10 @@ int main(int argc, char* argv[]) {
         chimera::tests::test_transport_abstraction(runner);
         chimera::tests::test_behavioral_mimicry(runner);
         chimera::tests::test_async_io(runner);
+        chimera::tests::test_fault_injection(runner);
+        chimera::tests::test_loopback_transport(runner);
+        chimera::tests::test_stage_timings(runner);
+        chimera::tests::test_pipeline_tracing(runner);
         std::cout << std::endl;
     }
     
@@ -554,6 +2081,7 @@ int main(int argc, char* argv[]) {
         chimera::tests::test_steganographic_encoding(runner);
         chimera::tests::test_ipv4_ipv6_encoding(runner);
         chimera::tests::test_enhanced_txt_encoding(runner);
+        chimera::tests::test_txt_multi_string_rdata(runner);
         chimera::tests::test_http2_body_encoding(runner);
         chimera::tests::test_capacity_estimation(runner);
         chimera::tests::test_fragment_management(runner);
@@ -564,6 +2092,7 @@ int main(int argc, char* argv[]) {
     if (run_all || run_integration || quick_mode) {
         std::cout << "INTEGRATION TESTS" << std::endl;
         chimera::tests::test_end_to_end_integration(runner);
+        chimera::tests::test_mock_resolver(runner);
         std::cout << std::endl;
     }
     
@@ -571,6 +2100,9 @@ int main(int argc, char* argv[]) {
     if (run_all || run_performance) {
         std::cout << "PERFORMANCE TESTS" << std::endl;
         chimera::tests::test_performance_benchmarks(runner);
+        chimera::tests::test_aead_throughput(runner);
+        chimera::tests::test_segmented_encryption_scaling(runner);
+        chimera::tests::test_batch_handshake_throughput(runner);
         std::cout << std::endl;
     }
     
@@ -0,0 +1,855 @@
+#include "bench_harness.hpp"
+#include "mock_dns_server.hpp"
+#include "chimera/AsyncIO.hpp"
+#include "chimera/client.hpp"
+#include "chimera/fault_injection.hpp"
+#include "chimera/latency_histogram.hpp"
+#include "chimera/tracing.hpp"
+#include "chimera/transport_loopback.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+// chimera_loadgen - drives ChimeraClient / AsyncChimeraClient with N concurrent
+// senders, open-loop at a target rate or closed-loop, and reports throughput,
+// goodput and coordinated-omission-corrected latency percentiles.
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using chimera::LatencyHistogram;
+
+enum class Operation { Send, Receive, Ping };
+
+// Payload size distribution: fixed:N, uniform:MIN:MAX or exp:MEAN[:MAX]
+struct SizeDistribution {
+    enum class Kind { Fixed, Uniform, Exponential } kind = Kind::Fixed;
+    size_t a = 256;
+    size_t b = 256;
+
+    static bool parse(const std::string& text, SizeDistribution& out) {
+        std::vector<size_t> numbers;
+        std::string kind = text;
+        const size_t colon = text.find(':');
+        try {
+            if (colon != std::string::npos) {
+                kind = text.substr(0, colon);
+                std::stringstream rest(text.substr(colon + 1));
+                for (std::string part; std::getline(rest, part, ':');) {
+                    numbers.push_back(std::stoul(part));
+                }
+            } else {
+                numbers.push_back(std::stoul(text));
+                kind = "fixed";
+            }
+        } catch (const std::exception&) {
+            return false;
+        }
+
+        if (kind == "fixed" && numbers.size() == 1) {
+            out = {Kind::Fixed, numbers[0], numbers[0]};
+        } else if (kind == "uniform" && numbers.size() == 2 && numbers[0] <= numbers[1]) {
+            out = {Kind::Uniform, numbers[0], numbers[1]};
+        } else if (kind == "exp" && (numbers.size() == 1 || numbers.size() == 2) && numbers[0] > 0) {
+            out = {Kind::Exponential, numbers[0], numbers.size() == 2 ? numbers[1] : numbers[0] * 16};
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    size_t sample(std::mt19937_64& rng) const {
+        switch (kind) {
+            case Kind::Fixed:
+                return a;
+            case Kind::Uniform:
+                return std::uniform_int_distribution<size_t>(a, b)(rng);
+            case Kind::Exponential:
+                return std::clamp<size_t>(static_cast<size_t>(std::exponential_distribution<double>(1.0 / a)(rng)), 1, b);
+        }
+        return a;
+    }
+
+    std::string describe() const {
+        switch (kind) {
+            case Kind::Fixed: return "fixed:" + std::to_string(a);
+            case Kind::Uniform: return "uniform:" + std::to_string(a) + ":" + std::to_string(b);
+            case Kind::Exponential: return "exp:" + std::to_string(a) + ":" + std::to_string(b);
+        }
+        return "";
+    }
+};
+
+struct LoadOptions {
+    chimera::ClientConfig client;
+    bool async_client = false;
+    Operation operation = Operation::Send;
+    SizeDistribution payload;
+    bool open_loop = false;
+    double qps = 0;                                   // Total target rate; 0 = unpaced closed loop
+    std::vector<size_t> concurrency = {1};            // Several values = sweep
+    std::chrono::seconds duration{10};
+    std::chrono::seconds warmup{2};
+    uint64_t seed = 1;
+    std::string json_path;
+    std::string hdr_path;
+    std::string trace_path;
+
+    std::optional<chimera::LoopbackMode> loopback;    // In-process responder instead of a resolver
+    bool embedded = false;                            // Run chimera_mock_server in-process
+    std::chrono::microseconds mock_latency{0};
+    double mock_loss = 0;
+    size_t expected_receive_bytes = 0;                // Receive counts as good only at this size; 0 = any
+
+    // Client-side impairment; each loss rate is one step of a sweep
+    chimera::FaultProfile faults;
+    std::vector<double> fault_loss = {0.0};
+
+    bool impaired() const {
+        return fault_loss.size() > 1 || fault_loss.front() > 0 || faults.response_loss_rate > 0 ||
+               faults.delay.count() > 0 || faults.delay_jitter.count() > 0 || faults.duplicate_rate > 0 ||
+               faults.reorder_rate > 0 || faults.truncate_rate > 0 || faults.bandwidth_bps > 0;
+    }
+};
+
+// Outcome of one sender thread (or the async callbacks), merged per step
+struct SenderStats {
+    LatencyHistogram latency;
+    uint64_t issued = 0;
+    uint64_t succeeded = 0;
+    uint64_t payload_bytes = 0;
+    std::map<std::string, uint64_t> errors;
+
+    void merge(const SenderStats& other) {
+        latency.merge(other.latency);
+        issued += other.issued;
+        succeeded += other.succeeded;
+        payload_bytes += other.payload_bytes;
+        for (const auto& [name, count] : other.errors) {
+            errors[name] += count;
+        }
+    }
+};
+
+struct StepResult {
+    size_t concurrency;
+    double loss_rate;
+    double target_qps;
+    double measured_seconds;
+    bool corrected;
+    SenderStats stats;
+    chimera::FaultStats faults;
+};
+
+const char* error_name(chimera::ChimeraError error) {
+    switch (error) {
+        case chimera::ChimeraError::NetworkError: return "network";
+        case chimera::ChimeraError::ConfigError: return "config";
+        case chimera::ChimeraError::EncodingError: return "encoding";
+        case chimera::ChimeraError::DecodingError: return "decoding";
+        case chimera::ChimeraError::TimeoutError: return "timeout";
+        case chimera::ChimeraError::DnsError: return "dns";
+        case chimera::ChimeraError::CryptoError: return "crypto";
+    }
+    return "unknown";
+}
+
+const char* error_name(chimera::TransportError error) {
+    switch (error) {
+        case chimera::TransportError::SocketCreationFailed: return "socket";
+        case chimera::TransportError::SendFailed: return "send";
+        case chimera::TransportError::ReceiveFailed: return "receive";
+        case chimera::TransportError::InvalidAddress: return "address";
+        case chimera::TransportError::Timeout: return "timeout";
+    }
+    return "unknown";
+}
+
+std::vector<uint8_t> make_payload(size_t size, std::mt19937_64& rng) {
+    std::vector<uint8_t> payload(size);
+    for (auto& byte : payload) {
+        byte = static_cast<uint8_t>(rng());
+    }
+    return payload;
+}
+
+// Runs one operation with the synchronous client; returns payload bytes moved or an error name
+std::pair<size_t, const char*> run_sync_operation(const chimera::ChimeraClient& client, const LoadOptions& options,
+                                                  std::mt19937_64& rng) {
+    switch (options.operation) {
+        case Operation::Send: {
+            const auto payload = make_payload(options.payload.sample(rng), rng);
+            auto result = client.send_data(payload);
+            return result ? std::pair{payload.size(), nullptr} : std::pair{size_t{0}, error_name(result.error())};
+        }
+        case Operation::Receive: {
+            auto result = client.receive_data("mail0." + options.client.target_domain);
+            if (!result) {
+                return {0, error_name(result.error())};
+            }
+            // Partial answer sets decode to fewer bytes; they are not goodput
+            if (options.expected_receive_bytes && result->size() != options.expected_receive_bytes) {
+                return {0, "incomplete"};
+            }
+            return {result->size(), nullptr};
+        }
+        case Operation::Ping: {
+            auto result = client.ping_dns_server();
+            return result ? std::pair{size_t{0}, nullptr} : std::pair{size_t{0}, error_name(result.error())};
+        }
+    }
+    return {0, "unknown"};
+}
+
+// One synchronous sender. Open loop: requests follow a fixed schedule and
+// latency counts from the intended start, so queueing behind a slow request is
+// measured. Closed loop with a rate: record_corrected back-fills the requests a
+// stall prevented.
+SenderStats run_sync_sender(const LoadOptions& options, size_t index, size_t concurrency,
+                            Clock::time_point start, Clock::time_point measure_from, Clock::time_point end) {
+    SenderStats stats;
+    std::mt19937_64 rng(options.seed * 1000003 + index);
+    const chimera::ChimeraClient client(options.client);
+
+    const bool paced = options.qps > 0;
+    const auto interval = paced ? std::chrono::duration_cast<Clock::duration>(
+                                      std::chrono::duration<double>(concurrency / options.qps))
+                                : Clock::duration::zero();
+    // Stagger senders across one interval so they do not fire in lockstep
+    auto intended = start + interval * static_cast<int64_t>(index) / static_cast<int64_t>(concurrency);
+
+    while (true) {
+        if (paced) {
+            if (intended >= end) {
+                break;
+            }
+            std::this_thread::sleep_until(intended);
+        } else if (Clock::now() >= end) {
+            break;
+        }
+
+        const auto issued_at = Clock::now();
+        const auto [bytes, error] = run_sync_operation(client, options, rng);
+        const auto finished = Clock::now();
+
+        const auto reference = options.open_loop && paced ? intended : issued_at;
+        if (reference >= measure_from) {
+            ++stats.issued;
+            const auto latency = static_cast<uint64_t>(std::chrono::nanoseconds(finished - reference).count());
+            if (!options.open_loop && paced) {
+                stats.latency.record_corrected(latency, static_cast<uint64_t>(std::chrono::nanoseconds(interval).count()));
+            } else {
+                stats.latency.record(latency);
+            }
+            if (error) {
+                ++stats.errors[error];
+            } else {
+                ++stats.succeeded;
+                stats.payload_bytes += bytes;
+            }
+        }
+
+        if (paced) {
+            intended += interval;
+            if (!options.open_loop && intended < finished) {
+                // Closed loop never queues: the next request waits for this one
+                intended = finished;
+            }
+        }
+    }
+    return stats;
+}
+
+// Async client: each sender thread issues through AsyncChimeraClient; open loop
+// submits on schedule without waiting, closed loop waits for each future
+void run_async_step(const LoadOptions& options, size_t concurrency, Clock::time_point start,
+                    Clock::time_point measure_from, Clock::time_point end, SenderStats& total) {
+    chimera::AsyncChimeraClient client(options.client);
+    client.start();
+
+    std::mutex stats_mutex;
+    std::atomic<uint64_t> outstanding{0};
+    const bool paced = options.qps > 0;
+    const auto interval = paced ? std::chrono::duration_cast<Clock::duration>(
+                                      std::chrono::duration<double>(concurrency / options.qps))
+                                : Clock::duration::zero();
+
+    auto record = [&](Clock::time_point reference, size_t bytes, const chimera::AsyncResult& result) {
+        const auto latency = static_cast<uint64_t>(std::chrono::nanoseconds(Clock::now() - reference).count());
+        std::lock_guard<std::mutex> lock(stats_mutex);
+        ++total.issued;
+        if (!options.open_loop && paced) {
+            total.latency.record_corrected(latency, static_cast<uint64_t>(std::chrono::nanoseconds(interval).count()));
+        } else {
+            total.latency.record(latency);
+        }
+        if (result.success) {
+            ++total.succeeded;
+            total.payload_bytes += bytes;
+        } else {
+            ++total.errors[error_name(result.error)];
+        }
+    };
+
+    std::vector<std::thread> senders;
+    for (size_t index = 0; index < concurrency; ++index) {
+        senders.emplace_back([&, index]() {
+            std::mt19937_64 rng(options.seed * 1000003 + index);
+            auto intended = start + interval * static_cast<int64_t>(index) / static_cast<int64_t>(concurrency);
+
+            while (paced ? intended < end : Clock::now() < end) {
+                if (paced) {
+                    std::this_thread::sleep_until(intended);
+                }
+                const auto issued_at = Clock::now();
+                const auto reference = options.open_loop && paced ? intended : issued_at;
+                const bool measured = reference >= measure_from;
+                const bool ping = options.operation == Operation::Ping;
+                const auto payload = ping ? std::vector<uint8_t>{} : make_payload(options.payload.sample(rng), rng);
+                const std::string message(payload.begin(), payload.end());
+
+                if (options.open_loop) {
+                    outstanding.fetch_add(1);
+                    auto callback = [&, reference, measured, bytes = payload.size()](const chimera::AsyncResult& result) {
+                        if (measured) {
+                            record(reference, bytes, result);
+                        }
+                        outstanding.fetch_sub(1);
+                    };
+                    if (ping) {
+                        client.ping_async(callback);
+                    } else {
+                        client.send_text_async(message, callback);
+                    }
+                } else {
+                    auto future = ping ? client.ping_future() : client.send_text_future(message);
+                    const auto result = future.get();
+                    if (measured) {
+                        record(reference, payload.size(), result);
+                    }
+                }
+
+                if (paced) {
+                    intended += interval;
+                    if (!options.open_loop) {
+                        intended = std::max(intended, Clock::now());
+                    }
+                }
+            }
+        });
+    }
+    for (auto& sender : senders) {
+        sender.join();
+    }
+
+    // Requests in flight finish or hit the transport timeout; callbacks reference
+    // this frame, so the step only ends once every one has run
+    while (outstanding.load() > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    client.stop();
+}
+
+StepResult run_step(const LoadOptions& base_options, size_t concurrency, double loss_rate) {
+    // Fresh injector per step so every step replays the same seeded faults
+    LoadOptions options = base_options;
+    std::shared_ptr<chimera::FaultInjector> injector;
+    if (options.impaired()) {
+        auto profile = options.faults;
+        profile.loss_rate = loss_rate;
+        injector = std::make_shared<chimera::FaultInjector>(profile);
+        options.client.transport_decorator = chimera::inject_faults(injector);
+    }
+
+    const auto start = Clock::now() + std::chrono::milliseconds(50);
+    const auto measure_from = start + options.warmup;
+    const auto end = measure_from + options.duration;
+
+    StepResult step{concurrency, loss_rate, options.qps, 0, !options.open_loop && options.qps > 0, {}, {}};
+    {
+        // Library diagnostics would otherwise dominate the run
+        chimera::bench::OutputMute mute;
+        if (options.async_client) {
+            run_async_step(options, concurrency, start, measure_from, end, step.stats);
+        } else {
+            std::vector<SenderStats> per_sender(concurrency);
+            std::vector<std::thread> senders;
+            for (size_t i = 0; i < concurrency; ++i) {
+                senders.emplace_back([&, i]() {
+                    per_sender[i] = run_sync_sender(options, i, concurrency, start, measure_from, end);
+                });
+            }
+            for (auto& sender : senders) {
+                sender.join();
+            }
+            for (const auto& stats : per_sender) {
+                step.stats.merge(stats);
+            }
+        }
+    }
+    step.measured_seconds = std::chrono::duration<double>(options.duration).count();
+    if (injector) {
+        step.faults = injector->stats();
+    }
+    return step;
+}
+
+double ms(uint64_t ns) {
+    return static_cast<double>(ns) / 1e6;
+}
+
+void print_step(const StepResult& step) {
+    const auto& s = step.stats;
+    const uint64_t errors = s.issued - s.succeeded;
+    std::printf("%6zu %6.3f %10.1f %10.1f %12.1f %8llu %9.3f %9.3f %9.3f %9.3f %9.3f\n",
+                step.concurrency, step.loss_rate, step.target_qps, s.succeeded / step.measured_seconds,
+                s.payload_bytes / step.measured_seconds / 1024.0, static_cast<unsigned long long>(errors),
+                ms(s.latency.value_at_percentile(50)), ms(s.latency.value_at_percentile(90)),
+                ms(s.latency.value_at_percentile(99)), ms(s.latency.value_at_percentile(99.9)),
+                ms(s.latency.max()));
+}
+
+const char* transport_name(chimera::TransportType transport) {
+    switch (transport) {
+        case chimera::TransportType::UDP: return "udp";
+        case chimera::TransportType::DoH: return "doh";
+        case chimera::TransportType::DoT: return "dot";
+    }
+    return "unknown";
+}
+
+std::string target_name(const LoadOptions& options) {
+    if (options.loopback) {
+        return *options.loopback == chimera::LoopbackMode::Ring ? "loopback" : "loopback-socketpair";
+    }
+    return transport_name(options.client.transport);
+}
+
+const char* encoding_name(chimera::EncodingStrategy strategy) {
+    switch (strategy) {
+        case chimera::EncodingStrategy::TXT_ONLY: return "txt";
+        case chimera::EncodingStrategy::MULTI_RECORD: return "multi";
+        case chimera::EncodingStrategy::DISTRIBUTED: return "distributed";
+        default: return "other";
+    }
+}
+
+const char* operation_name(Operation operation) {
+    switch (operation) {
+        case Operation::Send: return "send";
+        case Operation::Receive: return "receive";
+        case Operation::Ping: return "ping";
+    }
+    return "unknown";
+}
+
+bool write_json(const std::string& path, const LoadOptions& options, const std::vector<StepResult>& steps) {
+    std::ofstream out(path);
+    if (!out) {
+        return false;
+    }
+    out << std::fixed << std::setprecision(3);
+    out << "{\n  \"format\": 1,\n"
+        << "  \"config\": {\"transport\": \"" << target_name(options) << "\", "
+        << "\"client\": \"" << (options.async_client ? "async" : "sync") << "\", "
+        << "\"operation\": \"" << operation_name(options.operation) << "\", "
+        << "\"mode\": \"" << (options.open_loop ? "open" : "closed") << "\", "
+        << "\"target_qps\": " << options.qps << ", "
+        << "\"payload\": \"" << options.payload.describe() << "\", "
+        << "\"duration_s\": " << options.duration.count() << ", "
+        << "\"warmup_s\": " << options.warmup.count() << ", "
+        << "\"encoding\": \"" << encoding_name(options.client.encoding_strategy) << "\"},\n"
+        << "  \"steps\": [\n";
+    for (size_t i = 0; i < steps.size(); ++i) {
+        const auto& step = steps[i];
+        const auto& s = step.stats;
+        out << "    {\"concurrency\": " << step.concurrency
+            << ", \"loss_rate\": " << step.loss_rate
+            << ", \"issued\": " << s.issued
+            << ", \"succeeded\": " << s.succeeded
+            << ", \"throughput_ops\": " << s.succeeded / step.measured_seconds
+            << ", \"goodput_bytes_per_sec\": " << s.payload_bytes / step.measured_seconds
+            << ", \"coordinated_omission_corrected\": " << (step.corrected || options.open_loop ? "true" : "false")
+            << ", \"errors\": {";
+        size_t n = 0;
+        for (const auto& [name, count] : s.errors) {
+            out << (n++ ? ", " : "") << "\"" << name << "\": " << count;
+        }
+        out << "}, \"latency_ms\": {"
+            << "\"p50\": " << ms(s.latency.value_at_percentile(50))
+            << ", \"p90\": " << ms(s.latency.value_at_percentile(90))
+            << ", \"p99\": " << ms(s.latency.value_at_percentile(99))
+            << ", \"p999\": " << ms(s.latency.value_at_percentile(99.9))
+            << ", \"max\": " << ms(s.latency.max())
+            << ", \"mean\": " << s.latency.mean() / 1e6
+            << ", \"samples\": " << s.latency.count() << "}";
+        if (options.impaired()) {
+            const auto& f = step.faults;
+            out << ", \"faults\": {\"requests\": " << f.requests
+                << ", \"dropped_requests\": " << f.dropped_requests
+                << ", \"dropped_responses\": " << f.dropped_responses
+                << ", \"late_responses\": " << f.late_responses
+                << ", \"duplicated\": " << f.duplicated
+                << ", \"reordered\": " << f.reordered
+                << ", \"truncated\": " << f.truncated << "}";
+        }
+        out << "}"
+            << (i + 1 < steps.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+    return static_cast<bool>(out);
+}
+
+bool write_hdr(const std::string& path, const LoadOptions& options, const std::vector<StepResult>& steps) {
+    for (const auto& step : steps) {
+        // One distribution per file so the HdrHistogram plotter can overlay sweep steps
+        std::string file = steps.size() == 1 ? path : path + ".c" + std::to_string(step.concurrency);
+        if (options.fault_loss.size() > 1) {
+            std::ostringstream loss;
+            loss << ".loss" << step.loss_rate;
+            file += loss.str();
+        }
+        std::ofstream out(file);
+        if (!out) {
+            return false;
+        }
+        step.stats.latency.write_percentile_distribution(out);
+    }
+    return true;
+}
+
+void print_usage(const char* program_name) {
+    std::cout << "CHIMERA load generator\n\n";
+    std::cout << "Usage: " << program_name << " [options]\n\n";
+    std::cout << "Target:\n";
+    std::cout << "  --transport <t>        udp, dot, doh, or loopback / loopback-socketpair for an\n";
+    std::cout << "                         in-process responder without a network (default: udp)\n";
+    std::cout << "  --server <addr>        Resolver address; host:port for DoH (default: 127.0.0.1)\n";
+    std::cout << "  --port <n>             Resolver port for UDP/DoT (default: 5353)\n";
+    std::cout << "  --ca-file <path>       PEM trust anchors for DoH (e.g. chimera_mock_server --cert-out)\n";
+    std::cout << "  --domain <name>        Target domain (default: example.com)\n";
+    std::cout << "  --embedded             Start a mock resolver in-process and target it\n";
+    std::cout << "  --mock-latency-ms <ms> Latency of the embedded resolver\n";
+    std::cout << "  --mock-loss <0..1>     UDP loss of the embedded resolver\n";
+    std::cout << "Workload:\n";
+    std::cout << "  --client <c>           sync (ChimeraClient) or async (AsyncChimeraClient) (default: sync)\n";
+    std::cout << "  --op <op>              send, receive (sync only) or ping (default: send)\n";
+    std::cout << "  --encoding <name>      txt, multi or distributed (default: multi)\n";
+    std::cout << "  --payload <dist>       fixed:N, uniform:MIN:MAX or exp:MEAN[:MAX] (default: fixed:256)\n";
+    std::cout << "  --mode <m>             open (fixed schedule) or closed (default: closed)\n";
+    std::cout << "  --qps <n>              Total target rate; required for open loop\n";
+    std::cout << "  --concurrency <list>   Senders, e.g. 8 or 1,2,4,8,16 for a sweep (default: 1)\n";
+    std::cout << "  --duration <s>         Measured seconds per step (default: 10)\n";
+    std::cout << "  --warmup <s>           Unmeasured seconds per step (default: 2)\n";
+    std::cout << "  --fragment-delay-ms <ms>  Pause between send_data fragments (default: 10)\n";
+    std::cout << "  --timeout-ms <ms>      Client timeout (default: 2000)\n";
+    std::cout << "  --seed <n>             Seed for payload sizes and contents (default: 1)\n";
+    std::cout << "Client-side faults (FaultInjectingTransport):\n";
+    std::cout << "  --fault-loss <list>    Request loss, e.g. 0,0.01,0.05,0.1 for a goodput-vs-loss sweep\n";
+    std::cout << "  --fault-response-loss <p>  Response loss\n";
+    std::cout << "  --fault-delay-ms <ms>  Added response delay (mean)\n";
+    std::cout << "  --fault-jitter-ms <ms> Delay spread for uniform/normal\n";
+    std::cout << "  --fault-delay-dist <d> constant, uniform, normal, exponential or pareto (default: constant)\n";
+    std::cout << "  --fault-duplicate <p>  Duplicated responses\n";
+    std::cout << "  --fault-reorder <p>    Swapped pipelined responses\n";
+    std::cout << "  --fault-truncate <p>   Truncated responses\n";
+    std::cout << "  --fault-bandwidth-kbps <n>  Link capacity shared by all senders\n";
+    std::cout << "Output:\n";
+    std::cout << "  --json <path>          Results as JSON\n";
+    std::cout << "  --hdr <path>           HdrHistogram percentile distribution (ms)\n";
+    std::cout << "  --trace <path>         Chrome trace-event JSON of the pipeline spans (Perfetto)\n";
+    std::cout << "  -h, --help             Show this help\n";
+    std::cout << "\nExample:\n";
+    std::cout << "  " << program_name << " --embedded --transport dot --mode open --qps 500 --concurrency 1,4,16\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    LoadOptions options;
+    options.client.dns_server = "127.0.0.1";
+    options.client.dns_port = 5353;
+    options.client.timeout = std::chrono::milliseconds(2000);
+    options.client.randomize_fragments = false;
+    options.client.noise_ratio = 0.0;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        const std::string value = has_value ? argv[i + 1] : "";
+        bool ok = true;
+
+        try {
+            if (arg == "-h" || arg == "--help") {
+                print_usage(argv[0]);
+                return 0;
+            } else if (arg == "--embedded") {
+                options.embedded = true;
+                continue;
+            } else if (!has_value) {
+                ok = false;
+            } else if (arg == "--transport") {
+                if (value == "udp") {
+                    options.client.transport = chimera::TransportType::UDP;
+                } else if (value == "dot") {
+                    options.client.transport = chimera::TransportType::DoT;
+                } else if (value == "doh") {
+                    options.client.transport = chimera::TransportType::DoH;
+                } else if (value == "loopback") {
+                    options.loopback = chimera::LoopbackMode::Ring;
+                } else if (value == "loopback-socketpair") {
+                    options.loopback = chimera::LoopbackMode::SocketPair;
+                } else {
+                    ok = false;
+                }
+            } else if (arg == "--server") {
+                options.client.dns_server = value;
+            } else if (arg == "--port") {
+                options.client.dns_port = static_cast<uint16_t>(std::stoi(value));
+            } else if (arg == "--ca-file") {
+                options.client.doh_ca_file = value;
+            } else if (arg == "--domain") {
+                options.client.target_domain = value;
+            } else if (arg == "--mock-latency-ms") {
+                options.mock_latency = std::chrono::microseconds(static_cast<int64_t>(std::stod(value) * 1000));
+            } else if (arg == "--mock-loss") {
+                options.mock_loss = std::stod(value);
+            } else if (arg == "--client") {
+                ok = value == "sync" || value == "async";
+                options.async_client = value == "async";
+            } else if (arg == "--op") {
+                if (value == "send") {
+                    options.operation = Operation::Send;
+                } else if (value == "receive") {
+                    options.operation = Operation::Receive;
+                } else if (value == "ping") {
+                    options.operation = Operation::Ping;
+                } else {
+                    ok = false;
+                }
+            } else if (arg == "--encoding") {
+                if (value == "txt") {
+                    options.client.encoding_strategy = chimera::EncodingStrategy::TXT_ONLY;
+                } else if (value == "multi") {
+                    options.client.encoding_strategy = chimera::EncodingStrategy::MULTI_RECORD;
+                } else if (value == "distributed") {
+                    options.client.encoding_strategy = chimera::EncodingStrategy::DISTRIBUTED;
+                } else {
+                    ok = false;
+                }
+            } else if (arg == "--payload") {
+                ok = SizeDistribution::parse(value, options.payload);
+            } else if (arg == "--mode") {
+                ok = value == "open" || value == "closed";
+                options.open_loop = value == "open";
+            } else if (arg == "--qps") {
+                options.qps = std::stod(value);
+            } else if (arg == "--concurrency") {
+                options.concurrency.clear();
+                std::stringstream list(value);
+                for (std::string part; std::getline(list, part, ',');) {
+                    options.concurrency.push_back(std::max<size_t>(1, std::stoul(part)));
+                }
+                ok = !options.concurrency.empty();
+            } else if (arg == "--duration") {
+                options.duration = std::chrono::seconds(std::stoi(value));
+            } else if (arg == "--warmup") {
+                options.warmup = std::chrono::seconds(std::stoi(value));
+            } else if (arg == "--fragment-delay-ms") {
+                options.client.fragment_delay = std::chrono::milliseconds(std::stoi(value));
+            } else if (arg == "--timeout-ms") {
+                options.client.timeout = std::chrono::milliseconds(std::stoi(value));
+            } else if (arg == "--seed") {
+                options.seed = std::stoull(value);
+                options.faults.seed = options.seed;
+            } else if (arg == "--fault-loss") {
+                options.fault_loss.clear();
+                std::stringstream list(value);
+                for (std::string part; std::getline(list, part, ',');) {
+                    options.fault_loss.push_back(std::stod(part));
+                    ok = ok && options.fault_loss.back() >= 0.0 && options.fault_loss.back() <= 1.0;
+                }
+                ok = ok && !options.fault_loss.empty();
+            } else if (arg == "--fault-response-loss") {
+                options.faults.response_loss_rate = std::stod(value);
+            } else if (arg == "--fault-delay-ms") {
+                options.faults.delay = std::chrono::microseconds(static_cast<int64_t>(std::stod(value) * 1000));
+            } else if (arg == "--fault-jitter-ms") {
+                options.faults.delay_jitter = std::chrono::microseconds(static_cast<int64_t>(std::stod(value) * 1000));
+            } else if (arg == "--fault-delay-dist") {
+                if (value == "constant") {
+                    options.faults.delay_distribution = chimera::DelayDistribution::Constant;
+                } else if (value == "uniform") {
+                    options.faults.delay_distribution = chimera::DelayDistribution::Uniform;
+                } else if (value == "normal") {
+                    options.faults.delay_distribution = chimera::DelayDistribution::Normal;
+                } else if (value == "exponential") {
+                    options.faults.delay_distribution = chimera::DelayDistribution::Exponential;
+                } else if (value == "pareto") {
+                    options.faults.delay_distribution = chimera::DelayDistribution::Pareto;
+                } else {
+                    ok = false;
+                }
+            } else if (arg == "--fault-duplicate") {
+                options.faults.duplicate_rate = std::stod(value);
+            } else if (arg == "--fault-reorder") {
+                options.faults.reorder_rate = std::stod(value);
+            } else if (arg == "--fault-truncate") {
+                options.faults.truncate_rate = std::stod(value);
+            } else if (arg == "--fault-bandwidth-kbps") {
+                options.faults.bandwidth_bps = static_cast<uint64_t>(std::stod(value) * 1000);
+            } else if (arg == "--json") {
+                options.json_path = value;
+            } else if (arg == "--hdr") {
+                options.hdr_path = value;
+            } else if (arg == "--trace") {
+                options.trace_path = value;
+            } else {
+                ok = false;
+            }
+        } catch (const std::exception&) {
+            ok = false;
+        }
+
+        if (!ok) {
+            std::cerr << "Invalid option: " << arg << (has_value ? " " + value : "") << std::endl;
+            print_usage(argv[0]);
+            return 1;
+        }
+        ++i;
+    }
+
+    if (options.open_loop && options.qps <= 0) {
+        std::cerr << "Open loop needs --qps" << std::endl;
+        return 1;
+    }
+    if (options.async_client && options.operation == Operation::Receive) {
+        std::cerr << "AsyncChimeraClient has no receive operation" << std::endl;
+        return 1;
+    }
+
+    std::unique_ptr<chimera::MockDnsServer> mock;
+    std::string mock_ca_file;
+    if (options.embedded && options.loopback) {
+        std::cerr << "--embedded needs a network transport" << std::endl;
+        return 1;
+    }
+    if (options.embedded) {
+        chimera::MockServerConfig mock_config;
+        mock_config.udp_port = mock_config.tcp_port = mock_config.dot_port = mock_config.doh_port = 0;
+        // Incompressible, so every encoding spreads it over several answers
+        std::mt19937_64 payload_rng(options.seed);
+        mock_config.payload = make_payload(1024, payload_rng);
+        mock_config.strategy = options.client.encoding_strategy;
+        mock_config.latency = options.mock_latency;
+        mock_config.loss_rate = options.mock_loss;
+        mock_config.seed = options.seed;
+        try {
+            mock = std::make_unique<chimera::MockDnsServer>(mock_config);
+        } catch (const std::exception& e) {
+            std::cerr << "Embedded resolver failed: " << e.what() << std::endl;
+            return 1;
+        }
+        mock->start();
+        if (options.operation == Operation::Receive) {
+            options.expected_receive_bytes = mock->extractable_answer_bytes();
+            if (options.expected_receive_bytes == 0) {
+                std::cerr << "Embedded resolver answers are not decodable with this encoding" << std::endl;
+                return 1;
+            }
+        }
+
+        options.client.dns_server = "127.0.0.1";
+        switch (options.client.transport) {
+            case chimera::TransportType::UDP:
+                options.client.dns_port = mock->port(chimera::MockTransport::UDP);
+                break;
+            case chimera::TransportType::DoT:
+                options.client.dns_port = mock->port(chimera::MockTransport::DoT);
+                break;
+            case chimera::TransportType::DoH:
+                options.client.dns_server += ":" + std::to_string(mock->port(chimera::MockTransport::DoH));
+                mock_ca_file = "chimera_loadgen_" + std::to_string(::getpid()) + ".pem";
+                std::ofstream(mock_ca_file) << mock->certificate_pem();
+                options.client.doh_ca_file = mock_ca_file;
+                break;
+        }
+    }
+
+    if (options.loopback) {
+        options.client.transport_factory = chimera::LoopbackServer::create({}, *options.loopback)->factory();
+    }
+
+    std::cout << "CHIMERA loadgen: " << target_name(options) << " "
+              << (options.loopback ? "in-process" : options.client.dns_server)
+              << (options.loopback || options.client.transport == chimera::TransportType::DoH
+                      ? "" : ":" + std::to_string(options.client.dns_port))
+              << ", " << (options.async_client ? "async" : "sync") << " client, "
+              << operation_name(options.operation) << ", payload " << options.payload.describe() << ", "
+              << (options.open_loop ? "open" : "closed") << " loop"
+              << (options.qps > 0 ? " at " + std::to_string(static_cast<long>(options.qps)) + " qps" : "")
+              << ", " << options.warmup.count() << "s warmup + " << options.duration.count() << "s per step"
+              << std::endl;
+    if (!options.open_loop && options.qps <= 0) {
+        std::cout << "Unpaced closed loop: latencies are service times (no coordinated-omission correction)" << std::endl;
+    }
+
+    std::printf("\n%6s %6s %10s %10s %12s %8s %9s %9s %9s %9s %9s\n", "conc", "loss", "target/s", "ok/s",
+                "goodput KiB/s", "errors", "p50 ms", "p90 ms", "p99 ms", "p99.9 ms", "max ms");
+
+    if (!options.trace_path.empty()) {
+        chimera::Tracer::start();
+    }
+    std::vector<StepResult> steps;
+    for (double loss_rate : options.fault_loss) {
+        for (size_t concurrency : options.concurrency) {
+            steps.push_back(run_step(options, concurrency, loss_rate));
+            print_step(steps.back());
+        }
+    }
+    chimera::Tracer::stop();
+
+    for (const auto& step : steps) {
+        for (const auto& [name, count] : step.stats.errors) {
+            std::cout << "  c=" << step.concurrency << " loss=" << step.loss_rate << " " << name
+                      << " errors: " << count << std::endl;
+        }
+    }
+
+    if (mock) {
+        mock->stop();
+        if (!mock_ca_file.empty()) {
+            std::remove(mock_ca_file.c_str());
+        }
+    }
+
+    if (!options.json_path.empty() && !write_json(options.json_path, options, steps)) {
+        std::cerr << "Failed to write " << options.json_path << std::endl;
+        return 1;
+    }
+    if (!options.hdr_path.empty() && !write_hdr(options.hdr_path, options, steps)) {
+        std::cerr << "Failed to write " << options.hdr_path << std::endl;
+        return 1;
+    }
+    if (!options.trace_path.empty()) {
+        if (!chimera::Tracer::write_chrome_json(options.trace_path)) {
+            std::cerr << "Failed to write " << options.trace_path << std::endl;
+            return 1;
+        }
+        if (const size_t dropped = chimera::Tracer::dropped()) {
+            std::cout << "Trace: " << dropped << " spans dropped (per-thread ring full)" << std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,895 @@
+#include "mock_dns_server.hpp"
+#include "chimera/base64.hpp"
+#include "chimera/dns_packet.hpp"
+#include <openssl/err.h>
+#include <openssl/pem.h>
+#include <openssl/ssl.h>
+#include <openssl/x509v3.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <condition_variable>
+#include <csignal>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <list>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace chimera {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int POLL_INTERVAL_MS = 100;          // How quickly idle loops notice stop()
+constexpr size_t HTTP_HEADER_LIMIT = 16 * 1024;
+
+std::runtime_error socket_error(const std::string& what) {
+    return std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+// Fragment id from the subdomain labels SteganographicEncoder generates
+// ("www<hex>", "ipv6-<hex>", "mail<hex>", "srv<hex>"); -1 for other names
+long fragment_id_of(const std::string& qname) {
+    const std::string label = qname.substr(0, qname.find('.'));
+    for (const char* prefix : {"ipv6-", "www", "mail", "srv"}) {
+        const size_t length = std::strlen(prefix);
+        if (label.size() > length && label.compare(0, length, prefix) == 0) {
+            const std::string digits = label.substr(length);
+            if (digits.find_first_not_of("0123456789abcdef") == std::string::npos) {
+                return std::stol(digits, nullptr, 16);
+            }
+        }
+    }
+    return -1;
+}
+
+std::vector<uint8_t> base64url_decode(std::string text) {
+    std::replace(text.begin(), text.end(), '-', '+');
+    std::replace(text.begin(), text.end(), '_', '/');
+    while (text.size() % 4 != 0) {
+        text += '=';
+    }
+    const std::string decoded = Base64::decode(text);
+    return std::vector<uint8_t>(decoded.begin(), decoded.end());
+}
+
+// Content-Length header value; nullopt unless it is a plain decimal that
+// fits one DNS message, so a hostile client cannot make us buffer without limit
+std::optional<size_t> parse_content_length(const std::string& value) {
+    const size_t first = value.find_first_not_of(" \t");
+    const size_t last = value.find_last_not_of(" \t\r");
+    if (first == std::string::npos) {
+        return std::nullopt;
+    }
+    size_t length = 0;
+    const char* end = value.data() + last + 1;
+    const auto [ptr, ec] = std::from_chars(value.data() + first, end, length);
+    if (ec != std::errc() || ptr != end || length > DNS_TCP_MESSAGE_LIMIT) {
+        return std::nullopt;
+    }
+    return length;
+}
+
+// Blocking byte stream over a plain socket or a TLS session
+struct StreamIo {
+    int fd;
+    SSL* ssl;
+
+    long read_some(uint8_t* buffer, size_t length) const {
+        if (ssl) {
+            return SSL_read(ssl, buffer, static_cast<int>(length));
+        }
+        return recv(fd, buffer, length, 0);
+    }
+
+    bool read_exact(uint8_t* buffer, size_t length) const {
+        size_t done = 0;
+        while (done < length) {
+            const long n = read_some(buffer + done, length - done);
+            if (n <= 0) {
+                return false;
+            }
+            done += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    bool write_all(const uint8_t* buffer, size_t length) const {
+        size_t done = 0;
+        while (done < length) {
+            const long n = ssl ? SSL_write(ssl, buffer + done, static_cast<int>(length - done))
+                               : send(fd, buffer + done, length - done, MSG_NOSIGNAL);
+            if (n <= 0) {
+                return false;
+            }
+            done += static_cast<size_t>(n);
+        }
+        return true;
+    }
+};
+
+struct QueryRecord {
+    MockTransport transport = MockTransport::UDP;
+    uint16_t id = 0;
+    std::string qname;
+    uint16_t qtype = 0;
+    long fragment = -1;
+    size_t answers = 0;
+    size_t response_bytes = 0;
+    std::chrono::nanoseconds service{0};
+    std::chrono::microseconds delay{0};
+    const char* outcome = "answered";
+};
+
+} // namespace
+
+class MockDnsServer::Impl {
+    // UDP response held back to emulate latency
+    struct DelayedDatagram {
+        Clock::time_point due;
+        int fd;
+        sockaddr_in peer;
+        std::vector<uint8_t> packet;
+
+        bool operator>(const DelayedDatagram& other) const { return due > other.due; }
+    };
+
+    struct Connection {
+        std::thread thread;
+        int fd;
+        bool done = false;
+    };
+
+    MockServerConfig config_;
+    std::map<DnsType, std::vector<std::vector<uint8_t>>> answers_;
+    std::vector<uint8_t> fallback_ipv4_;
+    size_t extractable_bytes_ = 0;
+
+    std::vector<int> udp_fds_;
+    int tcp_fd_ = -1;
+    int dot_fd_ = -1;
+    int doh_fd_ = -1;
+    std::array<uint16_t, 4> ports_{};
+
+    SSL_CTX* ssl_ctx_ = nullptr;
+    std::string certificate_pem_;
+
+    std::atomic<bool> running_{false};
+    std::vector<std::thread> threads_;
+    std::atomic<uint64_t> connection_seeds_{0};
+
+    std::mutex connections_mutex_;
+    std::list<Connection> connections_;
+
+    std::mutex delay_mutex_;
+    std::condition_variable delay_cv_;
+    std::priority_queue<DelayedDatagram, std::vector<DelayedDatagram>, std::greater<>> delayed_;
+
+    std::mutex log_mutex_;
+    std::ofstream log_;
+    const Clock::time_point started_ = Clock::now();
+
+    std::array<std::atomic<uint64_t>, 4> queries_{};
+    std::atomic<uint64_t> answered_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> truncated_{0};
+    std::atomic<uint64_t> malformed_{0};
+    std::atomic<uint64_t> service_ns_{0};
+
+public:
+    explicit Impl(MockServerConfig config) : config_(std::move(config)) {
+        build_answers();
+
+        try {
+            if (config_.enable_udp) {
+                open_udp();
+            }
+            if (config_.enable_tcp) {
+                tcp_fd_ = open_listener(config_.tcp_port, MockTransport::TCP);
+            }
+            if (config_.enable_dot || config_.enable_doh) {
+                create_tls_context();
+            }
+            if (config_.enable_dot) {
+                dot_fd_ = open_listener(config_.dot_port, MockTransport::DoT);
+            }
+            if (config_.enable_doh) {
+                doh_fd_ = open_listener(config_.doh_port, MockTransport::DoH);
+            }
+        } catch (...) {
+            close_listeners();
+            if (ssl_ctx_) {
+                SSL_CTX_free(ssl_ctx_);
+            }
+            throw;
+        }
+
+        if (!config_.log_path.empty()) {
+            log_.open(config_.log_path);
+            if (!log_) {
+                throw std::runtime_error("Cannot open query log " + config_.log_path);
+            }
+            log_ << "time_us,transport,id,qname,qtype,fragment,answers,response_bytes,service_us,delay_us,outcome\n";
+        }
+    }
+
+    ~Impl() {
+        stop();
+        close_listeners();
+        if (ssl_ctx_) {
+            SSL_CTX_free(ssl_ctx_);
+        }
+    }
+
+    void start() {
+        if (running_.exchange(true)) {
+            return;
+        }
+        // A peer closing mid-write must not kill the process
+        std::signal(SIGPIPE, SIG_IGN);
+
+        for (size_t i = 0; i < udp_fds_.size(); ++i) {
+            threads_.emplace_back([this, i]() { udp_loop(udp_fds_[i], config_.seed + i); });
+        }
+        if (!udp_fds_.empty()) {
+            threads_.emplace_back([this]() { delay_loop(); });
+        }
+        for (auto [fd, transport] : {std::pair{tcp_fd_, MockTransport::TCP},
+                                     std::pair{dot_fd_, MockTransport::DoT},
+                                     std::pair{doh_fd_, MockTransport::DoH}}) {
+            if (fd >= 0) {
+                threads_.emplace_back([this, fd, transport]() { accept_loop(fd, transport); });
+            }
+        }
+    }
+
+    void stop() {
+        if (!running_.exchange(false)) {
+            return;
+        }
+        delay_cv_.notify_all();
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+        threads_.clear();
+
+        // Wake connection threads blocked in reads, then join them
+        std::list<Connection> connections;
+        {
+            std::lock_guard<std::mutex> lock(connections_mutex_);
+            for (auto& connection : connections_) {
+                if (!connection.done) {
+                    shutdown(connection.fd, SHUT_RDWR);
+                }
+            }
+            connections.splice(connections.end(), connections_);
+        }
+        for (auto& connection : connections) {
+            connection.thread.join();
+        }
+
+        std::lock_guard<std::mutex> lock(log_mutex_);
+        if (log_.is_open()) {
+            log_.flush();
+        }
+    }
+
+    uint16_t port(MockTransport transport) const {
+        return ports_[static_cast<size_t>(transport)];
+    }
+
+    MockServerStats stats() const {
+        MockServerStats stats;
+        for (size_t i = 0; i < queries_.size(); ++i) {
+            stats.queries[i] = queries_[i].load();
+        }
+        stats.answered = answered_.load();
+        stats.dropped = dropped_.load();
+        stats.truncated = truncated_.load();
+        stats.malformed = malformed_.load();
+        stats.service_ns = service_ns_.load();
+        return stats;
+    }
+
+    const std::string& certificate_pem() const { return certificate_pem_; }
+    size_t extractable_answer_bytes() const { return extractable_bytes_; }
+
+private:
+    // Answer set
+
+    void build_answers() {
+        fallback_ipv4_.resize(4);
+        if (inet_pton(AF_INET, config_.fallback_ipv4.c_str(), fallback_ipv4_.data()) != 1) {
+            throw std::runtime_error("Invalid fallback IPv4 address " + config_.fallback_ipv4);
+        }
+        if (config_.payload.empty()) {
+            return;
+        }
+
+        EncodingConfig encoding;
+        encoding.strategy = config_.strategy;
+        encoding.max_txt_length = config_.max_txt_length;
+        encoding.max_fragments = std::numeric_limits<uint16_t>::max();
+        encoding.randomize_order = false;
+        encoding.noise_ratio = 0.0;
+
+        auto fragments = SteganographicEncoder(encoding).encode_payload(config_.payload, "mock");
+        if (!fragments) {
+            throw std::runtime_error("Answer payload cannot be encoded with the selected strategy");
+        }
+
+        std::vector<DnsResourceRecord> records;
+        for (const auto& fragment : fragments.value()) {
+            auto rdata = fragment.record_type == DnsType::TXT
+                ? DnsPacketBuilder::build_txt_rdata(std::string(fragment.encoded_data.begin(), fragment.encoded_data.end()))
+                : fragment.encoded_data;
+            records.push_back({fragment.domain, fragment.record_type, DnsClass::IN, config_.ttl, rdata});
+            answers_[fragment.record_type].push_back(std::move(rdata));
+        }
+
+        // Same decoding path a client's receive_data runs on these answers
+        auto extracted = SteganographicExtractor::extract_from_dns_response(records);
+        extractable_bytes_ = extracted ? extracted->size() : 0;
+    }
+
+    std::vector<DnsResourceRecord> answers_for(const DnsQuestion& q) const {
+        std::vector<DnsResourceRecord> records;
+        auto it = answers_.find(q.type);
+        if (it != answers_.end()) {
+            records.reserve(it->second.size());
+            for (const auto& rdata : it->second) {
+                records.push_back({q.name, q.type, DnsClass::IN, config_.ttl, rdata});
+            }
+        } else if (q.type == DnsType::A) {
+            records.push_back({q.name, DnsType::A, DnsClass::IN, config_.ttl, fallback_ipv4_});
+        }
+        return records;
+    }
+
+    // Builds the response to one query; empty when the query is malformed
+    std::vector<uint8_t> respond(const std::vector<uint8_t>& query, size_t size_limit, QueryRecord& record) {
+        const auto start = Clock::now();
+        queries_[static_cast<size_t>(record.transport)].fetch_add(1, std::memory_order_relaxed);
+
+        std::vector<uint8_t> response;
+        try {
+            DnsHeader header{};
+            const DnsQuestion q = DnsPacketBuilder::parse_query(query, header);
+            record.id = header.id;
+            record.qname = q.name;
+            record.qtype = static_cast<uint16_t>(q.type);
+            record.fragment = fragment_id_of(q.name);
+
+            const auto answers = answers_for(q);
+            response = DnsPacketBuilder::build_response(header, q, answers);
+            record.answers = answers.size();
+            if (response.size() > size_limit) {
+                response = DnsPacketBuilder::build_response(header, q, {}, 0, true);
+                record.answers = 0;
+                record.outcome = "truncated";
+                truncated_.fetch_add(1, std::memory_order_relaxed);
+            }
+        } catch (const std::exception&) {
+            record.outcome = "malformed";
+            malformed_.fetch_add(1, std::memory_order_relaxed);
+            response.clear();
+        }
+
+        record.service = Clock::now() - start;
+        record.response_bytes = response.size();
+        service_ns_.fetch_add(static_cast<uint64_t>(record.service.count()), std::memory_order_relaxed);
+        return response;
+    }
+
+    std::chrono::microseconds next_delay(std::mt19937_64& rng) const {
+        if (config_.jitter.count() == 0) {
+            return config_.latency;
+        }
+        std::uniform_int_distribution<int64_t> jitter(-config_.jitter.count(), config_.jitter.count());
+        return std::max(std::chrono::microseconds(0), config_.latency + std::chrono::microseconds(jitter(rng)));
+    }
+
+    void log_query(const QueryRecord& record) {
+        if (!log_.is_open()) {
+            return;
+        }
+        const auto now = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - started_);
+        std::lock_guard<std::mutex> lock(log_mutex_);
+        log_ << now.count() << ',' << transport_name(record.transport) << ',' << record.id << ','
+             << record.qname << ',' << record.qtype << ',' << record.fragment << ','
+             << record.answers << ',' << record.response_bytes << ','
+             << std::chrono::duration_cast<std::chrono::microseconds>(record.service).count() << ','
+             << record.delay.count() << ',' << record.outcome << '\n';
+    }
+
+    // UDP
+
+    void open_udp() {
+        const size_t threads = config_.udp_threads ? config_.udp_threads
+                                                   : std::max(1u, std::thread::hardware_concurrency());
+        // Claim the port exclusively first, so a second server (or a resolver
+        // already on it) is an error rather than a silent query split
+        const int exclusive_fd = bind_socket(SOCK_DGRAM, config_.udp_port, false);
+        const uint16_t port = bound_port(exclusive_fd);
+        if (threads == 1) {
+            udp_fds_.push_back(exclusive_fd);
+        } else {
+            // SO_REUSEPORT gives each worker its own socket and lets the kernel
+            // spread queries; Linux needs it on every socket of the group, so
+            // the exclusive socket is swapped for the group
+            close(exclusive_fd);
+            for (size_t i = 0; i < threads; ++i) {
+                udp_fds_.push_back(bind_socket(SOCK_DGRAM, port, true));
+            }
+        }
+        ports_[static_cast<size_t>(MockTransport::UDP)] = port;
+    }
+
+    void udp_loop(int fd, uint64_t seed) {
+        std::mt19937_64 rng(seed);
+        std::bernoulli_distribution lose(config_.loss_rate);
+        std::vector<uint8_t> buffer(DNS_EDNS_MESSAGE_LIMIT);
+
+        while (running_.load(std::memory_order_relaxed)) {
+            pollfd pfd{fd, POLLIN, 0};
+            if (poll(&pfd, 1, POLL_INTERVAL_MS) <= 0) {
+                continue;
+            }
+
+            sockaddr_in peer{};
+            socklen_t peer_len = sizeof(peer);
+            const ssize_t received = recvfrom(fd, buffer.data(), buffer.size(), 0,
+                                              reinterpret_cast<sockaddr*>(&peer), &peer_len);
+            if (received <= 0) {
+                continue;
+            }
+
+            QueryRecord record;
+            record.transport = MockTransport::UDP;
+            auto response = respond(std::vector<uint8_t>(buffer.begin(), buffer.begin() + received),
+                                    DNS_EDNS_MESSAGE_LIMIT, record);
+            if (response.empty()) {
+                log_query(record);
+                continue;
+            }
+
+            if (config_.loss_rate > 0 && lose(rng)) {
+                record.outcome = "dropped";
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                log_query(record);
+                continue;
+            }
+
+            record.delay = next_delay(rng);
+            answered_.fetch_add(1, std::memory_order_relaxed);
+            log_query(record);
+            if (record.delay.count() == 0) {
+                sendto(fd, response.data(), response.size(), 0, reinterpret_cast<sockaddr*>(&peer), peer_len);
+            } else {
+                std::lock_guard<std::mutex> lock(delay_mutex_);
+                delayed_.push({Clock::now() + record.delay, fd, peer, std::move(response)});
+                delay_cv_.notify_one();
+            }
+        }
+    }
+
+    // Sends delayed UDP responses when due, so latency does not occupy workers
+    void delay_loop() {
+        std::unique_lock<std::mutex> lock(delay_mutex_);
+        while (running_.load(std::memory_order_relaxed)) {
+            if (delayed_.empty()) {
+                delay_cv_.wait_for(lock, std::chrono::milliseconds(POLL_INTERVAL_MS));
+                continue;
+            }
+            const auto due = delayed_.top().due;
+            if (Clock::now() < due) {
+                delay_cv_.wait_until(lock, due);
+                continue;
+            }
+            DelayedDatagram datagram = delayed_.top();
+            delayed_.pop();
+            lock.unlock();
+            sendto(datagram.fd, datagram.packet.data(), datagram.packet.size(), 0,
+                   reinterpret_cast<const sockaddr*>(&datagram.peer), sizeof(datagram.peer));
+            lock.lock();
+        }
+    }
+
+    // Stream listeners (TCP, DoT, DoH)
+
+    int open_listener(uint16_t port, MockTransport transport) {
+        const int fd = bind_socket(SOCK_STREAM, port, false);
+        if (listen(fd, SOMAXCONN) < 0) {
+            close(fd);
+            throw socket_error(std::string("listen failed for ") + transport_name(transport));
+        }
+        ports_[static_cast<size_t>(transport)] = bound_port(fd);
+        return fd;
+    }
+
+    void accept_loop(int listen_fd, MockTransport transport) {
+        while (running_.load(std::memory_order_relaxed)) {
+            reap_connections();
+
+            pollfd pfd{listen_fd, POLLIN, 0};
+            if (poll(&pfd, 1, POLL_INTERVAL_MS) <= 0) {
+                continue;
+            }
+            const int fd = accept(listen_fd, nullptr, nullptr);
+            if (fd < 0) {
+                continue;
+            }
+
+            // One thread per connection: connections are serial request/response streams
+            std::lock_guard<std::mutex> lock(connections_mutex_);
+            auto& connection = connections_.emplace_back();
+            connection.fd = fd;
+            const uint64_t seed = config_.seed + 0x9E3779B97F4A7C15ull * (connection_seeds_.fetch_add(1) + 1);
+            connection.thread = std::thread([this, &connection, transport, seed]() {
+                serve_connection(connection, transport, seed);
+            });
+        }
+    }
+
+    void reap_connections() {
+        std::list<Connection> finished;
+        {
+            std::lock_guard<std::mutex> lock(connections_mutex_);
+            for (auto it = connections_.begin(); it != connections_.end();) {
+                auto next = std::next(it);
+                if (it->done) {
+                    finished.splice(finished.end(), connections_, it);
+                }
+                it = next;
+            }
+        }
+        for (auto& connection : finished) {
+            connection.thread.join();
+        }
+    }
+
+    void serve_connection(Connection& connection, MockTransport transport, uint64_t seed) {
+        std::mt19937_64 rng(seed);
+        SSL* ssl = nullptr;
+        bool ready = true;
+
+        if (transport != MockTransport::TCP) {
+            ssl = SSL_new(ssl_ctx_);
+            ready = ssl && SSL_set_fd(ssl, connection.fd) == 1 && SSL_accept(ssl) == 1;
+        }
+
+        if (ready) {
+            const StreamIo io{connection.fd, ssl};
+            if (transport == MockTransport::DoH) {
+                serve_http(io, rng);
+            } else {
+                serve_dns_stream(io, transport, rng);
+            }
+        }
+
+        if (ssl) {
+            SSL_shutdown(ssl);
+            SSL_free(ssl);
+        }
+        ERR_clear_error();
+
+        std::lock_guard<std::mutex> lock(connections_mutex_);
+        close(connection.fd);
+        connection.done = true;
+    }
+
+    // RFC 7766 framing: 2-byte length prefix per message
+    void serve_dns_stream(const StreamIo& io, MockTransport transport, std::mt19937_64& rng) {
+        std::vector<uint8_t> query;
+        while (running_.load(std::memory_order_relaxed)) {
+            uint8_t prefix[2];
+            if (!io.read_exact(prefix, 2)) {
+                return;
+            }
+            query.resize((prefix[0] << 8) | prefix[1]);
+            if (!io.read_exact(query.data(), query.size())) {
+                return;
+            }
+
+            QueryRecord record;
+            record.transport = transport;
+            auto response = respond(query, DNS_TCP_MESSAGE_LIMIT, record);
+            if (response.empty()) {
+                log_query(record);
+                return;
+            }
+            record.delay = next_delay(rng);
+            answered_.fetch_add(1, std::memory_order_relaxed);
+            log_query(record);
+            std::this_thread::sleep_for(record.delay);
+
+            response.insert(response.begin(), {static_cast<uint8_t>(response.size() >> 8),
+                                               static_cast<uint8_t>(response.size() & 0xFF)});
+            if (!io.write_all(response.data(), response.size())) {
+                return;
+            }
+        }
+    }
+
+    // Minimal HTTP/1.1 DoH endpoint (RFC 8484): GET ?dns=<base64url> and POST
+    // application/dns-message on /dns-query, keep-alive unless the client closes
+    void serve_http(const StreamIo& io, std::mt19937_64& rng) {
+        std::string buffer;
+        uint8_t chunk[4096];
+
+        while (running_.load(std::memory_order_relaxed)) {
+            size_t header_end;
+            while ((header_end = buffer.find("\r\n\r\n")) == std::string::npos) {
+                if (buffer.size() > HTTP_HEADER_LIMIT) {
+                    return;
+                }
+                const long n = io.read_some(chunk, sizeof(chunk));
+                if (n <= 0) {
+                    return;
+                }
+                buffer.append(reinterpret_cast<const char*>(chunk), static_cast<size_t>(n));
+            }
+
+            std::istringstream head(buffer.substr(0, header_end));
+            std::string method, target, version, line;
+            head >> method >> target >> version;
+            std::getline(head, line);
+
+            size_t content_length = 0;
+            int status = 200;
+            bool keep_alive = version == "HTTP/1.1";
+            while (std::getline(head, line)) {
+                std::string lower(line);
+                std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+                if (lower.rfind("content-length:", 0) == 0) {
+                    const auto length = parse_content_length(lower.substr(15));
+                    content_length = length.value_or(0);
+                    if (!length) {
+                        status = 400;
+                    }
+                } else if (lower.rfind("connection:", 0) == 0) {
+                    keep_alive = lower.find("close") == std::string::npos;
+                }
+            }
+            buffer.erase(0, header_end + 4);
+            // Without a usable length the body cannot be framed; answer and drop the connection
+            keep_alive = keep_alive && status == 200;
+
+            while (buffer.size() < content_length) {
+                const long n = io.read_some(chunk, sizeof(chunk));
+                if (n <= 0) {
+                    return;
+                }
+                buffer.append(reinterpret_cast<const char*>(chunk), static_cast<size_t>(n));
+            }
+            const std::string body = buffer.substr(0, content_length);
+            buffer.erase(0, content_length);
+
+            std::vector<uint8_t> query;
+            const std::string path = target.substr(0, target.find('?'));
+            if (status != 200) {
+                // Content-Length was rejected above
+            } else if (path != "/dns-query") {
+                status = 404;
+            } else if (method == "POST") {
+                query.assign(body.begin(), body.end());
+            } else if (method == "GET") {
+                const size_t param = target.find("dns=");
+                try {
+                    if (param != std::string::npos) {
+                        query = base64url_decode(target.substr(param + 4, target.find('&', param) - param - 4));
+                    }
+                } catch (const std::exception&) {
+                    query.clear();
+                }
+            } else {
+                status = 405;
+            }
+
+            std::vector<uint8_t> response;
+            if (status == 200) {
+                QueryRecord record;
+                record.transport = MockTransport::DoH;
+                response = respond(query, DNS_TCP_MESSAGE_LIMIT, record);
+                if (response.empty()) {
+                    status = 400;
+                } else {
+                    record.delay = next_delay(rng);
+                    answered_.fetch_add(1, std::memory_order_relaxed);
+                    std::this_thread::sleep_for(record.delay);
+                }
+                log_query(record);
+            }
+
+            std::ostringstream reply;
+            reply << "HTTP/1.1 " << status << (status == 200 ? " OK" : " Error") << "\r\n"
+                  << "Content-Type: application/dns-message\r\n"
+                  << "Content-Length: " << response.size() << "\r\n"
+                  << "Cache-Control: max-age=0\r\n"
+                  << (keep_alive ? "" : "Connection: close\r\n") << "\r\n";
+            std::string bytes = reply.str();
+            bytes.append(response.begin(), response.end());
+            if (!io.write_all(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size()) || !keep_alive) {
+                return;
+            }
+        }
+    }
+
+    // TLS
+
+    void create_tls_context() {
+        EVP_PKEY* key = nullptr;
+        EVP_PKEY_CTX* key_ctx = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr);
+        if (!key_ctx || EVP_PKEY_keygen_init(key_ctx) <= 0 ||
+            EVP_PKEY_CTX_set_ec_paramgen_curve_nid(key_ctx, NID_X9_62_prime256v1) <= 0 ||
+            EVP_PKEY_keygen(key_ctx, &key) <= 0) {
+            EVP_PKEY_CTX_free(key_ctx);
+            throw std::runtime_error("TLS key generation failed");
+        }
+        EVP_PKEY_CTX_free(key_ctx);
+
+        X509* cert = X509_new();
+        X509_set_version(cert, 2);
+        ASN1_INTEGER_set(X509_get_serialNumber(cert), static_cast<long>(std::random_device{}() & 0x7FFFFFFF));
+        X509_gmtime_adj(X509_getm_notBefore(cert), -3600);
+        X509_gmtime_adj(X509_getm_notAfter(cert), 7L * 24 * 3600);
+        X509_set_pubkey(cert, key);
+
+        X509_NAME* name = X509_get_subject_name(cert);
+        X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC,
+                                   reinterpret_cast<const unsigned char*>("chimera-mock"), -1, -1, 0);
+        X509_set_issuer_name(cert, name);
+
+        std::string alt_names = "DNS:localhost,IP:127.0.0.1";
+        if (config_.bind_address != "127.0.0.1" && config_.bind_address != "0.0.0.0") {
+            alt_names += ",IP:" + config_.bind_address;
+        }
+        X509V3_CTX ext_ctx;
+        X509V3_set_ctx_nodb(&ext_ctx);
+        X509V3_set_ctx(&ext_ctx, cert, cert, nullptr, nullptr, 0);
+        for (auto [nid, value] : {std::pair{NID_subject_alt_name, alt_names.c_str()},
+                                  std::pair{NID_basic_constraints, "critical,CA:TRUE"},
+                                  std::pair{NID_key_usage, "critical,digitalSignature,keyCertSign"}}) {
+            X509_EXTENSION* ext = X509V3_EXT_conf_nid(nullptr, &ext_ctx, nid, value);
+            if (ext) {
+                X509_add_ext(cert, ext, -1);
+                X509_EXTENSION_free(ext);
+            }
+        }
+
+        const bool signed_ok = X509_sign(cert, key, EVP_sha256()) > 0;
+        ssl_ctx_ = SSL_CTX_new(TLS_server_method());
+        const bool ready = signed_ok && ssl_ctx_ &&
+                           SSL_CTX_set_min_proto_version(ssl_ctx_, TLS1_2_VERSION) == 1 &&
+                           SSL_CTX_use_certificate(ssl_ctx_, cert) == 1 &&
+                           SSL_CTX_use_PrivateKey(ssl_ctx_, key) == 1;
+
+        if (ready) {
+            BIO* bio = BIO_new(BIO_s_mem());
+            PEM_write_bio_X509(bio, cert);
+            char* data = nullptr;
+            const long length = BIO_get_mem_data(bio, &data);
+            certificate_pem_.assign(data, static_cast<size_t>(length));
+            BIO_free(bio);
+        }
+        X509_free(cert);
+        EVP_PKEY_free(key);
+
+        if (!ready) {
+            throw std::runtime_error("TLS context setup failed");
+        }
+        if (!config_.certificate_path.empty()) {
+            std::ofstream out(config_.certificate_path);
+            out << certificate_pem_;
+            if (!out) {
+                throw std::runtime_error("Cannot write certificate to " + config_.certificate_path);
+            }
+        }
+    }
+
+    // Sockets
+
+    int bind_socket(int type, uint16_t port, bool reuse_port) {
+        const int fd = socket(AF_INET, type, 0);
+        if (fd < 0) {
+            throw socket_error("socket failed");
+        }
+        const int on = 1;
+        if (type == SOCK_STREAM) {
+            // Only for TIME_WAIT on restarts; on UDP it would let any socket share the port
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        }
+        if (reuse_port) {
+            setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on));
+        }
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        if (inet_pton(AF_INET, config_.bind_address.c_str(), &addr.sin_addr) != 1) {
+            close(fd);
+            throw std::runtime_error("Invalid bind address " + config_.bind_address);
+        }
+        if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            close(fd);
+            throw socket_error("bind to port " + std::to_string(port) + " failed");
+        }
+        return fd;
+    }
+
+    static uint16_t bound_port(int fd) {
+        sockaddr_in addr{};
+        socklen_t length = sizeof(addr);
+        getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &length);
+        return ntohs(addr.sin_port);
+    }
+
+    void close_listeners() {
+        for (int fd : udp_fds_) {
+            close(fd);
+        }
+        udp_fds_.clear();
+        for (int* fd : {&tcp_fd_, &dot_fd_, &doh_fd_}) {
+            if (*fd >= 0) {
+                close(*fd);
+                *fd = -1;
+            }
+        }
+    }
+};
+
+MockDnsServer::MockDnsServer(MockServerConfig config)
+    : impl_(std::make_unique<Impl>(std::move(config))) {}
+
+MockDnsServer::~MockDnsServer() = default;
+
+void MockDnsServer::start() {
+    impl_->start();
+}
+
+void MockDnsServer::stop() {
+    impl_->stop();
+}
+
+uint16_t MockDnsServer::port(MockTransport transport) const {
+    return impl_->port(transport);
+}
+
+MockServerStats MockDnsServer::stats() const {
+    return impl_->stats();
+}
+
+const std::string& MockDnsServer::certificate_pem() const {
+    return impl_->certificate_pem();
+}
+
+size_t MockDnsServer::extractable_answer_bytes() const {
+    return impl_->extractable_answer_bytes();
+}
+
+const char* MockDnsServer::transport_name(MockTransport transport) {
+    switch (transport) {
+        case MockTransport::UDP: return "udp";
+        case MockTransport::TCP: return "tcp";
+        case MockTransport::DoT: return "dot";
+        case MockTransport::DoH: return "doh";
+    }
+    return "unknown";
+}
+
+} // namespace chimera
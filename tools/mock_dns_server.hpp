@@ -0,0 +1,100 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "chimera/steganography.hpp"
+
+// Loopback stand-in resolver for offline end-to-end benchmarking.
+// Serves UDP, TCP, DoT and a minimal DoH endpoint (both TLS listeners share a
+// self-signed certificate generated at startup). Answers carry a configured
+// payload encoded like a real Chimera server would, so the client's receive
+// path and SteganographicExtractor run unchanged against it.
+namespace chimera {
+
+enum class MockTransport {
+    UDP,
+    TCP,
+    DoT,
+    DoH
+};
+
+struct MockServerConfig {
+    std::string bind_address = "127.0.0.1";
+
+    // Port 0 (the default) binds an ephemeral port; query it with
+    // MockDnsServer::port(). A fixed port already in use fails construction
+    bool enable_udp = true;
+    bool enable_tcp = true;
+    bool enable_dot = true;
+    bool enable_doh = true;
+    uint16_t udp_port = 0;
+    uint16_t tcp_port = 0;
+    uint16_t dot_port = 0;
+    uint16_t doh_port = 0;
+    size_t udp_threads = 0;                           // 0 = hardware concurrency
+
+    // Answers: the payload is split into A/AAAA/TXT fragment records with the
+    // given strategy; types without fragments fall back to fallback_ipv4 (A)
+    // or an empty NOERROR answer
+    std::vector<uint8_t> payload;
+    EncodingStrategy strategy = EncodingStrategy::TXT_ONLY;
+    size_t max_txt_length = 255;
+    std::string fallback_ipv4 = "192.0.2.1";
+    uint32_t ttl = 60;
+
+    // Artificial impairment; loss applies to UDP only (stream transports
+    // would only stall until the client times out)
+    std::chrono::microseconds latency{0};
+    std::chrono::microseconds jitter{0};               // Uniform +/- around latency
+    double loss_rate = 0.0;
+    uint64_t seed = 1;
+
+    std::string log_path;                              // Per-query CSV timing log
+    std::string certificate_path;                      // Write the generated PEM certificate here
+};
+
+struct MockServerStats {
+    std::array<uint64_t, 4> queries{};                 // Indexed by MockTransport
+    uint64_t answered = 0;
+    uint64_t dropped = 0;
+    uint64_t truncated = 0;
+    uint64_t malformed = 0;
+    uint64_t service_ns = 0;                           // Total time spent building responses
+};
+
+class MockDnsServer {
+public:
+    // Binds every enabled listener and creates the TLS context;
+    // throws std::runtime_error when a socket or the certificate cannot be set up
+    explicit MockDnsServer(MockServerConfig config);
+    ~MockDnsServer();
+
+    MockDnsServer(const MockDnsServer&) = delete;
+    MockDnsServer& operator=(const MockDnsServer&) = delete;
+
+    void start();
+    void stop();
+
+    // Bound port of a listener, 0 when disabled
+    uint16_t port(MockTransport transport) const;
+
+    MockServerStats stats() const;
+
+    // PEM of the self-signed certificate; pass it as a CA file to DoH clients
+    const std::string& certificate_pem() const;
+
+    // Payload bytes SteganographicExtractor recovers from the served answer set
+    size_t extractable_answer_bytes() const;
+
+    static const char* transport_name(MockTransport transport);
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace chimera
@@ -0,0 +1,204 @@
+#include "mock_dns_server.hpp"
+#include <atomic>
+#include <csignal>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <thread>
+
+namespace {
+
+std::atomic<bool> g_stop{false};
+
+void handle_signal(int) {
+    g_stop = true;
+}
+
+void print_usage(const char* program_name) {
+    std::cout << "CHIMERA mock DNS responder - loopback stand-in for load testing\n\n";
+    std::cout << "Usage: " << program_name << " [options]\n\n";
+    std::cout << "Options:\n";
+    std::cout << "  --bind <ip>            Listen address (default: 127.0.0.1)\n";
+    std::cout << "  --udp <port>           UDP port, 0 = ephemeral (default: 5353)\n";
+    std::cout << "  --tcp <port>           TCP port (default: 5353)\n";
+    std::cout << "  --dot <port>           DNS-over-TLS port (default: 8853)\n";
+    std::cout << "  --doh <port>           DNS-over-HTTPS port (default: 8443)\n";
+    std::cout << "  --no-udp, --no-tcp, --no-dot, --no-doh   Disable a listener\n";
+    std::cout << "  --threads <n>          UDP worker threads (default: hardware concurrency)\n";
+    std::cout << "  --payload <text>       Payload carried in answers\n";
+    std::cout << "  --payload-file <path>  Payload read from a file\n";
+    std::cout << "  --payload-size <n>     Random payload of n bytes\n";
+    std::cout << "  --encoding <name>      Answer encoding: txt, multi, distributed (default: txt)\n";
+    std::cout << "  --max-txt <n>          Maximum TXT length per answer (default: 255)\n";
+    std::cout << "  --a <ip>               A answer when the payload has no A fragments (default: 192.0.2.1)\n";
+    std::cout << "  --ttl <seconds>        Answer TTL (default: 60)\n";
+    std::cout << "  --latency-ms <ms>      Added response latency (default: 0)\n";
+    std::cout << "  --jitter-ms <ms>       Uniform jitter around the latency (default: 0)\n";
+    std::cout << "  --loss <0..1>          UDP response loss probability (default: 0)\n";
+    std::cout << "  --seed <n>             Seed for loss and jitter (default: 1)\n";
+    std::cout << "  --log <path>           Per-query CSV timing log\n";
+    std::cout << "  --cert-out <path>      Write the generated TLS certificate (PEM)\n";
+    std::cout << "  --duration <seconds>   Exit after this long (default: until Ctrl-C)\n";
+    std::cout << "  -h, --help             Show this help\n";
+    std::cout << "\nExample:\n";
+    std::cout << "  " << program_name << " --udp 5353 --doh 8443 --cert-out mock.pem --latency-ms 20 --loss 0.01\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    chimera::MockServerConfig config;
+    config.payload = {'C', 'H', 'I', 'M', 'E', 'R', 'A'};
+    // Fixed well-known ports for the standalone tool; the library defaults to ephemeral
+    config.udp_port = config.tcp_port = 5353;
+    config.dot_port = 8853;
+    config.doh_port = 8443;
+    int duration_s = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+
+        try {
+            if (arg == "-h" || arg == "--help") {
+                print_usage(argv[0]);
+                return 0;
+            } else if (arg == "--bind" && has_value) {
+                config.bind_address = argv[++i];
+            } else if (arg == "--udp" && has_value) {
+                config.udp_port = static_cast<uint16_t>(std::stoi(argv[++i]));
+            } else if (arg == "--tcp" && has_value) {
+                config.tcp_port = static_cast<uint16_t>(std::stoi(argv[++i]));
+            } else if (arg == "--dot" && has_value) {
+                config.dot_port = static_cast<uint16_t>(std::stoi(argv[++i]));
+            } else if (arg == "--doh" && has_value) {
+                config.doh_port = static_cast<uint16_t>(std::stoi(argv[++i]));
+            } else if (arg == "--no-udp") {
+                config.enable_udp = false;
+            } else if (arg == "--no-tcp") {
+                config.enable_tcp = false;
+            } else if (arg == "--no-dot") {
+                config.enable_dot = false;
+            } else if (arg == "--no-doh") {
+                config.enable_doh = false;
+            } else if (arg == "--threads" && has_value) {
+                config.udp_threads = std::stoul(argv[++i]);
+            } else if (arg == "--payload" && has_value) {
+                const std::string text = argv[++i];
+                config.payload.assign(text.begin(), text.end());
+            } else if (arg == "--payload-file" && has_value) {
+                std::ifstream file(argv[++i], std::ios::binary);
+                if (!file) {
+                    std::cerr << "Cannot read payload file " << argv[i] << std::endl;
+                    return 1;
+                }
+                config.payload.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            } else if (arg == "--payload-size" && has_value) {
+                std::mt19937 gen(1);
+                config.payload.resize(std::stoul(argv[++i]));
+                for (auto& byte : config.payload) {
+                    byte = static_cast<uint8_t>(gen());
+                }
+            } else if (arg == "--encoding" && has_value) {
+                const std::string encoding = argv[++i];
+                if (encoding == "txt") {
+                    config.strategy = chimera::EncodingStrategy::TXT_ONLY;
+                } else if (encoding == "multi") {
+                    config.strategy = chimera::EncodingStrategy::MULTI_RECORD;
+                } else if (encoding == "distributed") {
+                    config.strategy = chimera::EncodingStrategy::DISTRIBUTED;
+                } else {
+                    std::cerr << "Unknown encoding: " << encoding << std::endl;
+                    return 1;
+                }
+            } else if (arg == "--max-txt" && has_value) {
+                config.max_txt_length = std::stoul(argv[++i]);
+            } else if (arg == "--a" && has_value) {
+                config.fallback_ipv4 = argv[++i];
+            } else if (arg == "--ttl" && has_value) {
+                config.ttl = static_cast<uint32_t>(std::stoul(argv[++i]));
+            } else if (arg == "--latency-ms" && has_value) {
+                config.latency = std::chrono::microseconds(static_cast<int64_t>(std::stod(argv[++i]) * 1000));
+            } else if (arg == "--jitter-ms" && has_value) {
+                config.jitter = std::chrono::microseconds(static_cast<int64_t>(std::stod(argv[++i]) * 1000));
+            } else if (arg == "--loss" && has_value) {
+                config.loss_rate = std::stod(argv[++i]);
+            } else if (arg == "--seed" && has_value) {
+                config.seed = std::stoull(argv[++i]);
+            } else if (arg == "--log" && has_value) {
+                config.log_path = argv[++i];
+            } else if (arg == "--cert-out" && has_value) {
+                config.certificate_path = argv[++i];
+            } else if (arg == "--duration" && has_value) {
+                duration_s = std::stoi(argv[++i]);
+            } else {
+                std::cerr << "Unknown option: " << arg << std::endl;
+                print_usage(argv[0]);
+                return 1;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Invalid value for " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    if (config.loss_rate < 0.0 || config.loss_rate > 1.0) {
+        std::cerr << "--loss must be between 0 and 1" << std::endl;
+        return 1;
+    }
+
+    std::unique_ptr<chimera::MockDnsServer> server;
+    try {
+        server = std::make_unique<chimera::MockDnsServer>(config);
+    } catch (const std::exception& e) {
+        std::cerr << "Mock server setup failed: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::signal(SIGINT, handle_signal);
+    std::signal(SIGTERM, handle_signal);
+    server->start();
+
+    using chimera::MockTransport;
+    std::cout << "CHIMERA mock server on " << config.bind_address << std::endl;
+    for (auto transport : {MockTransport::UDP, MockTransport::TCP, MockTransport::DoT, MockTransport::DoH}) {
+        if (const uint16_t port = server->port(transport)) {
+            std::cout << "  " << chimera::MockDnsServer::transport_name(transport) << ": " << port;
+            if (transport == MockTransport::DoH) {
+                std::cout << "  (https://" << config.bind_address << ":" << port << "/dns-query)";
+            }
+            std::cout << std::endl;
+        }
+    }
+    std::cout << "  answer payload: " << config.payload.size() << " bytes, "
+              << server->extractable_answer_bytes() << " bytes extractable from the answer set" << std::endl;
+    if (!config.certificate_path.empty()) {
+        std::cout << "  certificate: " << config.certificate_path << std::endl;
+    }
+
+    const auto started = std::chrono::steady_clock::now();
+    while (!g_stop) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        if (duration_s > 0 && std::chrono::steady_clock::now() - started >= std::chrono::seconds(duration_s)) {
+            break;
+        }
+    }
+    server->stop();
+
+    const auto stats = server->stats();
+    uint64_t total = 0;
+    std::cout << "\nQueries:";
+    for (auto transport : {MockTransport::UDP, MockTransport::TCP, MockTransport::DoT, MockTransport::DoH}) {
+        const uint64_t count = stats.queries[static_cast<size_t>(transport)];
+        total += count;
+        std::cout << " " << chimera::MockDnsServer::transport_name(transport) << "=" << count;
+    }
+    std::cout << "\nAnswered: " << stats.answered << ", dropped: " << stats.dropped
+              << ", truncated: " << stats.truncated << ", malformed: " << stats.malformed << std::endl;
+    if (total > 0) {
+        std::cout << "Mean service time: " << stats.service_ns / total / 1000.0 << " us" << std::endl;
+    }
+    return 0;
+}